@@ -5,10 +5,44 @@
 *************************************************/
 
 #include <asm/mwait.h>
+#include <linux/delay.h>
+#include <linux/ktime.h>
+#include <linux/sched.h>
 
 #include "libxpcie_chain.h"
 #include "xpcie_regs_chain.h"
 
+#define XPCIE_CHAIN_STAT_READ_RETRY  3  /**< Max num of re-reading a 64bit counter when its high half changes */
+#define XPCIE_CHAIN_BATCH_POLL_MAX_US  100000   /**< Max polling time per an entry of the batch update[us] */
+#define XPCIE_CHAIN_BATCH_MAX_US       1000000  /**< Max time to request entries of a batch update[us] */
+
+
+/**
+ * @brief Function which set an entry of the soft table
+ * @details The sequence counter is odd while the entry is written,
+ *          so that readers mapping the table can detect a torn copy.
+ */
+static void
+__xpcie_fpga_set_chain_soft_table(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t fchid,
+  uint32_t kind,
+  int32_t extif_id,
+  int32_t cid)
+{
+  fpga_chain_soft_table_t *soft = dev->fch_soft;
+
+  spin_lock(&dev->fch_soft_lock);
+  WRITE_ONCE(soft->seq, soft->seq + 1);
+  smp_wmb();
+  WRITE_ONCE(soft->table[lane][fchid][kind].extif_id, extif_id);
+  WRITE_ONCE(soft->table[lane][fchid][kind].cid, cid);
+  smp_wmb();
+  WRITE_ONCE(soft->seq, soft->seq + 1);
+  spin_unlock(&dev->fch_soft_lock);
+}
+
 
 int
 xpcie_fpga_common_get_chain_module_info(
@@ -65,6 +99,66 @@ xpcie_fpga_get_chain_module_id(
 }
 
 
+/**
+ * @brief Function which request the update of Function chain table without waiting
+ * @return 0 or -EINVAL
+ */
+static int
+__xpcie_fpga_request_func_chain_update(
+  fpga_dev_info_t *dev,
+  fpga_id_t *id,
+  uint32_t kind)
+{
+  uint32_t value;
+
+  if (kind == FPGA_CID_KIND_INGRESS) {
+    if ((id->cid >= XPCIE_CID_MIN && id->cid <= XPCIE_CID_MAX)
+      && ((id->extif_id == FPGA_EXTIF_NUMBER_0) || (id->extif_id == FPGA_EXTIF_NUMBER_1))) {
+      value = (uint32_t)id->cid;
+      value |= ((uint32_t)id->extif_id & 0x00000001) << 9;
+    } else {
+      // Do Nothing
+      xpcie_err("extif_id(%u) cid(%u) is not the expected value.\n", id->extif_id, id->cid);
+      return -EINVAL;
+    }
+    // set request for function chain table update
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_REQ, id->lane, 0x0);
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_SESSION, id->lane, value);
+    value = (uint32_t)id->fchid;
+    value |= ((uint32_t)id->enable_flag & 0x00000001) << 16;
+    value |= ((uint32_t)id->active_flag & 0x00000001) << 17;
+    value |= ((uint32_t)id->direct_flag & 0x00000001) << 18;
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_CHANNEL, id->lane, value);
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_REQ, id->lane, 0x1);
+  } else if (kind == FPGA_CID_KIND_EGRESS) {
+    if ((id->cid >= XPCIE_CID_MIN && id->cid <= XPCIE_CID_MAX)
+      && ((id->extif_id == FPGA_EXTIF_NUMBER_0) || (id->extif_id == FPGA_EXTIF_NUMBER_1))) {
+      value = (uint32_t)id->cid ;
+      value |= ((uint32_t)id->extif_id & 0x00000001) << 9;
+    } else {
+      // Do Nothing
+      xpcie_err("extif_id(%u) cid(%u) is not the expected value.\n", id->extif_id, id->cid);
+      return -EINVAL;
+    }
+    // set request for function chain table update
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_REQ, id->lane, 0x0);
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_CHANNEL, id->lane, id->fchid);
+    value |= ((uint32_t)id->enable_flag   & 0x00000001) << 16;
+    value |= ((uint32_t)id->active_flag   & 0x00000001) << 17;
+    value |= ((uint32_t)id->virtual_flag  & 0x00000001) << 19;
+    value |= ((uint32_t)id->blocking_flag & 0x00000001) << 20;
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_SESSION, id->lane, value);
+    chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_REQ, id->lane, 0x1);
+  } else {
+    // Do Nothing
+    xpcie_err("kind(%u) is not the expected value.\n", kind);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+
 int
 xpcie_fpga_update_func_chain_table(
   fpga_dev_info_t *dev,
@@ -75,70 +169,26 @@ xpcie_fpga_update_func_chain_table(
     __func__, id->lane, kind, id->cid, id->fchid);
   {
     uint32_t *monitor_val;
-    uint32_t value;
     int cnt;
+    int ret;
 
-    if (kind == FPGA_CID_KIND_INGRESS) {
-      if ((id->cid >= XPCIE_CID_MIN && id->cid <= XPCIE_CID_MAX)
-        && ((id->extif_id == FPGA_EXTIF_NUMBER_0) || (id->extif_id == FPGA_EXTIF_NUMBER_1))) {
-        value = (uint32_t)id->cid;
-        value |= ((uint32_t)id->extif_id & 0x00000001) << 9;
-      } else {
-        // Do Nothing
-        xpcie_err("extif_id(%u) cid(%u) is not the expected value.\n", id->extif_id, id->cid);
-        return -EINVAL;
-      }
-      // set request for function chain table update
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_REQ, id->lane, 0x0);
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_SESSION, id->lane, value);
-      value = (uint32_t)id->fchid;
-      value |= ((uint32_t)id->enable_flag & 0x00000001) << 16;
-      value |= ((uint32_t)id->active_flag & 0x00000001) << 17;
-      value |= ((uint32_t)id->direct_flag & 0x00000001) << 18;
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_CHANNEL, id->lane, value);
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_REQ, id->lane, 0x1);
-      monitor_val = (uint32_t *)(
-        dev->base_addr
-        + dev->mods.chain.base
-        + dev->mods.chain.len * id->lane
-        + XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_RESP);
-    } else if (kind == FPGA_CID_KIND_EGRESS) {
-      if ((id->cid >= XPCIE_CID_MIN && id->cid <= XPCIE_CID_MAX)
-        && ((id->extif_id == FPGA_EXTIF_NUMBER_0) || (id->extif_id == FPGA_EXTIF_NUMBER_1))) {
-        value = (uint32_t)id->cid ;
-        value |= ((uint32_t)id->extif_id & 0x00000001) << 9;
-      } else {
-        // Do Nothing
-        xpcie_err("extif_id(%u) cid(%u) is not the expected value.\n", id->extif_id, id->cid);
-        return -EINVAL;
-      }
-      // set request for function chain table update
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_REQ, id->lane, 0x0);
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_CHANNEL, id->lane, id->fchid);
-      value |= ((uint32_t)id->enable_flag   & 0x00000001) << 16;
-      value |= ((uint32_t)id->active_flag   & 0x00000001) << 17;
-      value |= ((uint32_t)id->virtual_flag  & 0x00000001) << 19;
-      value |= ((uint32_t)id->blocking_flag & 0x00000001) << 20;
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_SESSION, id->lane, value);
-      chain_reg_write(dev, XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_REQ, id->lane, 0x1);
-      monitor_val = (uint32_t *)(
-        dev->base_addr
-        + dev->mods.chain.base
-        + dev->mods.chain.len * id->lane
-        + XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_RESP);
-    } else {
-      // Do Nothing
-      xpcie_err("kind(%u) is not the expected value.\n", kind);
-      return -EINVAL;
-    }
+    ret = __xpcie_fpga_request_func_chain_update(dev, id, kind);
+    if (ret)
+      return ret;
+    monitor_val = (uint32_t *)(
+      dev->base_addr
+      + dev->mods.chain.base
+      + dev->mods.chain.len * id->lane
+      + (kind == FPGA_CID_KIND_INGRESS
+        ? XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_RESP
+        : XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_RESP));
 
     // monitor if table was updated
     for(cnt = 0; cnt < FPGA_UPDATE_POLLING_MAX; cnt++){
       __monitor(monitor_val, 0, 0);
       smp_mb();
       if (*(volatile uint32_t *)monitor_val == 0x1) {
-        dev->fch_dev_table[id->lane][id->fchid][kind].extif_id = id->extif_id;
-        dev->fch_dev_table[id->lane][id->fchid][kind].cid = id->cid;
+        __xpcie_fpga_set_chain_soft_table(dev, id->lane, id->fchid, kind, id->extif_id, id->cid);
         return 0;
       }
       __mwait(0, 0);
@@ -150,6 +200,101 @@ xpcie_fpga_update_func_chain_table(
 }
 
 
+int
+xpcie_fpga_update_func_chain_table_batch(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  fpga_ioctl_chain_batch_entry_t *entries,
+  uint32_t num)
+{
+  xpcie_trace("%s: lane(%u), num(%u)", __func__, lane, num);
+  {
+    // Ingress and egress tables have their own request/response registers,
+    //  so one request of each kind is in flight at the same time
+    int busy[FPGA_CID_KIND_MAX];      // index of the entry in flight, -1 when idle
+    uint32_t next[FPGA_CID_KIND_MAX]; // index to search the next entry from
+    ktime_t poll_deadline[FPGA_CID_KIND_MAX]; // time to give up the entry in flight
+    ktime_t deadline = ktime_add_us(ktime_get(), XPCIE_CHAIN_BATCH_MAX_US);
+    uint32_t done = 0;
+    uint32_t index, kind;
+
+    for (kind = 0; kind < FPGA_CID_KIND_MAX; kind++) {
+      busy[kind] = -1;
+      next[kind] = 0;
+      poll_deadline[kind] = 0;
+    }
+    for (index = 0; index < num; index++) {
+      fpga_id_t *id = &entries[index].id;
+      id->lane = lane;
+      entries[index].status = 0;
+      if (entries[index].kind >= FPGA_CID_KIND_MAX
+        || id->fchid < XPCIE_FUNCTION_CHAIN_ID_MIN || id->fchid > XPCIE_FUNCTION_CHAIN_ID_MAX) {
+        xpcie_err("kind(%u) fchid(%u) is not the expected value.\n", entries[index].kind, id->fchid);
+        entries[index].status = -EINVAL;
+        done++;
+      }
+    }
+
+    while (done < num) {
+      bool in_flight = false;
+      ktime_t now = ktime_get();
+      for (kind = 0; kind < FPGA_CID_KIND_MAX; kind++) {
+        uint32_t resp = kind == FPGA_CID_KIND_INGRESS
+          ? XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_RESP
+          : XPCIE_FPGA_CHAIN_EGR_FORWARD_UPDATE_RESP;
+        if (busy[kind] >= 0) {
+          fpga_ioctl_chain_batch_entry_t *entry = &entries[busy[kind]];
+          if (chain_reg_read(dev, resp, lane) == 0x1) {
+            __xpcie_fpga_set_chain_soft_table(dev, lane, entry->id.fchid, kind,
+              entry->id.extif_id, entry->id.cid);
+          } else if (ktime_before(now, poll_deadline[kind])) {
+            in_flight = true;
+            continue;
+          } else {
+            xpcie_warn("Chain update timeout...");
+            entry->status = -XPCIE_DEV_UPDATE_TIMEOUT;
+          }
+          busy[kind] = -1;
+          done++;
+        }
+        // entries not requested in time are timed out without requesting,
+        //  so that one ioctl does not hold the caller for long
+        if (ktime_after(now, deadline)) {
+          for (; next[kind] < num; next[kind]++) {
+            fpga_ioctl_chain_batch_entry_t *entry = &entries[next[kind]];
+            if (entry->kind != kind || entry->status)
+              continue;
+            entry->status = -XPCIE_DEV_UPDATE_TIMEOUT;
+            done++;
+          }
+          continue;
+        }
+        // request the next entry of this kind
+        for (; next[kind] < num; next[kind]++) {
+          fpga_ioctl_chain_batch_entry_t *entry = &entries[next[kind]];
+          if (entry->kind != kind || entry->status)
+            continue;
+          entry->status = __xpcie_fpga_request_func_chain_update(dev, &entry->id, kind);
+          if (entry->status) {
+            done++;
+            continue;
+          }
+          busy[kind] = next[kind]++;
+          poll_deadline[kind] = ktime_add_us(ktime_get(), XPCIE_CHAIN_BATCH_POLL_MAX_US);
+          in_flight = true;
+          break;
+        }
+      }
+      if (in_flight)
+        udelay(1);
+      cond_resched();
+    }
+
+    return 0;
+  }
+}
+
+
 int
 xpcie_fpga_delete_func_chain_table(
   fpga_dev_info_t *dev,
@@ -161,8 +306,8 @@ xpcie_fpga_delete_func_chain_table(
   uint32_t *monitor_val;
   int cnt;
 
-  if((dev->fch_dev_table[id->lane][id->fchid][kind].cid == -1)
-    || (dev->fch_dev_table[id->lane][id->fchid][kind].extif_id == -1)){
+  if((dev->fch_soft->table[id->lane][id->fchid][kind].cid == -1)
+    || (dev->fch_soft->table[id->lane][id->fchid][kind].extif_id == -1)){
     xpcie_warn("No chain found...");
     return -XPCIE_DEV_NO_CHAIN_FOUND;
   }
@@ -170,8 +315,8 @@ xpcie_fpga_delete_func_chain_table(
   if (kind == FPGA_CID_KIND_INGRESS) {
     uint32_t value;
     // set request for function chain table delete
-    value = (uint32_t)dev->fch_dev_table[id->lane][id->fchid][kind].cid;
-    value |= ((uint32_t)dev->fch_dev_table[id->lane][id->fchid][kind].extif_id & 0x00000001) << 9;
+    value = (uint32_t)dev->fch_soft->table[id->lane][id->fchid][kind].cid;
+    value |= ((uint32_t)dev->fch_soft->table[id->lane][id->fchid][kind].extif_id & 0x00000001) << 9;
     chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_REQ, id->lane, 0x0);
     chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_SESSION, id->lane, value);
     chain_reg_write(dev, XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_REQ, id->lane, 0x2);
@@ -201,11 +346,10 @@ xpcie_fpga_delete_func_chain_table(
     __monitor(monitor_val, 0, 0);
     smp_mb();
     if (*(volatile uint32_t *)monitor_val == 0x1) {
-      id->extif_id = (uint32_t)dev->fch_dev_table[id->lane][id->fchid][kind].extif_id;
-      id->cid = (uint16_t)dev->fch_dev_table[id->lane][id->fchid][kind].cid;
+      id->extif_id = (uint32_t)dev->fch_soft->table[id->lane][id->fchid][kind].extif_id;
+      id->cid = (uint16_t)dev->fch_soft->table[id->lane][id->fchid][kind].cid;
       xpcie_trace("%s: delete extif_id(%d) cid(%d)", __func__, id->extif_id, id->cid);
-      dev->fch_dev_table[id->lane][id->fchid][kind].extif_id = -1;
-      dev->fch_dev_table[id->lane][id->fchid][kind].cid = -1;
+      __xpcie_fpga_set_chain_soft_table(dev, id->lane, id->fchid, kind, -1, -1);
       return 0;
     }
     __mwait(0, 0);
@@ -240,8 +384,8 @@ xpcie_fpga_read_func_chain_table(
         uint16_t fchid_ = j;
         for (k=0; k<FPGA_CID_KIND_MAX; k++) { // 0:ig 1:eg
           uint32_t kind_ = k;
-          if((dev->fch_dev_table[lane_][fchid_][kind_].cid == id->cid)
-            && (dev->fch_dev_table[lane_][fchid_][kind_].extif_id == id->extif_id)){
+          if((dev->fch_soft->table[lane_][fchid_][kind_].cid == id->cid)
+            && (dev->fch_soft->table[lane_][fchid_][kind_].extif_id == id->extif_id)){
             xpcie_trace("%s: extif_id(%d), cid(%d) ", __func__, id->extif_id, id->cid);
             flag = true;
           }
@@ -265,8 +409,8 @@ xpcie_fpga_read_func_chain_table(
       + XPCIE_FPGA_CHAIN_INGR_FORWARD_UPDATE_RESP);
     read_addr = XPCIE_FPGA_CHAIN_INGR_FORWARD_CHANNEL;
   } else if (kind == FPGA_CID_KIND_EGRESS) {
-    if((dev->fch_dev_table[id->lane][id->fchid][kind].cid == -1)
-      || (dev->fch_dev_table[id->lane][id->fchid][kind].extif_id == -1)){
+    if((dev->fch_soft->table[id->lane][id->fchid][kind].cid == -1)
+      || (dev->fch_soft->table[id->lane][id->fchid][kind].extif_id == -1)){
       xpcie_warn("Egress No chain found...");
       return -XPCIE_DEV_NO_CHAIN_FOUND;
     }
@@ -330,10 +474,10 @@ xpcie_fpga_read_chain_soft_table(
 )
 {
   xpcie_trace("%s: lane(%u), fchid(%u)", __func__, lane, fchid);
-  *ingress_extif_id = dev->fch_dev_table[lane][fchid][FPGA_CID_KIND_INGRESS].extif_id;
-  *ingress_cid      = dev->fch_dev_table[lane][fchid][FPGA_CID_KIND_INGRESS].cid;
-  *egress_extif_id  = dev->fch_dev_table[lane][fchid][FPGA_CID_KIND_EGRESS].extif_id;
-  *egress_cid       = dev->fch_dev_table[lane][fchid][FPGA_CID_KIND_EGRESS].cid;
+  *ingress_extif_id = dev->fch_soft->table[lane][fchid][FPGA_CID_KIND_INGRESS].extif_id;
+  *ingress_cid      = dev->fch_soft->table[lane][fchid][FPGA_CID_KIND_INGRESS].cid;
+  *egress_extif_id  = dev->fch_soft->table[lane][fchid][FPGA_CID_KIND_EGRESS].extif_id;
+  *egress_cid       = dev->fch_soft->table[lane][fchid][FPGA_CID_KIND_EGRESS].cid;
 }
 
 
@@ -343,7 +487,13 @@ xpcie_fpga_reset_chain_soft_table(
 )
 {
   xpcie_trace("%s: ", __func__);
-  memset(dev->fch_dev_table, 0xFF, sizeof(dev->fch_dev_table));
+  spin_lock(&dev->fch_soft_lock);
+  WRITE_ONCE(dev->fch_soft->seq, dev->fch_soft->seq + 1);
+  smp_wmb();
+  memset(dev->fch_soft->table, 0xFF, sizeof(dev->fch_soft->table));
+  smp_wmb();
+  WRITE_ONCE(dev->fch_soft->seq, dev->fch_soft->seq + 1);
+  spin_unlock(&dev->fch_soft_lock);
 }
 
 
@@ -491,36 +641,125 @@ xpcie_fpga_get_ddr_offset_frame(
 }
 
 
+/**
+ * @brief Function which select cid/fchid and read a register as one critical section
+ */
+static uint32_t
+xpcie_fpga_chain_select_read(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t sel_addr,
+  uint32_t sel_value,
+  uint32_t addr)
+{
+  uint32_t value;
+
+  chain_reg_lock(dev, lane);
+  chain_reg_write_locked(dev, sel_addr, lane, sel_value);
+  value = chain_reg_read_locked(dev, addr, lane);
+  chain_reg_unlock(dev, lane);
+
+#ifdef XPCIE_REGISTER_LOG
+  xpcie_info("sel_read: dev_id: %02d, lane: %u, select(0x%08x): %u, offset: 0x%08x, value: 0x%08x",
+    dev->dev_id, lane, sel_addr, sel_value, addr, value);
+#endif
+
+  return value;
+}
+
+
+/**
+ * @brief Function which read a 64bit counter while chain_reg_lock() is held by caller
+ * @details The low half is read again when the high half changes during the read,
+ *          so that the value does not tear at the carry.
+ */
+static uint64_t
+xpcie_fpga_chain_read64_locked(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t addr_l,
+  uint32_t addr_h)
+{
+  uint32_t value_l, value_h, value_h_prev;
+  int retry;
+
+  value_h = chain_reg_read_locked(dev, addr_h, lane);
+  for (retry = 0; retry < XPCIE_CHAIN_STAT_READ_RETRY; retry++) {
+    value_h_prev = value_h;
+    value_l = chain_reg_read_locked(dev, addr_l, lane);
+    value_h = chain_reg_read_locked(dev, addr_h, lane);
+    if (value_h == value_h_prev)
+      break;
+  }
+
+  return ((uint64_t)value_h << 32) | (uint64_t)value_l;
+}
+
+
+/**
+ * @brief Function which select cid/fchid and read a 64bit counter as one critical section
+ */
+static uint64_t
+xpcie_fpga_chain_select_read64(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t sel_addr,
+  uint32_t sel_value,
+  uint32_t addr_l,
+  uint32_t addr_h)
+{
+  uint64_t value;
+
+  chain_reg_lock(dev, lane);
+  chain_reg_write_locked(dev, sel_addr, lane, sel_value);
+  value = xpcie_fpga_chain_read64_locked(dev, lane, addr_l, addr_h);
+  chain_reg_unlock(dev, lane);
+
+#ifdef XPCIE_REGISTER_LOG
+  xpcie_info("sel_read: dev_id: %02d, lane: %u, select(0x%08x): %u, offset: 0x%08x, value: 0x%016llx",
+    dev->dev_id, lane, sel_addr, sel_value, addr_l, value);
+#endif
+
+  return value;
+}
+
+
 void
 xpcie_fpga_get_latency_chain(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_latency_t *latency)
 {
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, latency->lane, latency->cid);
+  uint32_t addr;
 
   if (latency->dir == FPGA_CID_KIND_INGRESS) {
     if (latency->extif_id == FPGA_EXTIF_NUMBER_0) {
-      latency->latency = chain_reg_read(dev, XPCIE_FPGA_CHAIN_INGR_LATENCY_0_VALUE, latency->lane);
+      addr = XPCIE_FPGA_CHAIN_INGR_LATENCY_0_VALUE;
     } else if (latency->extif_id == FPGA_EXTIF_NUMBER_1) {
-      latency->latency = chain_reg_read(dev, XPCIE_FPGA_CHAIN_INGR_LATENCY_1_VALUE, latency->lane);
+      addr = XPCIE_FPGA_CHAIN_INGR_LATENCY_1_VALUE;
     } else {
       /* Do Nothing */
       xpcie_err("extif_id(%u) is not the expected value.\n", latency->extif_id);
+      return;
     }
   }
   else if (latency->dir == FPGA_CID_KIND_EGRESS) {
     if (latency->extif_id == FPGA_EXTIF_NUMBER_0) {
-      latency->latency = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EGR_LATENCY_0_VALUE, latency->lane);
+      addr = XPCIE_FPGA_CHAIN_EGR_LATENCY_0_VALUE;
     } else if (latency->extif_id == FPGA_EXTIF_NUMBER_1) {
-      latency->latency = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EGR_LATENCY_1_VALUE, latency->lane);
+      addr = XPCIE_FPGA_CHAIN_EGR_LATENCY_1_VALUE;
     } else {
       /* Do Nothing */
       xpcie_err("extif_id(%u) is not the expected value.\n", latency->extif_id);
+      return;
     }
   } else {
     /* Do Nothing */
     xpcie_err("dir(%u) is not the expected value.\n", latency->dir);
+    return;
   }
+
+  latency->latency = xpcie_fpga_chain_select_read(dev, latency->lane,
+    XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, latency->cid, addr);
 }
 
 
@@ -529,9 +768,8 @@ xpcie_fpga_get_latency_func(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_func_latency_t *latency)
 {
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, latency->lane, latency->fchid);
-
-  latency->latency = chain_reg_read(dev, XPCIE_FPGA_CHAIN_FUNC_LATENCY_VALUE, latency->lane);
+  latency->latency = xpcie_fpga_chain_select_read(dev, latency->lane,
+    XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, latency->fchid, XPCIE_FPGA_CHAIN_FUNC_LATENCY_VALUE);
 }
 
 
@@ -540,8 +778,7 @@ xpcie_fpga_get_chain_bytes(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_bytenum_t *bytenum)
 {
-  uint32_t value_l, value_h;
-  uint64_t addr_w, addr_l, addr_h;
+  uint32_t addr_w, addr_l, addr_h;
 
   switch(bytenum->reg_id) {
     case CHAIN_STAT_INGR_RCV0:
@@ -634,11 +871,8 @@ xpcie_fpga_get_chain_bytes(
       return;
   }
 
-  chain_reg_write(dev, addr_w, bytenum->lane, bytenum->cid_fchid);
-  value_l = chain_reg_read(dev, addr_l, bytenum->lane);
-  value_h = chain_reg_read(dev, addr_h, bytenum->lane);
-  bytenum->byte_num =  (uint64_t)value_l;
-  bytenum->byte_num |= ((uint64_t)value_h & 0xFFFFFFFF) << 32;
+  bytenum->byte_num = xpcie_fpga_chain_select_read64(dev, bytenum->lane,
+    addr_w, bytenum->cid_fchid, addr_l, addr_h);
 }
 
 
@@ -647,7 +881,7 @@ xpcie_fpga_get_chain_frames(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_framenum_t *framenum)
 {
-  uint64_t addr;
+  uint32_t addr;
 
   switch(framenum->reg_id) {
     case CHAIN_STAT_INGR_SND0:
@@ -676,8 +910,8 @@ xpcie_fpga_get_chain_frames(
       return;
   }
 
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->lane, framenum->fchid);
-  framenum->frame_num = chain_reg_read(dev, addr, framenum->lane);
+  framenum->frame_num = xpcie_fpga_chain_select_read(dev, framenum->lane,
+    XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->fchid, addr);
 }
 
 
@@ -686,8 +920,8 @@ xpcie_fpga_get_chain_buff(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_framenum_t *framenum)
 {
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->lane, framenum->fchid);
-  framenum->frame_num = chain_reg_read(dev, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_STORED, framenum->lane);
+  framenum->frame_num = xpcie_fpga_chain_select_read(dev, framenum->lane,
+    XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->fchid, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_STORED);
 }
 
 
@@ -696,8 +930,8 @@ xpcie_fpga_get_chain_bp(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_framenum_t *framenum)
 {
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->lane, framenum->fchid);
-  framenum->frame_num = chain_reg_read(dev, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_BP, framenum->lane);
+  framenum->frame_num = xpcie_fpga_chain_select_read(dev, framenum->lane,
+    XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->fchid, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_BP);
 }
 
 
@@ -706,8 +940,10 @@ xpcie_fpga_clear_chain_bp(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_framenum_t *framenum)
 {
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->lane, framenum->fchid);
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_BP, framenum->lane, framenum->frame_num);
+  chain_reg_lock(dev, framenum->lane);
+  chain_reg_write_locked(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, framenum->lane, framenum->fchid);
+  chain_reg_write_locked(dev, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_BP, framenum->lane, framenum->frame_num);
+  chain_reg_unlock(dev, framenum->lane);
 }
 
 
@@ -716,8 +952,66 @@ xpcie_fpga_get_chain_busy(
   fpga_dev_info_t *dev,
   fpga_ioctl_chain_framenum_t *busy)
 {
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, busy->lane, busy->fchid);
-  busy->frame_num = chain_reg_read(dev, XPCIE_FPGA_CHAIN_STAT_EGR_BUSY, busy->lane);
+  busy->frame_num = xpcie_fpga_chain_select_read(dev, busy->lane,
+    XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, busy->fchid, XPCIE_FPGA_CHAIN_STAT_EGR_BUSY);
+}
+
+
+void
+xpcie_fpga_get_chain_stat_cid(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t cid,
+  fpga_chain_stat_cid_t *stat)
+{
+  chain_reg_lock(dev, lane);
+  chain_reg_write_locked(dev, XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, lane, cid);
+  stat->ingr_rcv_bytes[0] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_INGR_RCV_DATA_0_VALUE_L, XPCIE_FPGA_CHAIN_STAT_INGR_RCV_DATA_0_VALUE_H);
+  stat->ingr_rcv_bytes[1] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_INGR_RCV_DATA_1_VALUE_L, XPCIE_FPGA_CHAIN_STAT_INGR_RCV_DATA_1_VALUE_H);
+  stat->egr_snd_bytes[0] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_EGR_SND_DATA_0_VALUE_L, XPCIE_FPGA_CHAIN_STAT_EGR_SND_DATA_0_VALUE_H);
+  stat->egr_snd_bytes[1] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_EGR_SND_DATA_1_VALUE_L, XPCIE_FPGA_CHAIN_STAT_EGR_SND_DATA_1_VALUE_H);
+  chain_reg_unlock(dev, lane);
+}
+
+
+void
+xpcie_fpga_get_chain_stat_fchid(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t fchid,
+  fpga_chain_stat_fchid_t *stat)
+{
+  chain_reg_lock(dev, lane);
+  chain_reg_write_locked(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, lane, fchid);
+  stat->ingr_snd_bytes[0] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_INGR_SND_DATA_0_VALUE_L, XPCIE_FPGA_CHAIN_STAT_INGR_SND_DATA_0_VALUE_H);
+  stat->ingr_snd_bytes[1] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_INGR_SND_DATA_1_VALUE_L, XPCIE_FPGA_CHAIN_STAT_INGR_SND_DATA_1_VALUE_H);
+  stat->egr_rcv_bytes[0] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_EGR_RCV_DATA_0_VALUE_L, XPCIE_FPGA_CHAIN_STAT_EGR_RCV_DATA_0_VALUE_H);
+  stat->egr_rcv_bytes[1] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_EGR_RCV_DATA_1_VALUE_L, XPCIE_FPGA_CHAIN_STAT_EGR_RCV_DATA_1_VALUE_H);
+  stat->ingr_discard_bytes[0] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_INGR_DISCARD_DATA_0_VALUE_L, XPCIE_FPGA_CHAIN_STAT_INGR_DISCARD_DATA_0_VALUE_H);
+  stat->ingr_discard_bytes[1] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_INGR_DISCARD_DATA_1_VALUE_L, XPCIE_FPGA_CHAIN_STAT_INGR_DISCARD_DATA_1_VALUE_H);
+  stat->egr_discard_bytes[0] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_EGR_DISCARD_DATA_0_VALUE_L, XPCIE_FPGA_CHAIN_STAT_EGR_DISCARD_DATA_0_VALUE_H);
+  stat->egr_discard_bytes[1] = xpcie_fpga_chain_read64_locked(dev, lane,
+    XPCIE_FPGA_CHAIN_STAT_EGR_DISCARD_DATA_1_VALUE_L, XPCIE_FPGA_CHAIN_STAT_EGR_DISCARD_DATA_1_VALUE_H);
+  stat->ingr_snd_frames[0] = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_INGR_SND_FRAME_0_VALUE, lane);
+  stat->ingr_snd_frames[1] = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_INGR_SND_FRAME_1_VALUE, lane);
+  stat->egr_rcv_frames[0] = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_EGR_RCV_FRAME_0_VALUE, lane);
+  stat->egr_rcv_frames[1] = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_EGR_RCV_FRAME_1_VALUE, lane);
+  stat->buff_stored = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_STORED, lane);
+  stat->buff_bp = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_HEADER_BUFF_BP, lane);
+  stat->egr_busy = chain_reg_read_locked(dev, XPCIE_FPGA_CHAIN_STAT_EGR_BUSY, lane);
+  stat->reserved = 0;
+  chain_reg_unlock(dev, lane);
 }
 
 
@@ -738,24 +1032,24 @@ xpcie_fpga_detect_chain_err(
   uint32_t value;
 
   if (chain_err->dir == FPGA_CID_KIND_INGRESS) {
-    chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->lane, chain_err->cid_fchid);
-
     if (chain_err->extif_id == FPGA_EXTIF_NUMBER_0) {
-      value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_INGR_RCV_DETECT_FAULT_0_VALUE, chain_err->lane);
+      value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+        XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_INGR_RCV_DETECT_FAULT_0_VALUE);
     } else if (chain_err->extif_id == FPGA_EXTIF_NUMBER_1) {
-      value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_INGR_RCV_DETECT_FAULT_1_VALUE, chain_err->lane);
+      value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+        XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_INGR_RCV_DETECT_FAULT_1_VALUE);
     } else {
       /* Do Nothing */
       xpcie_err("extif_id(%u) is not the expected value.\n", chain_err->extif_id);
     }
   }
   else if (chain_err->dir == FPGA_CID_KIND_EGRESS) {
-    chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->lane, chain_err->cid_fchid);
-
     if (chain_err->extif_id == FPGA_EXTIF_NUMBER_0) {
-      value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EGR_SND_DETECT_FAULT_0_VALUE, chain_err->lane);
+      value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+        XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_EGR_SND_DETECT_FAULT_0_VALUE);
     } else if (chain_err->extif_id == FPGA_EXTIF_NUMBER_1) {
-      value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EGR_SND_DETECT_FAULT_1_VALUE, chain_err->lane);
+      value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+        XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_EGR_SND_DETECT_FAULT_1_VALUE);
     } else {
       /* Do Nothing */
       xpcie_err("extif_id(%u) is not the expected value.\n", chain_err->extif_id);
@@ -956,21 +1250,20 @@ xpcie_fpga_detect_chain_err_table(
   uint32_t value;
 
   if (chain_err->dir == FPGA_CID_KIND_INGRESS) {
-    chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->lane, chain_err->cid_fchid);
-
     if (chain_err->extif_id == FPGA_EXTIF_NUMBER_0) {
-      value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_INGR_SND_DETECT_FAULT_0_VALUE, chain_err->lane);
+      value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+        XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_INGR_SND_DETECT_FAULT_0_VALUE);
     } else if (chain_err->extif_id == FPGA_EXTIF_NUMBER_1) {
-      value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_INGR_SND_DETECT_FAULT_1_VALUE, chain_err->lane);
+      value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+        XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_INGR_SND_DETECT_FAULT_1_VALUE);
     } else {
       /* Do Nothing */
       xpcie_err("extif_id(%u) is not the expected value.\n", chain_err->extif_id);
     }
   }
   else if (chain_err->dir == FPGA_CID_KIND_EGRESS) {
-    chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, chain_err->lane, chain_err->cid_fchid);
-
-    value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EGR_RCV_DETECT_FAULT_VALUE, chain_err->lane);
+    value = xpcie_fpga_chain_select_read(dev, chain_err->lane,
+      XPCIE_FPGA_CHAIN_STAT_SEL_CHANNEL, chain_err->cid_fchid, XPCIE_FPGA_CHAIN_EGR_RCV_DETECT_FAULT_VALUE);
   } else {
     /* Do Nothing */
     xpcie_err("dir(%u) is not the expected value.\n", chain_err->dir);
@@ -1777,11 +2070,12 @@ xpcie_fpga_get_chain_con_status(
   uint32_t rd_value;
 
   wr_value = (status->cid  & 0x000001FF);
-  chain_reg_write(dev, XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, status->lane, wr_value);
   if (status->extif_id == FPGA_EXTIF_NUMBER_0) {
-    rd_value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EXTIF0_SESSION_STATUS, status->lane);
+    rd_value = xpcie_fpga_chain_select_read(dev, status->lane,
+      XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, wr_value, XPCIE_FPGA_CHAIN_EXTIF0_SESSION_STATUS);
   } else if (status->extif_id == FPGA_EXTIF_NUMBER_1) {
-    rd_value = chain_reg_read(dev, XPCIE_FPGA_CHAIN_EXTIF1_SESSION_STATUS, status->lane);
+    rd_value = xpcie_fpga_chain_select_read(dev, status->lane,
+      XPCIE_FPGA_CHAIN_STAT_SEL_SESSION, wr_value, XPCIE_FPGA_CHAIN_EXTIF1_SESSION_STATUS);
   } else {
     xpcie_err("extif_id(%u) is not the expected value.\n", status->extif_id);
   }
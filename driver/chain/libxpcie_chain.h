@@ -36,6 +36,17 @@ int xpcie_fpga_update_func_chain_table(
         fpga_id_t *id,
         uint32_t kind);
 
+/**
+ * @brief Chain: Function which update Function chain table by many entries of a lane
+ * @details Entries of the same kind are applied in order, ingress and egress are
+ *  applied in parallel. The result of each entry is stored in its `status`.
+ */
+int xpcie_fpga_update_func_chain_table_batch(
+        fpga_dev_info_t *dev,
+        uint32_t lane,
+        fpga_ioctl_chain_batch_entry_t *entries,
+        uint32_t num);
+
 /**
  * @brief Chain: Function which delete Function chain table
  */
@@ -154,6 +165,24 @@ void xpcie_fpga_get_chain_busy(
         fpga_dev_info_t *dev,
         fpga_ioctl_chain_framenum_t *busy);
 
+/**
+ * @brief Chain: Function which get all counters of a cid as one critical section
+ */
+void xpcie_fpga_get_chain_stat_cid(
+        fpga_dev_info_t *dev,
+        uint32_t lane,
+        uint32_t cid,
+        fpga_chain_stat_cid_t *stat);
+
+/**
+ * @brief Chain: Function which get all counters of a fchid as one critical section
+ */
+void xpcie_fpga_get_chain_stat_fchid(
+        fpga_dev_info_t *dev,
+        uint32_t lane,
+        uint32_t fchid,
+        fpga_chain_stat_fchid_t *stat);
+
 /**
  * @brief Chain
  */
@@ -4,6 +4,9 @@
 * SPDX-License-Identifier: GPL-2.0-or-later
 *************************************************/
 
+#include <linux/mm.h>
+#include <linux/sched.h>
+
 #include "libxpcie_chain.h"
 
 
@@ -36,6 +39,38 @@ xpcie_fpga_ioctl_chain(struct file *filp, unsigned int cmd, unsigned long arg)
       ret = xpcie_fpga_update_func_chain_table(dev, &id, FPGA_CID_KIND_EGRESS);
     }
     break;
+  case XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH:
+    {
+      fpga_ioctl_chain_batch_t batch;
+      fpga_ioctl_chain_batch_entry_t *entries;
+      if (copy_from_user(&batch, (void __user *)arg, sizeof(fpga_ioctl_chain_batch_t))) {
+        ret = -EFAULT;
+        break;
+      }
+      if (batch.lane >= dev->mods.chain.num || batch.num == 0
+        || batch.num > XPCIE_DEV_CHAIN_BATCH_MAX) {
+        ret = -EINVAL;
+        break;
+      }
+      entries = kvmalloc_array(batch.num, sizeof(fpga_ioctl_chain_batch_entry_t), GFP_KERNEL);
+      if (!entries) {
+        ret = -ENOMEM;
+        break;
+      }
+      if (copy_from_user(entries, (void __user *)(uintptr_t)batch.entries,
+          sizeof(fpga_ioctl_chain_batch_entry_t) * batch.num)) {
+        kvfree(entries);
+        ret = -EFAULT;
+        break;
+      }
+      ret = xpcie_fpga_update_func_chain_table_batch(dev, batch.lane, entries, batch.num);
+      if (copy_to_user((void __user *)(uintptr_t)batch.entries,
+          entries, sizeof(fpga_ioctl_chain_batch_entry_t) * batch.num)) {
+        ret = -EFAULT;
+      }
+      kvfree(entries);
+    }
+    break;
   case XPCIE_DEV_CHAIN_DELETE_TABLE_INGR:
     {
       fpga_id_t id;
@@ -268,6 +303,57 @@ xpcie_fpga_ioctl_chain(struct file *filp, unsigned int cmd, unsigned long arg)
       }
     }
     break;
+  case XPCIE_DEV_CHAIN_GET_STAT_ALL:
+    {
+      fpga_ioctl_chain_stat_all_t stat_all;
+      fpga_chain_stat_cid_t *cid_stats = NULL;
+      fpga_chain_stat_fchid_t *fchid_stats = NULL;
+      uint32_t index;
+      if (copy_from_user(&stat_all, (void __user *)arg, sizeof(fpga_ioctl_chain_stat_all_t))) {
+        ret = -EFAULT;
+        break;
+      }
+      if (stat_all.lane < 0 || (uint32_t)stat_all.lane >= dev->mods.chain.num
+        || stat_all.cid_num > XPCIE_CID_MAX - XPCIE_CID_MIN + 1
+        || stat_all.fchid_num > XPCIE_FUNCTION_CHAIN_MAX) {
+        ret = -EINVAL;
+        break;
+      }
+      if (stat_all.cid_num) {
+        cid_stats = kvmalloc_array(stat_all.cid_num, sizeof(fpga_chain_stat_cid_t), GFP_KERNEL);
+        if (!cid_stats) {
+          ret = -ENOMEM;
+          break;
+        }
+      }
+      if (stat_all.fchid_num) {
+        fchid_stats = kvmalloc_array(stat_all.fchid_num, sizeof(fpga_chain_stat_fchid_t), GFP_KERNEL);
+        if (!fchid_stats) {
+          kvfree(cid_stats);
+          ret = -ENOMEM;
+          break;
+        }
+      }
+      // Each cid/fchid is selected and read under the lane's lock,
+      //  the lock is released between them not to block other accesses for long
+      for (index = 0; index < stat_all.cid_num; index++) {
+        xpcie_fpga_get_chain_stat_cid(dev, stat_all.lane, XPCIE_CID_MIN + index, &cid_stats[index]);
+        cond_resched();
+      }
+      for (index = 0; index < stat_all.fchid_num; index++) {
+        xpcie_fpga_get_chain_stat_fchid(dev, stat_all.lane, XPCIE_FUNCTION_CHAIN_ID_MIN + index, &fchid_stats[index]);
+        cond_resched();
+      }
+      if ((stat_all.cid_num && copy_to_user((void __user *)(uintptr_t)stat_all.cid_stats,
+          cid_stats, sizeof(fpga_chain_stat_cid_t) * stat_all.cid_num))
+        || (stat_all.fchid_num && copy_to_user((void __user *)(uintptr_t)stat_all.fchid_stats,
+          fchid_stats, sizeof(fpga_chain_stat_fchid_t) * stat_all.fchid_num))) {
+        ret = -EFAULT;
+      }
+      kvfree(cid_stats);
+      kvfree(fchid_stats);
+    }
+    break;
   /* *** Chain err *** */
   case XPCIE_DEV_CHAIN_GET_CHK_ERR:
     {
@@ -753,6 +839,45 @@ xpcie_fpga_ioctl_chain(struct file *filp, unsigned int cmd, unsigned long arg)
     }
     break;
 
+  case XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL:
+    {
+      fpga_ioctl_chain_soft_table_t ioctl_arg;
+      fpga_ioctl_chain_ids_t *ids;
+      uint32_t index;
+      if (copy_from_user(&ioctl_arg, (void __user *)arg, sizeof(ioctl_arg))) {
+        ret = -EFAULT;
+        break;
+      }
+      if (ioctl_arg.lane >= dev->mods.chain.num || ioctl_arg.num == 0
+        || ioctl_arg.num > XPCIE_FUNCTION_CHAIN_MAX) {
+        ret = -EINVAL;
+        break;
+      }
+      ids = kvmalloc_array(ioctl_arg.num, sizeof(fpga_ioctl_chain_ids_t), GFP_KERNEL);
+      if (!ids) {
+        ret = -ENOMEM;
+        break;
+      }
+      for (index = 0; index < ioctl_arg.num; index++) {
+        ids[index].lane = ioctl_arg.lane;
+        ids[index].fchid = XPCIE_FUNCTION_CHAIN_ID_MIN + index;
+        xpcie_fpga_read_chain_soft_table(
+          dev,
+          ioctl_arg.lane,
+          ids[index].fchid,
+          &ids[index].ingress_extif_id,
+          &ids[index].ingress_cid,
+          &ids[index].egress_extif_id,
+          &ids[index].egress_cid);
+      }
+      if (copy_to_user((void __user *)(uintptr_t)ioctl_arg.ids,
+          ids, sizeof(fpga_ioctl_chain_ids_t) * ioctl_arg.num)) {
+        ret = -EFAULT;
+      }
+      kvfree(ids);
+    }
+    break;
+
   case XPCIE_DEV_CHAIN_RESET_SOFT_TABLE:
     xpcie_fpga_reset_chain_soft_table(dev);
     break;
@@ -7,6 +7,8 @@
 #include "libxpcie_direct.h"
 #include "xpcie_regs_direct.h"
 
+#define XPCIE_DIRECT_STAT_READ_RETRY  3  /**< Max num of re-reading a 64bit counter when its high half changes */
+
 
 int
 xpcie_fpga_common_get_direct_module_info(
@@ -169,6 +171,59 @@ xpcie_fpga_get_direct_frames(
 }
 
 
+/**
+ * @brief Function which read a 64bit counter as H, L, H while direct_reg_lock() is held
+ * @details When the high half changes, the low half wrapped around between reads,
+ *          so the pair is read again.
+ */
+static uint64_t
+xpcie_fpga_direct_read64_locked(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t addr_l,
+  uint32_t addr_h)
+{
+  uint32_t value_l, value_h, value_h_prev;
+  int retry;
+
+  value_h = direct_reg_read_locked(dev, addr_h, lane);
+  for (retry = 0; retry < XPCIE_DIRECT_STAT_READ_RETRY; retry++) {
+    value_h_prev = value_h;
+    value_l = direct_reg_read_locked(dev, addr_l, lane);
+    value_h = direct_reg_read_locked(dev, addr_h, lane);
+    if (value_h == value_h_prev)
+      break;
+  }
+
+  return ((uint64_t)value_h << 32) | (uint64_t)value_l;
+}
+
+
+void
+xpcie_fpga_get_direct_stat_fchid(
+  fpga_dev_info_t *dev,
+  uint32_t lane,
+  uint32_t fchid,
+  fpga_direct_stat_fchid_t *stat)
+{
+  direct_reg_lock(dev, lane);
+  direct_reg_write_locked(dev, XPCIE_FPGA_DIRECT_STAT_SEL_CHANNEL, lane, fchid);
+  stat->bytes[DIRECT_STAT_INGR_RCV] = xpcie_fpga_direct_read64_locked(dev, lane,
+    XPCIE_FPGA_DIRECT_STAT_INGR_RCV_DATA_VALUE_L, XPCIE_FPGA_DIRECT_STAT_INGR_RCV_DATA_VALUE_H);
+  stat->bytes[DIRECT_STAT_INGR_SND] = xpcie_fpga_direct_read64_locked(dev, lane,
+    XPCIE_FPGA_DIRECT_STAT_INGR_SND_DATA_VALUE_L, XPCIE_FPGA_DIRECT_STAT_INGR_SND_DATA_VALUE_H);
+  stat->bytes[DIRECT_STAT_EGR_RCV] = xpcie_fpga_direct_read64_locked(dev, lane,
+    XPCIE_FPGA_DIRECT_STAT_EGR_RCV_DATA_VALUE_L, XPCIE_FPGA_DIRECT_STAT_EGR_RCV_DATA_VALUE_H);
+  stat->bytes[DIRECT_STAT_EGR_SND] = xpcie_fpga_direct_read64_locked(dev, lane,
+    XPCIE_FPGA_DIRECT_STAT_EGR_SND_DATA_VALUE_L, XPCIE_FPGA_DIRECT_STAT_EGR_SND_DATA_VALUE_H);
+  stat->frames[DIRECT_STAT_INGR_RCV] = direct_reg_read_locked(dev, XPCIE_FPGA_DIRECT_STAT_INGR_RCV_FRAME_VALUE, lane);
+  stat->frames[DIRECT_STAT_INGR_SND] = direct_reg_read_locked(dev, XPCIE_FPGA_DIRECT_STAT_INGR_SND_FRAME_VALUE, lane);
+  stat->frames[DIRECT_STAT_EGR_RCV] = direct_reg_read_locked(dev, XPCIE_FPGA_DIRECT_STAT_EGR_RCV_FRAME_VALUE, lane);
+  stat->frames[DIRECT_STAT_EGR_SND] = direct_reg_read_locked(dev, XPCIE_FPGA_DIRECT_STAT_EGR_SND_FRAME_VALUE, lane);
+  direct_reg_unlock(dev, lane);
+}
+
+
 void
 xpcie_fpga_check_direct_err(
   fpga_dev_info_t *dev,
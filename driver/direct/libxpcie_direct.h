@@ -56,6 +56,15 @@ void xpcie_fpga_get_direct_frames(
         fpga_dev_info_t *dev,
         fpga_ioctl_direct_framenum_t *framenum);
 
+/**
+ * @brief Direct: select fchid and read all its counters under the lane's lock
+ */
+void xpcie_fpga_get_direct_stat_fchid(
+        fpga_dev_info_t *dev,
+        uint32_t lane,
+        uint32_t fchid,
+        fpga_direct_stat_fchid_t *stat);
+
 /**
  * @brief Direct
  */
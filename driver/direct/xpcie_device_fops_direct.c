@@ -4,6 +4,9 @@
 * SPDX-License-Identifier: GPL-2.0-or-later
 *************************************************/
 
+#include <linux/mm.h>
+#include <linux/sched.h>
+
 #include "libxpcie_direct.h"
 #include "xpcie_regs_direct.h"
 
@@ -66,6 +69,38 @@ xpcie_fpga_ioctl_direct(struct file *filp, unsigned int cmd, unsigned long arg)
       }
     }
     break;
+  case XPCIE_DEV_DIRECT_GET_STAT_ALL:
+    {
+      fpga_ioctl_direct_stat_all_t stat_all;
+      fpga_direct_stat_fchid_t *fchid_stats;
+      uint32_t index;
+      if (copy_from_user(&stat_all, (void __user *)arg, sizeof(fpga_ioctl_direct_stat_all_t))) {
+        ret = -EFAULT;
+        break;
+      }
+      if (stat_all.lane < 0 || (uint32_t)stat_all.lane >= dev->mods.direct.num
+        || stat_all.fchid_num == 0 || stat_all.fchid_num > XPCIE_FUNCTION_CHAIN_MAX) {
+        ret = -EINVAL;
+        break;
+      }
+      fchid_stats = kvmalloc_array(stat_all.fchid_num, sizeof(fpga_direct_stat_fchid_t), GFP_KERNEL);
+      if (!fchid_stats) {
+        ret = -ENOMEM;
+        break;
+      }
+      // Each fchid is selected and read under the lane's lock,
+      //  the lock is released between them not to block other accesses for long
+      for (index = 0; index < stat_all.fchid_num; index++) {
+        xpcie_fpga_get_direct_stat_fchid(dev, stat_all.lane, XPCIE_FUNCTION_CHAIN_ID_MIN + index, &fchid_stats[index]);
+        cond_resched();
+      }
+      if (copy_to_user((void __user *)(uintptr_t)stat_all.fchid_stats,
+          fchid_stats, sizeof(fpga_direct_stat_fchid_t) * stat_all.fchid_num)) {
+        ret = -EFAULT;
+      }
+      kvfree(fchid_stats);
+    }
+    break;
   /* *** Direct err *** */
   case XPCIE_DEV_DIRECT_GET_ERR_ALL:
     {
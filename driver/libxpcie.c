@@ -5,6 +5,8 @@
 *************************************************/
 
 #include <linux/delay.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
 #include <asm/mwait.h>
 
 #include <libxpcie.h>
@@ -264,6 +266,167 @@ xpcie_fpga_copy_base_address_for_user(
 }
 
 
+int
+xpcie_fpga_reg_rw_vec(
+  fpga_dev_info_t *dev,
+  fpga_ioctl_reg_op_t *ops,
+  uint32_t num,
+  uint32_t *done)
+{
+  uint32_t index;
+  uint32_t poll_budget_us = XPCIE_DEV_REG_POLL_MAX_US;
+  spinlock_t *lock = NULL;
+  int ret = 0;
+
+  xpcie_trace("%s: dev(%s), num(%u)", __func__, dev->serial_id, num);
+
+  *done = 0;
+
+  // Check all operations before touching any register
+  for (index = 0; index < num; index++) {
+    if (ops[index].op >= XPCIE_DEV_REG_OP_MAX
+      || (ops[index].offset % sizeof(uint32_t)) != 0
+      || (uint64_t)ops[index].offset + sizeof(uint32_t) > dev->base_addr_len) {
+      xpcie_err(" %s invalid operation[%u](op:%u, offset:%#x)",
+        dev->serial_id, index, ops[index].op, ops[index].offset);
+      return -EINVAL;
+    }
+    // All operations should be in the same module's lane,
+    //  because only one lock is taken for the sequence
+    if (!lock) {
+      lock = __reg_lock(dev, ops[index].offset);
+    } else if (lock != __reg_lock(dev, ops[index].offset)) {
+      xpcie_err(" %s operation[%u](offset:%#x) is out of the lane of operation[0](offset:%#x)",
+        dev->serial_id, index, ops[index].offset, ops[0].offset);
+      return -EINVAL;
+    }
+  }
+
+  // Execute operations in order without releasing the lock,
+  //  so that the sequence is atomic with respect to other register accesses.
+  // Polling is bounded by the small XPCIE_DEV_REG_POLL_MAX_US for the same reason,
+  //  longer waits should be done by repeating the call.
+  spin_lock(lock);
+  for (index = 0; index < num; index++) {
+    fpga_ioctl_reg_op_t *op = &ops[index];
+    switch (op->op) {
+    case XPCIE_DEV_REG_OP_READ32:
+      op->value = __reg_read32_locked(dev, op->offset);
+      break;
+    case XPCIE_DEV_REG_OP_WRITE32:
+      __reg_write32_locked(dev, op->offset, op->value);
+      break;
+    case XPCIE_DEV_REG_OP_POLL32:
+      {
+        uint32_t elapsed_us = 0;
+        uint32_t value = __reg_read32_locked(dev, op->offset);
+        while ((value & op->mask) != op->value) {
+          if (elapsed_us >= op->poll_us || poll_budget_us == 0) {
+            ret = -ETIMEDOUT;
+            break;
+          }
+          udelay(1);
+          elapsed_us++;
+          poll_budget_us--;
+          value = __reg_read32_locked(dev, op->offset);
+        }
+        op->value = value;
+      }
+      break;
+    default:
+      break;
+    }
+    if (ret)
+      break;
+  }
+  spin_unlock(lock);
+  *done = index;
+
+#ifdef XPCIE_REGISTER_LOG
+  for (index = 0; index < *done; index++)
+    xpcie_info("rw_vec  : dev_id: %02d, op: %u, offset: 0x%08x, value: 0x%08x",
+      dev->dev_id, ops[index].op, ops[index].offset, ops[index].value);
+#endif
+
+  return ret;
+}
+
+
+/**
+ * @struct xpcie_reg_mmap_range_t
+ * @brief Struct for a sub-range of a module lane which can be mapped read-only
+ */
+typedef struct xpcie_reg_mmap_range {
+  size_t mod;       /**< offsetof() the module in fpga_modules_info_t */
+  uint32_t head;    /**< head offset in a lane */
+  uint32_t tail;    /**< tail offset in a lane(exclusive) */
+} xpcie_reg_mmap_range_t;
+
+/**
+ * static global variable: Statistics/status registers which have no side effect on read.
+ * Control registers, W1C fault registers and the PTU event queue(pops on read) are excluded.
+ */
+static const xpcie_reg_mmap_range_t xpcie_reg_mmap_ranges[] = {
+  { offsetof(fpga_modules_info_t, chain),  0x0320, 0x0334 },  // INGR_LATENCY_0_VALUE - FUNC_LATENCY_VALUE
+  { offsetof(fpga_modules_info_t, chain),  0x0340, 0x03C0 },  // STAT_INGR_RCV_DATA_0_VALUE_L - STAT_EGR_DISCARD_DATA_1_VALUE_H
+  { offsetof(fpga_modules_info_t, chain),  0x0400, 0x0418 },  // STAT_HEADER_BUFF_STORED - EXTIF1_SESSION_STATUS
+  { offsetof(fpga_modules_info_t, direct), 0x0050, 0x0080 },  // STAT_INGR_RCV_DATA_VALUE_L - STAT_EGR_SND_FRAME_VALUE
+  { offsetof(fpga_modules_info_t, ptu),    0x00E0, 0x012C },  // TCP_EVENT_MISS - RAWETH_RX_LEN
+  { offsetof(fpga_modules_info_t, conv),   0x0060, 0x00C8 },  // STAT_INGR_RCV_DATA_VALUE_L - STAT_INGR_FRAME_BUFFER_USAGE
+  { offsetof(fpga_modules_info_t, func),   0x0050, 0x0080 },  // STAT_INGR_RCV_DATA_0_VALUE_L - STAT_EGR_SND_FRAME_1_VALUE
+};
+
+
+/**
+ * @brief Function which check if a page consists only of xpcie_reg_mmap_ranges
+ */
+static bool
+xpcie_fpga_is_reg_mmap_page(
+  fpga_dev_info_t *dev,
+  uint64_t page)
+{
+  size_t index;
+  uint32_t lane;
+
+  for (index = 0; index < ARRAY_SIZE(xpcie_reg_mmap_ranges); index++) {
+    const xpcie_reg_mmap_range_t *range = &xpcie_reg_mmap_ranges[index];
+    fpga_module_info_t *mod = (fpga_module_info_t *)((char *)&dev->mods + range->mod);
+    for (lane = 0; lane < mod->num; lane++) {
+      uint64_t lane_base = mod->base + (uint64_t)mod->len * lane;
+      if (page >= lane_base + range->head && page + PAGE_SIZE <= lane_base + range->tail)
+        return true;
+    }
+  }
+
+  return false;
+}
+
+
+int
+xpcie_fpga_check_reg_mmap_window(
+  fpga_dev_info_t *dev,
+  uint64_t offset,
+  uint64_t size)
+{
+  // Every mapped page must be covered by statistics/status registers,
+  // because a mapping cannot hide the other registers in the same page.
+  // Global, LLDMA and CMS modules are accessed only via driver.
+  uint64_t page;
+
+  if (size == 0 || !PAGE_ALIGNED(offset) || !PAGE_ALIGNED(size))
+    return -EINVAL;
+  if (offset + size > dev->base_addr_len)
+    return -EINVAL;
+
+  for (page = offset; page < offset + size; page += PAGE_SIZE) {
+    if (!xpcie_fpga_is_reg_mmap_page(dev, page))
+      return -EINVAL;
+  }
+
+  return 0;
+}
+
+
 int
 xpcie_fpga_dev_init(fpga_dev_info_t *dev)
 {
@@ -277,6 +440,15 @@ xpcie_fpga_dev_init(fpga_dev_info_t *dev)
   INIT_LIST_HEAD(&dev->list);
   mutex_init(&dev->queue_mutex);
   spin_lock_init(&dev->lock);
+  spin_lock_init(&dev->fch_soft_lock);
+  xpcie_fpga_init_module_locks(dev);
+
+  // Allocate function chain table, which is mapped to user by mmap()
+  dev->fch_soft = vmalloc_user(PAGE_ALIGN(sizeof(fpga_chain_soft_table_t)));
+  if (!dev->fch_soft) {
+    xpcie_alert("Init: Failed to allocate function chain table");
+    return -ENOMEM;
+  }
 
   // Get Base Address of registers from pci structure.
   dev->base_addr_hw = pci_resource_start(pdev, 0);
@@ -352,7 +524,7 @@ xpcie_fpga_dev_init(fpga_dev_info_t *dev)
 #endif  // ENABLE_SETTING_IN_DRIVER
 
   // Initailize function chain table
-  memset(dev->fch_dev_table, 0xFF, sizeof(dev->fch_dev_table));
+  memset(dev->fch_soft->table, 0xFF, sizeof(dev->fch_soft->table));
 
   // Get serial_id and card_name@CMS
 #if !defined(XPCIE_UNUSE_SERIAL_ID) && defined(ENABLE_MODULE_CMS)
@@ -403,6 +575,9 @@ xpcie_fpga_dev_close(fpga_dev_info_t *dev)
     iounmap(dev->base_addr);
   }
   dev->base_addr = NULL;
+
+  vfree(dev->fch_soft);
+  dev->fch_soft = NULL;
 }
 
 
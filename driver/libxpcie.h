@@ -86,6 +86,7 @@ typedef struct fpga_module_info {
   uint32_t len;                         /**< length per a lane */
   uint32_t num;                         /**< lane num */
   int refcount[XPCIE_KERNEL_LANE_MAX];  /**< used or not per a lane */
+  spinlock_t lock[XPCIE_KERNEL_LANE_MAX]; /**< lock for exclusive register access per a lane */
 } fpga_module_info_t;
 
 /**
@@ -104,14 +105,6 @@ typedef struct fpga_modules_info {
   enum FPGA_CONTROL_TYPE ctrl_type; /**< Control type */
 } fpga_modules_info_t;
 
-/**
- * @struct extifid_cid_t
- */
-typedef struct extifid_cid {
-  int extif_id;
-  int cid;
-} extifid_cid_t;
-
 /**
  * @struct fpga_dev_info_t
  * @brief Struct for FPGA's general information
@@ -131,7 +124,7 @@ typedef struct fpga_dev_info {
   uint64_t base_addr_len;     /**< Base register address length */
   phys_addr_t base_addr_hw;   /**< Base register address (hardware address) */
 
-  spinlock_t lock;            /**< lock for exclusive register access */
+  spinlock_t lock;            /**< lock for exclusive register access outside of modules */
 
   spinlock_t lock_refcount;   /**< lock for exclusive refcount access */
   int refcount;               /**< (Not used)reference count of this device */
@@ -142,8 +135,9 @@ typedef struct fpga_dev_info {
   fpga_queue_enqdeq_t enqueues[XPCIE_MAX_QUEUE_PAIR]; /**< Command queue's status for DMA RX */
   fpga_queue_enqdeq_t dequeues[XPCIE_MAX_QUEUE_PAIR]; /**< Command queue's status for DMA TX */
 
-  /** Function chain's status table with lane, fchid, cid(0:ingr/1:egr) as the index */
-  extifid_cid_t fch_dev_table[XPCIE_KERNEL_LANE_MAX][XPCIE_FUNCTION_CHAIN_MAX][2];  //
+  /** Function chain's status table with lane, fchid, cid(0:ingr/1:egr) as the index, mapped read-only to user */
+  fpga_chain_soft_table_t *fch_soft;
+  spinlock_t fch_soft_lock;   /**< lock for exclusive update of fch_soft */
 
   char card_name[FPGA_CARD_NAME_LEN]; /**< FPGA's card name got by CMS */
   char serial_id[SERIAL_ID_LEN];      /**< FPGA's serial id got by CMS */
@@ -164,6 +158,8 @@ struct xpcie_file_private {
   bool is_get_queue;      /**< true:get queue false:not get queue */
   bool is_valid_command;  /**< true:there were valid ioctl command/false: else */
   bool is_avail_rw;       /**< true:available to read()/write(), false:else */
+  atomic_t reg_mmap_num;  /**< num of read-only register windows mapped by this file */
+  spinlock_t reg_mmap_lock; /**< lock for is_avail_rw and reg_mmap_num */
 };
 
 
@@ -230,9 +226,86 @@ void xpcie_fpga_copy_base_address_for_user(
 int xpcie_fpga_common_get_module_info(
         fpga_dev_info_t *dev);
 
+/**
+ * @brief Function which execute register operations in order under one lock
+ */
+int xpcie_fpga_reg_rw_vec(
+        fpga_dev_info_t *dev,
+        fpga_ioctl_reg_op_t *ops,
+        uint32_t num,
+        uint32_t *done);
 
 /**
- * @brief Function which Read register
+ * @brief Function which check if the range can be mapped as read-only register window
+ * @details Every page of the range must consist only of statistics/status registers
+ *          which have no side effect on read.
+ */
+int xpcie_fpga_check_reg_mmap_window(
+        fpga_dev_info_t *dev,
+        uint64_t offset,
+        uint64_t size);
+
+
+/**
+ * @brief Function which get the lock for the register
+ * @param[in] dev
+ *   Target device
+ * @param[in] offset
+ *   Target register offset from the head of device
+ * @return
+ *   The lock of the module's lane which includes `offset`,
+ *   or dev->lock when `offset` is outside of modules
+ */
+static inline spinlock_t *
+__reg_lock(
+  fpga_dev_info_t *dev,
+  uint32_t offset)
+{
+  fpga_module_info_t *mods[] = {
+    &dev->mods.global,
+    &dev->mods.chain,
+    &dev->mods.direct,
+    &dev->mods.lldma,
+    &dev->mods.ptu,
+    &dev->mods.conv,
+    &dev->mods.func,
+    &dev->mods.cms,
+  };
+  size_t index;
+
+  for (index = 0; index < ARRAY_SIZE(mods); index++) {
+    fpga_module_info_t *mod = mods[index];
+    if (mod->len == 0 || offset < mod->base)
+      continue;
+    if (offset - mod->base < (uint64_t)mod->len * mod->num)
+      return &mod->lock[(offset - mod->base) / mod->len];
+  }
+
+  return &dev->lock;
+}
+
+/**
+ * @brief Function which get the lock for the module's lane
+ * @param[in] dev
+ *   Target device
+ * @param[in] mod
+ *   Target module
+ * @param[in] lane
+ *   Target lane
+ * @return
+ *   The lock of the lane, or dev->lock when `lane` is out of range
+ */
+static inline spinlock_t *
+__reg_lane_lock(
+  fpga_dev_info_t *dev,
+  fpga_module_info_t *mod,
+  uint32_t lane)
+{
+  return lane < XPCIE_KERNEL_LANE_MAX ? &mod->lock[lane] : &dev->lock;
+}
+
+/**
+ * @brief Function which Read register while the lock for the register is held by caller
  * @param[in] dev
  *   Target device
  * @param[in] offset
@@ -241,21 +314,79 @@ int xpcie_fpga_common_get_module_info(
  *   Read register value
  */
 static inline uint32_t
-reg_read32(
+__reg_read32_locked(
   fpga_dev_info_t *dev,
   uint32_t offset)
 {
   uint32_t value;
-  spin_lock(&dev->lock);
   value = *(const volatile uint32_t *)(dev->base_addr + offset);
   rmb();
-  spin_unlock(&dev->lock);
+  return value;
+}
+
+/**
+ * @brief Function which Write register while the lock for the register is held by caller
+ * @param[in] dev
+ *   Target device
+ * @param[in] offset
+ *   Target register offset from the head of device
+ * @param[in] value
+ *   Set value
+ */
+static inline void
+__reg_write32_locked(
+  fpga_dev_info_t *dev,
+  uint32_t offset,
+  uint32_t value)
+{
+  wmb();
+  *(volatile uint32_t *)(dev->base_addr + offset) = value;
+}
+
+/**
+ * @brief Function which Read register with the given lock
+ * @param[in] dev
+ *   Target device
+ * @param[in] lock
+ *   The lock for the register
+ * @param[in] offset
+ *   Target register offset from the head of device
+ * @return
+ *   Read register value
+ */
+static inline uint32_t
+__reg_read32(
+  fpga_dev_info_t *dev,
+  spinlock_t *lock,
+  uint32_t offset)
+{
+  uint32_t value;
+  spin_lock(lock);
+  value = __reg_read32_locked(dev, offset);
+  spin_unlock(lock);
 #ifdef XPCIE_REGISTER_LOG
   xpcie_info("read32  : dev_id: %02d, offset: 0x%08x, value: 0x%08x", dev->dev_id, offset, value);
 #endif
   return value;
 }
 
+/**
+ * @brief Function which Read register
+ * @param[in] dev
+ *   Target device
+ * @param[in] offset
+ *   Target register offset from the head of device
+ * @return
+ *   Read register value
+ */
+static inline uint32_t
+reg_read32(
+  fpga_dev_info_t *dev,
+  uint32_t offset)
+{
+  return __reg_read32(dev, __reg_lock(dev, offset), offset);
+}
+
 /**
  * @brief (No available)Function which Read register(64bit)
  * @param[in] dev
@@ -271,10 +402,11 @@ reg_read64(
   uint32_t offset)
 {
   uint32_t value;
-  spin_lock(&dev->lock);
+  spinlock_t *lock = __reg_lock(dev, offset);
+  spin_lock(lock);
   value = *(const volatile uint64_t *)(dev->base_addr + offset);
   rmb();
-  spin_unlock(&dev->lock);
+  spin_unlock(lock);
 #ifdef XPCIE_REGISTER_LOG
   xpcie_info("read64  : dev_id: %02d, offset: 0x%08x, value: 0x%08x", dev->dev_id, offset, value);
 #endif
@@ -282,50 +414,99 @@ reg_read64(
 }
 
 /**
- * @brief (No available)Function which Read register
+ * @brief Function which Write register with the given lock
  * @param[in] dev
  *   Target device
+ * @param[in] lock
+ *   The lock for the register
  * @param[in] offset
  *   Target register offset from the head of device
  * @param[in] value
  *   Set value
  */
 static inline void
-reg_write32(
+__reg_write32(
   fpga_dev_info_t *dev,
+  spinlock_t *lock,
   uint32_t offset,
   uint32_t value)
 {
 #ifdef XPCIE_REGISTER_LOG
   xpcie_info("write32 : dev_id: %02d, offset: 0x%08x, value: 0x%08x", dev->dev_id, offset, value);
 #endif
-  wmb();
-  spin_lock(&dev->lock);
-  *(volatile uint32_t *)(dev->base_addr + offset) = value;
-  spin_unlock(&dev->lock);
+  spin_lock(lock);
+  __reg_write32_locked(dev, offset, value);
+  spin_unlock(lock);
 #ifdef XPCIE_REGISTER_LOG
 #ifndef XPCIE_REGISTER_LOG_SUPPRESS_CHECK_REALLY_WRITE
-  reg_read32(dev, offset);
+  __reg_read32(dev, lock, offset);
 #endif
 #endif
 }
 
-/** Macro for Common Register Write */
+/**
+ * @brief (No available)Function which Read register
+ * @param[in] dev
+ *   Target device
+ * @param[in] offset
+ *   Target register offset from the head of device
+ * @param[in] value
+ *   Set value
+ */
+static inline void
+reg_write32(
+  fpga_dev_info_t *dev,
+  uint32_t offset,
+  uint32_t value)
+{
+  __reg_write32(dev, __reg_lock(dev, offset), offset, value);
+}
+
+/** Macro for Common lock of the module's lane */
+#define __reg_lock_lane(mod, dev, lane) \
+  __reg_lane_lock((dev), &(dev)->mods.mod, (lane))
+/** Macro for Common Register Write(with the lock of the module's lane) */
 #define __reg_write(mod, dev, offset, lane, value) \
-  reg_write32((dev), (dev)->mods.mod.base + (dev)->mods.mod.len * (lane) + (offset), (value))
-/** Macro for Common Register Read */
+  __reg_write32((dev), __reg_lock_lane(mod, dev, lane), \
+    (dev)->mods.mod.base + (dev)->mods.mod.len * (lane) + (offset), (value))
+/** Macro for Common Register Read(with the lock of the module's lane) */
 #define __reg_read(mod, dev, offset, lane) \
-  reg_read32((dev), (dev)->mods.mod.base + (dev)->mods.mod.len * (lane) + (offset))
+  __reg_read32((dev), __reg_lock_lane(mod, dev, lane), \
+    (dev)->mods.mod.base + (dev)->mods.mod.len * (lane) + (offset))
+/** Macro for Common Register Write while the lock of the module's lane is held by caller */
+#define __reg_write_locked(mod, dev, offset, lane, value) \
+  __reg_write32_locked((dev), (dev)->mods.mod.base + (dev)->mods.mod.len * (lane) + (offset), (value))
+/** Macro for Common Register Read while the lock of the module's lane is held by caller */
+#define __reg_read_locked(mod, dev, offset, lane) \
+  __reg_read32_locked((dev), (dev)->mods.mod.base + (dev)->mods.mod.len * (lane) + (offset))
 
 /** Macro for Chain module's Register Write */
 #define chain_reg_write(dev, offset, lane, value)   __reg_write(chain, dev, offset, lane, value)
 /** Macro for Chain module's Register Read */
 #define chain_reg_read(dev, offset, lane)           __reg_read(chain, dev, offset, lane)
+/** Macro for Chain module's lock to access registers of the lane as a sequence */
+#define chain_reg_lock(dev, lane)                   spin_lock(__reg_lock_lane(chain, dev, lane))
+/** Macro for Chain module's unlock */
+#define chain_reg_unlock(dev, lane)                 spin_unlock(__reg_lock_lane(chain, dev, lane))
+/** Macro for Chain module's Register Write while chain_reg_lock() is held */
+#define chain_reg_write_locked(dev, offset, lane, value) \
+  __reg_write_locked(chain, dev, offset, lane, value)
+/** Macro for Chain module's Register Read while chain_reg_lock() is held */
+#define chain_reg_read_locked(dev, offset, lane)    __reg_read_locked(chain, dev, offset, lane)
 
 /** Macro for Direct module's Register Write */
 #define direct_reg_write(dev, offset, lane, value)  __reg_write(direct, dev, offset, lane, value)
 /** Macro for Direct module's Register Read */
 #define direct_reg_read(dev, offset, lane)          __reg_read(direct, dev, offset, lane)
+/** Macro for Direct module's lock to access registers of the lane as a sequence */
+#define direct_reg_lock(dev, lane)                  spin_lock(__reg_lock_lane(direct, dev, lane))
+/** Macro for Direct module's unlock */
+#define direct_reg_unlock(dev, lane)                spin_unlock(__reg_lock_lane(direct, dev, lane))
+/** Macro for Direct module's Register Write while direct_reg_lock() is held */
+#define direct_reg_write_locked(dev, offset, lane, value) \
+  __reg_write_locked(direct, dev, offset, lane, value)
+/** Macro for Direct module's Register Read while direct_reg_lock() is held */
+#define direct_reg_read_locked(dev, offset, lane)   __reg_read_locked(direct, dev, offset, lane)
 
 /** Macro for LLDMA module's Register Write */
 #define lldma_reg_write(dev, offset, value)          __reg_write(lldma, dev, offset, 0, value)
@@ -132,6 +132,15 @@ typedef struct fpga_queue {
 #define FPGA_EXTIF_NUMBER_0                 0
 #define FPGA_EXTIF_NUMBER_1                 1
 
+// about function chain table
+#define XPCIE_DEV_CHAIN_BATCH_MAX           (XPCIE_FUNCTION_CHAIN_MAX * FPGA_CID_KIND_MAX)  /**< Max num of entries per a XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH */
+
+// about register access
+#define XPCIE_DEV_REG_VEC_MAX               256   /**< Max num of register operations per a XPCIE_DEV_DRIVER_RW_REGS */
+#define XPCIE_DEV_REG_POLL_MAX_US           20    /**< Max total polling time per a XPCIE_DEV_DRIVER_RW_REGS[us], spent with the lane lock held */
+#define XPCIE_DEV_MMAP_REG_OFFSET           0x100000000ULL  /**< mmap offset for read-only register windows(register offset is added) */
+#define XPCIE_DEV_MMAP_SOFT_TABLE_OFFSET    0x80000000ULL   /**< mmap offset for read-only soft table of function chains */
+
 // Definition for driver errno
 #define XPCIE_DEV_UPDATE_TIMEOUT            1     /**< errno : Failed to update function chain table */
 #define XPCIE_DEV_NO_CHAIN_FOUND            2     /**< errno : Failed to find function chain */
@@ -188,6 +197,17 @@ enum XPCIE_DEV_REGCTRL_COMMAND {
   XPCIE_DEV_REG_DISABLE,    /**< Disable read()/write() */
 };
 
+/**
+ * @enum XPCIE_DEV_REG_OP
+ * @brief Enumeration of register operations for XPCIE_DEV_DRIVER_RW_REGS
+ */
+enum XPCIE_DEV_REG_OP {
+  XPCIE_DEV_REG_OP_READ32 = 0,  /**< Read register into value */
+  XPCIE_DEV_REG_OP_WRITE32,     /**< Write value into register */
+  XPCIE_DEV_REG_OP_POLL32,      /**< Poll until (register & mask) == value, and read register into value */
+  XPCIE_DEV_REG_OP_MAX,         /**< Sentinel: Invalid parameter */
+};
+
 /**
  * @enum FPGA_TEMP_FLAG
  * @brief Enumeration of flags for CMS temp register
@@ -378,6 +398,26 @@ typedef struct fpga_id{
   uint8_t  blocking_flag; /**< flag for blocking transfer */
 }fpga_id_t;
 
+/**
+ * @struct fpga_ioctl_chain_batch_entry_t
+ * @brief Struct for an entry of XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH
+ */
+typedef struct fpga_ioctl_chain_batch_entry {
+  fpga_id_t id;     /**< Table entry(id.lane is overwritten by the lane of the batch) */
+  uint32_t  kind;   /**< FPGA_CID_KIND_INGRESS or FPGA_CID_KIND_EGRESS */
+  int32_t   status; /**< [out]0, -EINVAL or -XPCIE_DEV_UPDATE_TIMEOUT */
+} fpga_ioctl_chain_batch_entry_t;
+
+/**
+ * @struct fpga_ioctl_chain_batch_t
+ * @brief Struct for XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH
+ */
+typedef struct fpga_ioctl_chain_batch {
+  uint32_t lane;      /**< lane */
+  uint32_t num;       /**< The num of entries(max XPCIE_DEV_CHAIN_BATCH_MAX) */
+  uint64_t entries;   /**< User address of fpga_ioctl_chain_batch_entry_t[num] */
+} fpga_ioctl_chain_batch_t;
+
 /**
  * @struct fpga_ioctl_chain_id_t
  * @brief Struct for function chain read table in driver
@@ -391,6 +431,37 @@ typedef struct fpga_ioctl_chain_ids{
   uint32_t egress_cid;        /**< connection id */
 }fpga_ioctl_chain_ids_t;
 
+/**
+ * @struct fpga_ioctl_chain_soft_table_t
+ * @brief Struct for XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL
+ */
+typedef struct fpga_ioctl_chain_soft_table {
+  uint32_t lane;      /**< lane */
+  uint32_t num;       /**< The num of ids from XPCIE_FUNCTION_CHAIN_ID_MIN(max XPCIE_FUNCTION_CHAIN_MAX) */
+  uint64_t ids;       /**< User address of fpga_ioctl_chain_ids_t[num] */
+} fpga_ioctl_chain_soft_table_t;
+
+/**
+ * @struct fpga_chain_soft_entry_t
+ * @brief Struct for an entry of the soft table of function chains
+ */
+typedef struct fpga_chain_soft_entry {
+  int32_t extif_id;   /**< external interface id(-1: no chain) */
+  int32_t cid;        /**< connection id(-1: no chain) */
+} fpga_chain_soft_entry_t;
+
+/**
+ * @struct fpga_chain_soft_table_t
+ * @brief Struct for the soft table of function chains mapped at XPCIE_DEV_MMAP_SOFT_TABLE_OFFSET
+ * @details `seq` is odd while the driver updates `table`.
+ *          A copy of `table` taken between two reads of the same even `seq` is consistent.
+ */
+typedef struct fpga_chain_soft_table {
+  uint32_t seq;       /**< sequence counter */
+  uint32_t reserved;
+  fpga_chain_soft_entry_t table[XPCIE_KERNEL_LANE_MAX][XPCIE_FUNCTION_CHAIN_MAX][FPGA_CID_KIND_MAX];  /**< [lane][fchid][kind] */
+} fpga_chain_soft_table_t;
+
 /**
  * @struct fpga_ioctl_chain_ddr_t
  */
@@ -446,6 +517,45 @@ typedef struct fpga_ioctl_chain_bytenum {
   uint64_t byte_num;
 } fpga_ioctl_chain_bytenum_t;
 
+/**
+ * @struct fpga_chain_stat_cid_t
+ * @brief Struct for all counters of a cid(selected by session)
+ */
+typedef struct fpga_chain_stat_cid {
+  uint64_t ingr_rcv_bytes[2];       /**< CHAIN_STAT_INGR_RCV0/1 */
+  uint64_t egr_snd_bytes[2];        /**< CHAIN_STAT_EGR_SND0/1 */
+} fpga_chain_stat_cid_t;
+
+/**
+ * @struct fpga_chain_stat_fchid_t
+ * @brief Struct for all counters of a fchid(selected by channel)
+ */
+typedef struct fpga_chain_stat_fchid {
+  uint64_t ingr_snd_bytes[2];       /**< CHAIN_STAT_INGR_SND0/1 */
+  uint64_t egr_rcv_bytes[2];        /**< CHAIN_STAT_EGR_RCV0/1 */
+  uint64_t ingr_discard_bytes[2];   /**< CHAIN_STAT_INGR_DISCARD0/1 */
+  uint64_t egr_discard_bytes[2];    /**< CHAIN_STAT_EGR_DISCARD0/1 */
+  uint32_t ingr_snd_frames[2];      /**< CHAIN_STAT_INGR_SND0/1 */
+  uint32_t egr_rcv_frames[2];       /**< CHAIN_STAT_EGR_RCV0/1 */
+  uint32_t buff_stored;             /**< Stored header buffer */
+  uint32_t buff_bp;                 /**< Header buffer's back pressure */
+  uint32_t egr_busy;                /**< Egress busy */
+  uint32_t reserved;                /**< Reserved */
+} fpga_chain_stat_fchid_t;
+
+/**
+ * @struct fpga_ioctl_chain_stat_all_t
+ * @brief Struct for XPCIE_DEV_CHAIN_GET_STAT_ALL
+ */
+typedef struct fpga_ioctl_chain_stat_all {
+  int      lane;
+  uint32_t cid_num;       /**< The num of cid_stats from XPCIE_CID_MIN(max XPCIE_CID_MAX - XPCIE_CID_MIN + 1) */
+  uint32_t fchid_num;     /**< The num of fchid_stats from XPCIE_FUNCTION_CHAIN_ID_MIN(max XPCIE_FUNCTION_CHAIN_MAX) */
+  uint32_t reserved;
+  uint64_t cid_stats;     /**< User address of fpga_chain_stat_cid_t[cid_num] */
+  uint64_t fchid_stats;   /**< User address of fpga_chain_stat_fchid_t[fchid_num] */
+} fpga_ioctl_chain_stat_all_t;
+
 /**
  * @struct fpga_ioctl_err_all_t
  */
@@ -589,6 +699,25 @@ typedef struct fpga_ioctl_direct_bytenum {
   uint64_t byte_num;
 } fpga_ioctl_direct_bytenum_t;
 
+/**
+ * @struct fpga_direct_stat_fchid_t
+ * @brief Struct for all counters of a fchid(selected by channel)
+ */
+typedef struct fpga_direct_stat_fchid {
+  uint64_t bytes[DIRECT_STAT_EGR_SND + 1];   /**< Indexed by DIRECT_STAT_* */
+  uint32_t frames[DIRECT_STAT_EGR_SND + 1];  /**< Indexed by DIRECT_STAT_* */
+} fpga_direct_stat_fchid_t;
+
+/**
+ * @struct fpga_ioctl_direct_stat_all_t
+ * @brief Struct for XPCIE_DEV_DIRECT_GET_STAT_ALL
+ */
+typedef struct fpga_ioctl_direct_stat_all {
+  int      lane;
+  uint32_t fchid_num;     /**< The num of fchid_stats from XPCIE_FUNCTION_CHAIN_ID_MIN(max XPCIE_FUNCTION_CHAIN_MAX) */
+  uint64_t fchid_stats;   /**< User address of fpga_direct_stat_fchid_t[fchid_num] */
+} fpga_ioctl_direct_stat_all_t;
+
 /**
  * @struct fpga_ioctl_direct_err_prot_t
  */
@@ -753,6 +882,28 @@ typedef struct fpga_ioctl_refcount {
   int refcount;             /**< The data to set for user */
 } fpga_ioctl_refcount_t;
 
+/**
+ * @struct fpga_ioctl_reg_op_t
+ * @brief Struct for a register operation
+ */
+typedef struct fpga_ioctl_reg_op {
+  uint32_t op;      /**< enum XPCIE_DEV_REG_OP */
+  uint32_t offset;  /**< Register offset from the head of device */
+  uint32_t value;   /**< [in]value to write/expect, [out]value read */
+  uint32_t mask;    /**< Mask for XPCIE_DEV_REG_OP_POLL32 */
+  uint32_t poll_us; /**< Polling time for XPCIE_DEV_REG_OP_POLL32[us] */
+} fpga_ioctl_reg_op_t;
+
+/**
+ * @struct fpga_ioctl_reg_vec_t
+ * @brief Struct for register operations executed in order under one lock
+ */
+typedef struct fpga_ioctl_reg_vec {
+  uint64_t ops;   /**< User address of fpga_ioctl_reg_op_t array */
+  uint32_t num;   /**< The num of operations(max XPCIE_DEV_REG_VEC_MAX) */
+  uint32_t done;  /**< [out]The num of operations executed */
+} fpga_ioctl_reg_vec_t;
+
 
 // Definition of ioctl Commands
 #define MAGIC 'h'
@@ -773,7 +924,9 @@ typedef struct fpga_ioctl_refcount {
 
 #define XPCIE_DEV_DRIVER_GET_REFCOUNT         _IOWR(MAGIC, 0x09, fpga_ioctl_refcount_t)
 
-/* 0x0a-0x0f : Missing number */
+#define XPCIE_DEV_DRIVER_RW_REGS              _IOWR(MAGIC, 0x0a, fpga_ioctl_reg_vec_t)
+
+/* 0x0b-0x0f : Missing number */
 
 // LLDMA
 #define XPCIE_DEV_LLDMA_GET_VERSION            _IOR(MAGIC,  0x10, uint32_t)
@@ -895,7 +1048,9 @@ typedef struct fpga_ioctl_refcount {
 #define XPCIE_DEV_CHAIN_READ_SOFT_TABLE       _IOWR(MAGIC, 0x9d, fpga_ioctl_chain_ids_t)
 #define XPCIE_DEV_CHAIN_RESET_SOFT_TABLE      _IO(MAGIC,   0x9e)
 
-/* 0x9f : Missing number */
+#define XPCIE_DEV_CHAIN_GET_STAT_ALL          _IOWR(MAGIC, 0x9f, fpga_ioctl_chain_stat_all_t)
+#define XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH    _IOWR(MAGIC, 0xb4, fpga_ioctl_chain_batch_t)
+#define XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL   _IOWR(MAGIC, 0xb5, fpga_ioctl_chain_soft_table_t)
 
 // Direct
 #define XPCIE_DEV_DIRECT_START_MODULE         _IOW(MAGIC,  0xa0, uint32_t)
@@ -924,7 +1079,9 @@ typedef struct fpga_ioctl_refcount {
 #define XPCIE_DEV_DIRECT_GET_MODULE           _IOWR(MAGIC, 0xb2, fpga_ioctl_direct_ctrl_t)
 #define XPCIE_DEV_DIRECT_GET_MODULE_ID        _IOWR(MAGIC, 0xb3, fpga_ioctl_direct_ctrl_t)
 
-/* 0xb4-0xcf : Missing number */
+#define XPCIE_DEV_DIRECT_GET_STAT_ALL         _IOWR(MAGIC, 0xb6, fpga_ioctl_direct_stat_all_t)
+
+/* 0xb7-0xcf : Missing number */
 
 // CMS
 #define XPCIE_DEV_CMS_GET_TEMP                _IOWR(MAGIC, 0xd0, fpga_ioctl_temp_t)
@@ -956,6 +1113,7 @@ static const CMD_NAME_T CMD_NAME_TABLE[] = {
   COMMAND_ELEMENT(XPCIE_DEV_DRIVER_SET_REG_LOCK),
   COMMAND_ELEMENT(XPCIE_DEV_DRIVER_GET_FPGA_TYPE),
   COMMAND_ELEMENT(XPCIE_DEV_DRIVER_GET_FPGA_ADDR_MAP),
+  COMMAND_ELEMENT(XPCIE_DEV_DRIVER_RW_REGS),
   // LLDMA
   COMMAND_ELEMENT(XPCIE_DEV_LLDMA_ALLOC_QUEUE),
   COMMAND_ELEMENT(XPCIE_DEV_LLDMA_FREE_QUEUE),
@@ -1001,6 +1159,8 @@ static const CMD_NAME_T CMD_NAME_TABLE[] = {
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_READ_TABLE_EGR),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_READ_SOFT_TABLE),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_RESET_SOFT_TABLE),
+  COMMAND_ELEMENT(XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL),
+  COMMAND_ELEMENT(XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_START_MODULE),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_STOP_MODULE),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_SET_DDR_OFFSET_FRAME),
@@ -1045,6 +1205,7 @@ static const CMD_NAME_T CMD_NAME_TABLE[] = {
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_GET_MODULE_ID),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_GET_CONNECTION),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_GET_EGR_BUSY),
+  COMMAND_ELEMENT(XPCIE_DEV_CHAIN_GET_STAT_ALL),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_GET_ERR_TBL),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_SET_ERR_TBL_MASK),
   COMMAND_ELEMENT(XPCIE_DEV_CHAIN_GET_ERR_TBL_MASK),
@@ -1071,6 +1232,7 @@ static const CMD_NAME_T CMD_NAME_TABLE[] = {
   COMMAND_ELEMENT(XPCIE_DEV_DIRECT_GET_ERR_STIF_FORCE),
   COMMAND_ELEMENT(XPCIE_DEV_DIRECT_GET_MODULE),
   COMMAND_ELEMENT(XPCIE_DEV_DIRECT_GET_MODULE_ID),
+  COMMAND_ELEMENT(XPCIE_DEV_DIRECT_GET_STAT_ALL),
   {(unsigned long)-1, ""} // Sentinel
 };
 #undef COMMAND_ELEMENT
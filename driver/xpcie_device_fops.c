@@ -8,6 +8,8 @@
 #include <linux/module.h>
 #include <linux/delay.h>
 #include <linux/uaccess.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
 
 #include <asm/mwait.h>
 
@@ -82,17 +84,25 @@ xpcie_fpga_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
         ret = -EFAULT;
         break;
       }
+      spin_lock(&private->reg_mmap_lock);
       switch (flag) {
       case XPCIE_DEV_REG_ENABLE:
         private->is_avail_rw = true;
         break;
       case XPCIE_DEV_REG_DISABLE:
+        // Mapped register windows would be still readable
+        if (atomic_read(&private->reg_mmap_num) > 0) {
+          xpcie_warn("Register windows are still mapped!");
+          ret = -EBUSY;
+          break;
+        }
         private->is_avail_rw = false;
         break;
       default:
         ret = -EINVAL;
         break;
       }
+      spin_unlock(&private->reg_mmap_lock);
     }
     break;
 
@@ -178,6 +188,51 @@ xpcie_fpga_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
     }
     break;
 
+  // Execute register operations in order under one lock
+  case XPCIE_DEV_DRIVER_RW_REGS:
+    {
+      fpga_ioctl_reg_vec_t ioctl_data;
+      fpga_ioctl_reg_op_t *ops;
+      size_t ops_size;
+      uint32_t copy_num;
+
+      if (unlikely(!private->is_avail_rw)) {
+        ret = -EBUSY;
+        break;
+      }
+      if (copy_from_user(&ioctl_data, (void __user *)arg, sizeof(ioctl_data))) {
+        ret = -EFAULT;
+        break;
+      }
+      if (ioctl_data.num == 0 || ioctl_data.num > XPCIE_DEV_REG_VEC_MAX) {
+        ret = -EINVAL;
+        break;
+      }
+      ops_size = sizeof(fpga_ioctl_reg_op_t) * ioctl_data.num;
+      ops = kmalloc(ops_size, GFP_KERNEL);
+      if (ops == NULL) {
+        ret = -ENOMEM;
+        break;
+      }
+      if (copy_from_user(ops, (void __user *)(uintptr_t)ioctl_data.ops, ops_size)) {
+        kfree(ops);
+        ret = -EFAULT;
+        break;
+      }
+      ret = xpcie_fpga_reg_rw_vec(dev, ops, ioctl_data.num, &ioctl_data.done);
+      // Return read values even if polling timed out,
+      //  including the last value read by the timed-out operation
+      copy_num = ioctl_data.done;
+      if (ret == -ETIMEDOUT && copy_num < ioctl_data.num)
+        copy_num++;
+      if (copy_to_user((void __user *)(uintptr_t)ioctl_data.ops, ops, sizeof(fpga_ioctl_reg_op_t) * copy_num)
+        || copy_to_user((void __user *)arg, &ioctl_data, sizeof(ioctl_data))) {
+        ret = -EFAULT;
+      }
+      kfree(ops);
+    }
+    break;
+
   default:
     private->is_valid_command = false;
     ret = -EINVAL;
@@ -237,6 +292,9 @@ xpcie_cdev_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
     goto xpcie_cdev_ioctl_finish;
 #endif
 
+  // No module knows the command
+  ret = -ENOTTY;
+
 xpcie_cdev_ioctl_finish:
   xpcie_trace("%s: cmd(%s), ret(%ld)", __func__, XPCIE_DEV_COMMAND_NAME(cmd), ret);
   if(unlikely(ret < 0)){
@@ -279,6 +337,8 @@ xpcie_cdev_open(struct inode *inode, struct file *filp)
 #else
   private->is_avail_rw = true;
 #endif
+  atomic_set(&private->reg_mmap_num, 0);
+  spin_lock_init(&private->reg_mmap_lock);
 
   filp->private_data = private;
 
@@ -443,6 +503,145 @@ static struct vm_operations_struct xpcie_remap_vm_ops = {
 };
 
 
+/**
+ * @brief Function for open() of vm of register window
+ */
+static void
+xpcie_reg_vma_open(struct vm_area_struct *vma)
+{
+  struct xpcie_file_private *private = vma->vm_private_data;
+  atomic_inc(&private->reg_mmap_num);
+}
+
+
+/**
+ * @brief Function for close() of vm of register window
+ */
+static void
+xpcie_reg_vma_close(struct vm_area_struct *vma)
+{
+  struct xpcie_file_private *private = vma->vm_private_data;
+  atomic_dec(&private->reg_mmap_num);
+}
+
+
+/**
+ * static global variable: Operations definition of register window as vm
+ */
+static struct vm_operations_struct xpcie_reg_vm_ops = {
+  .open   = xpcie_reg_vma_open,
+  .close  = xpcie_reg_vma_close,
+};
+
+
+/**
+ * @brief Function for mmap() of register window as read-only
+ * @details The mmap offset is XPCIE_DEV_MMAP_REG_OFFSET + register offset,
+ *          and only the statistics/status windows of the modules are allowed.
+ */
+static int
+xpcie_cdev_mmap_reg(struct file *filp, struct vm_area_struct *vma)
+{
+  struct xpcie_file_private *private = filp->private_data;
+  fpga_dev_info_t *dev = private->dev;
+  uint64_t offset = ((uint64_t)vma->vm_pgoff << PAGE_SHIFT) - XPCIE_DEV_MMAP_REG_OFFSET;
+  uint64_t map_size = vma->vm_end - vma->vm_start;
+  int ret;
+
+  // Register windows are never writable from user space
+  if (vma->vm_flags & VM_WRITE) {
+    xpcie_warn("Register window(%#llx) must be mapped read-only!", offset);
+    return -EPERM;
+  }
+
+  if (xpcie_fpga_check_reg_mmap_window(dev, offset, map_size)) {
+    xpcie_warn("Invalid register window(offset:%#llx, size:%#llx)!", offset, map_size);
+    return -EINVAL;
+  }
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0))
+  vm_flags_set(vma, VM_IO | VM_PFNMAP | VM_DONTEXPAND | VM_DONTDUMP);
+  vm_flags_clear(vma, VM_MAYWRITE);
+#else
+  vma->vm_flags |= VM_IO | VM_PFNMAP | VM_DONTEXPAND | VM_DONTDUMP;
+  vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+  vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
+
+  // Count the mapping so that read/write cannot be locked while mapped
+  spin_lock(&private->reg_mmap_lock);
+  if (!private->is_avail_rw) {
+    spin_unlock(&private->reg_mmap_lock);
+    return -EBUSY;
+  }
+  atomic_inc(&private->reg_mmap_num);
+  spin_unlock(&private->reg_mmap_lock);
+
+  // remap register space to userspace
+  ret = io_remap_pfn_range(vma, vma->vm_start,
+        (dev->base_addr_hw + offset) >> PAGE_SHIFT,
+        map_size, vma->vm_page_prot);
+  if (ret) {
+    atomic_dec(&private->reg_mmap_num);
+    xpcie_warn("mmap failed!");
+    return -ENODEV;
+  }
+  vma->vm_private_data = private;
+  vma->vm_ops = &xpcie_reg_vm_ops;
+
+#ifdef XPCIE_TRACE_LOG
+  xpcie_info("%s: addr(%#llx), offset(%#llx), size(%#llx)", __func__, (uint64_t)vma->vm_start,\
+    offset, map_size);
+#endif
+
+  return 0;
+}
+
+
+/**
+ * @brief Function for mmap() of the soft table of function chains as read-only
+ * @details The mmap offset is XPCIE_DEV_MMAP_SOFT_TABLE_OFFSET,
+ *          and the layout is fpga_chain_soft_table_t.
+ */
+static int
+xpcie_cdev_mmap_soft_table(struct file *filp, struct vm_area_struct *vma)
+{
+  struct xpcie_file_private *private = filp->private_data;
+  fpga_dev_info_t *dev = private->dev;
+  uint64_t map_size = vma->vm_end - vma->vm_start;
+  int ret;
+
+  // Only the driver updates the table
+  if (vma->vm_flags & VM_WRITE) {
+    xpcie_warn("Soft table must be mapped read-only!");
+    return -EPERM;
+  }
+
+  if (map_size > PAGE_ALIGN(sizeof(fpga_chain_soft_table_t))) {
+    xpcie_warn("Invalid soft table size(%#llx)!", map_size);
+    return -EINVAL;
+  }
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0))
+  vm_flags_clear(vma, VM_MAYWRITE);
+#else
+  vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+
+  ret = remap_vmalloc_range(vma, dev->fch_soft, 0);
+  if (ret) {
+    xpcie_warn("mmap failed!");
+    return -ENODEV;
+  }
+
+#ifdef XPCIE_TRACE_LOG
+  xpcie_info("%s: addr(%#llx), size(%#llx)", __func__, (uint64_t)vma->vm_start, map_size);
+#endif
+
+  return 0;
+}
+
+
 /**
  * @brief Function for mmap()
  */
@@ -455,6 +654,12 @@ xpcie_cdev_mmap(struct file *filp, struct vm_area_struct *vma)
   void *base_addr;
   int ret;
 
+  // Register window or soft table is requested by offset
+  if (((uint64_t)vma->vm_pgoff << PAGE_SHIFT) >= XPCIE_DEV_MMAP_REG_OFFSET)
+    return xpcie_cdev_mmap_reg(filp, vma);
+  if (((uint64_t)vma->vm_pgoff << PAGE_SHIFT) == XPCIE_DEV_MMAP_SOFT_TABLE_OFFSET)
+    return xpcie_cdev_mmap_soft_table(filp, vma);
+
   // Fail when XPCIE_DEV_LLDMA_ALLOC_QUEUE or XPCIE_DEV_LLDMA_BIND_QUEUE
   //  is called by ioctl by the same file descriptor.
   if (private->chid < 0) {
@@ -101,6 +101,71 @@ typedef struct fpga_chain_ddr {
   uint8_t tx_size;
 } fpga_chain_ddr_t;
 
+/**
+ * @struct fpga_chain_conn_t
+ * @brief Struct for a connection of fpga_chain_connect_batch()
+ * @var fpga_chain_conn_t::fchid
+ *      Target function channel id
+ * @var fpga_chain_conn_t::ingress_extif_id
+ *      external IFID for ingress side
+ * @var fpga_chain_conn_t::ingress_cid
+ *      Target connection id for ingress chain
+ * @var fpga_chain_conn_t::egress_extif_id
+ *      external IFID of egress side
+ * @var fpga_chain_conn_t::egress_cid
+ *      Target connection id for egress chain
+ * @var fpga_chain_conn_t::ingress_active_flag
+ *      Forwarding permission setting
+ * @var fpga_chain_conn_t::egress_active_flag
+ *      Forwarding permission setting
+ * @var fpga_chain_conn_t::direct_flag
+ *      direct forwarding setting
+ * @var fpga_chain_conn_t::egress_virtual_flag
+ *      virtual connection flag
+ * @var fpga_chain_conn_t::egress_blocking_flag
+ *      blocking forwarding flag
+ * @var fpga_chain_conn_t::result
+ *      [out] Result of the connection, same as the retval of fpga_chain_connect()
+ */
+typedef struct fpga_chain_conn {
+  uint32_t fchid;
+  uint32_t ingress_extif_id;
+  uint32_t ingress_cid;
+  uint32_t egress_extif_id;
+  uint32_t egress_cid;
+  uint8_t ingress_active_flag;
+  uint8_t egress_active_flag;
+  uint8_t direct_flag;
+  uint8_t egress_virtual_flag;
+  uint8_t egress_blocking_flag;
+  int result;
+} fpga_chain_conn_t;
+
+/**
+ * @struct fpga_chain_wait_t
+ * @brief Struct for an entry of fpga_chain_wait_set()
+ * @var fpga_chain_wait_t::dev_id
+ *      FPGA's device id got by fpga_dev_init()
+ * @var fpga_chain_wait_t::lane
+ *      Target lane of FPGA's module
+ * @var fpga_chain_wait_t::fchid
+ *      Target function channel id
+ * @var fpga_chain_wait_t::dir
+ *      FUNCTION_CHAIN_DIR_INGRESS or FUNCTION_CHAIN_DIR_EGRESS
+ * @var fpga_chain_wait_t::is_established
+ *      true: wait for connection, false: wait for disconnection
+ * @var fpga_chain_wait_t::is_success
+ *      [out] true when the entry is satisfied
+ */
+typedef struct fpga_chain_wait {
+  uint32_t dev_id;
+  uint32_t lane;
+  uint32_t fchid;
+  uint32_t dir;
+  uint32_t is_established;
+  uint32_t is_success;
+} fpga_chain_wait_t;
+
 
 /**
  * @brief API which start Chain Control
@@ -335,6 +400,44 @@ int fpga_chain_connect_egress(
         uint8_t virtual_flag,
         uint8_t blocking_flag);
 
+/**
+ * @brief API which configure many connections of a lane for ingress and egress at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] lane
+ *   Target lane of FPGA's module
+ * @param[in,out] conns
+ *   Connections to configure, the result of each is stored in its `result`
+ * @param[in] num
+ *   Number of `conns`
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `dev_id` is invalid, `lane` is too large, `conns` is NULL
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ * @retval -FAILURE_ESTABLISH
+ *   Some of `conns` failed, see `result` of each
+ *
+ * @details
+ *   Same as fpga_chain_connect() for each of `conns`,
+ *    but the tables are updated by a single ioctl per up to
+ *    FUNCTION_CHAIN_ID_MAX-FUNCTION_CHAIN_ID_MIN+1 connections.@n
+ *   The driver updates ingress and egress tables in parallel.
+ *   Connections are applied in order of `conns` for each direction.@n
+ *   An entry not answered by FPGA within 100ms, or not requested within 1s of its ioctl,
+ *    fails with -TABLE_UPDATE_TIMEOUT.@n
+ *   If either of ingress or egress cannot be set correctly, neither is set.
+ */
+int fpga_chain_connect_batch(
+        uint32_t dev_id,
+        uint32_t lane,
+        fpga_chain_conn_t *conns,
+        uint32_t num);
+
 /**
  * @brief API which disconnect function chain for ingress and egress
  * @param[in] dev_id
@@ -539,6 +642,8 @@ int fpga_chain_read_table_egress(
  *    and both of extif_id and cid on the other side are not NULL.@n
  *    @li NULL(ingress_extif_id,ingress_cid)
  *    @li NULL(egress_extif_id,egress_cid)
+ *   After fpga_chain_soft_table_mmap(), this API reads the mapped table
+ *    without any system call.
  */
 int fpga_chain_read_soft_table(
         uint32_t dev_id,
@@ -549,6 +654,110 @@ int fpga_chain_read_soft_table(
         uint32_t *egress_extif_id,
         uint32_t *egress_cid);
 
+/**
+ * @brief API which map the function chain table in driver read-only
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @retval 0
+ *   Success(also when already mapped)
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value
+ * @retval -FAILURE_MMAP
+ *   Failed to mmap(), e.g.) the driver is too old
+ *
+ * @details
+ *   After this API, fpga_chain_read_soft_table(), fpga_chain_soft_table_snapshot()
+ *    and fpga_chain_wait_set() read the mapped table without any system call.
+ *    The driver bumps a sequence counter around each update,
+ *    so the values read are always consistent.
+ * @sa fpga_chain_soft_table_munmap()
+ */
+int fpga_chain_soft_table_mmap(
+        uint32_t dev_id);
+
+/**
+ * @brief API which unmap the function chain table mapped by fpga_chain_soft_table_mmap()
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @retval 0
+ *   Success(also when not mapped)
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value
+ *
+ * @details
+ *   This API should not be called while other threads read the table
+ *    of the same device.@n
+ *   fpga_dev_finish() calls this API internally.
+ */
+int fpga_chain_soft_table_munmap(
+        uint32_t dev_id);
+
+/**
+ * @brief API which copy the whole function chain table in driver at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[out] snapshot
+ *   Pointer variable to get the table
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value, `snapshot` is null
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ * @retval -FAILURE_IOCTL
+ *   Failed to read the table by ioctl
+ *
+ * @details
+ *   `snapshot->table[lane][fchid][kind]` has extif_id and cid of each function chain,
+ *    and they are -1 when there is no function chain.@n
+ *   When the table is mapped by fpga_chain_soft_table_mmap(),
+ *    the copy is consistent as a whole and taken without any system call.
+ *    Otherwise each lane is read by one ioctl,
+ *    so the lanes may be copied at different moments.
+ */
+int fpga_chain_soft_table_snapshot(
+        uint32_t dev_id,
+        fpga_chain_soft_table_t *snapshot);
+
+/**
+ * @brief API which apply the desired function chain topology written in json
+ * @param[in] json_txt
+ *   Desired topology in json format
+ * @param[out] op_num
+ *   The num of executed connect/disconnect operations(nullable)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `json_txt` is null or not json
+ * @retval -INVALID_DATA
+ *   e.g.) Unknown device, lane out of range, duplicated fchid
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ * @retval (other)
+ *   Error of fpga_chain_connect_ingress() and so on
+ *
+ * @details
+ *   The format of `json_txt` is as below:@n
+ *   {"topology":[{"dev_id":0,"lane":0,"chains":[{"fchid":1,@n
+ *     "ingress":{"extif_id":0,"cid":1,"active":1,"direct":0},@n
+ *     "egress":{"extif_id":0,"cid":1,"active":1,"virtual":0,"blocking":0}}]}]}@n
+ *   "active" is 1 by default, "direct","virtual","blocking" are 0 by default.@n
+ *   All the function chains of a listed lane are managed by this API:
+ *    a direction missing in `json_txt` is disconnected.
+ *    Lanes not listed are left as they are.@n
+ *   The whole `json_txt` is checked before any operation.
+ *    Then the current state of each lane is read at once from the soft table
+ *    and only the differences are applied, disconnections first.
+ *    Function chains connecting both directions are applied by fpga_chain_connect_batch().
+ *    Lanes are applied in parallel.@n
+ *   When an operation fails, the rest of the lane is skipped and
+ *    the lane is left partially applied. Other lanes are not affected.
+ *    The error of the first failed lane in `json_txt` order is returned.
+ */
+int fpga_chain_apply_topology(
+        const char *json_txt,
+        uint32_t *op_num);
+
 /**
  * @brief API which wait for ingress chain connection established
  * @param[in] dev_id
@@ -725,6 +934,46 @@ int fpga_chain_wait_disconnection_egress(
         const struct timeval *interval,
         uint32_t *is_success);
 
+/**
+ * @brief API which wait for many chain connections established or deleted at once
+ * @param[in,out] waits
+ *   Entries to wait for
+ * @param[in] num
+ *   The num of `waits`
+ * @param[in] timeout
+ *   Timeout for polling
+ * @param[in] interval
+ *   Interval for polling
+ * @param[out] missing_num
+ *   The num of entries not satisfied(nullable)
+ * @retval 0
+ *   Success(Don't care if all entries are satisfied or not)
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `waits` is null, `dev_id` is invalid, `lane` is too large
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ * @retval -FAILURE_IOCTL
+ *   Failed to read the soft table
+ *
+ * @details
+ *   This API works as fpga_chain_wait_connection_ingress() and so on
+ *    for all `waits` in one polling loop.@n
+ *   Each sweep reads the whole soft table of every (dev_id, lane)
+ *    which has unsatisfied entries by one ioctl,
+ *    or without any system call after fpga_chain_soft_table_mmap(),
+ *    and satisfied entries are not checked any more.@n
+ *   The polling ends when all entries are satisfied or `timeout` expires.
+ *    Then `waits[].is_success` tells which entries are missing.@n
+ *   When this API fails, the values of `is_success` and `missing_num`
+ *    are not defined.
+ */
+int fpga_chain_wait_set(
+        fpga_chain_wait_t *waits,
+        uint32_t num,
+        const struct timeval *timeout,
+        const struct timeval *interval,
+        uint32_t *missing_num);
+
 /**
  * @brief API which get control value for Chain Control
  * @param[in] dev_id
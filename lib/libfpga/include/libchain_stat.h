@@ -319,6 +319,43 @@ int fpga_chain_wait_stat_egr_free(
         const struct timeval *interval,
         uint32_t *is_success);
 
+/**
+ * @brief API which get all chain control statistics of a lane at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] lane
+ *   Target lane of FPGA's module
+ * @param[out] cid_stats
+ *   statistics of each cid from CID_MIN, array of `cid_num` elements
+ * @param[in] cid_num
+ *   number of cids to get(0 - CID_MAX-CID_MIN+1)
+ * @param[out] fchid_stats
+ *   statistics of each fchid from FUNCTION_CHAIN_ID_MIN, array of `fchid_num` elements
+ * @param[in] fchid_num
+ *   number of fchids to get(0 - FUNCTION_CHAIN_ID_MAX-FUNCTION_CHAIN_ID_MIN+1)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `dev_id` is invalid, `lane` is too large, `cid_num` and `fchid_num` are both 0
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ *
+ * @details
+ *   Get all Chain Control statistics of `lane` by a single ioctl.@n
+ *   All counters of one cid(fchid) are read in one critical section in the driver,
+ *    so they are consistent with each other,
+ *    but different cids(fchids) may be read at slightly different timing.@n
+ *   `cid_stats` may be NULL when `cid_num` is 0, and so is `fchid_stats`.
+ */
+int fpga_chain_get_stat_all(
+        uint32_t dev_id,
+        uint32_t lane,
+        fpga_chain_stat_cid_t *cid_stats,
+        uint32_t cid_num,
+        fpga_chain_stat_fchid_t *fchid_stats,
+        uint32_t fchid_num);
+
 
 #ifdef __cplusplus
 }
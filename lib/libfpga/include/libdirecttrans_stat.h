@@ -92,6 +92,35 @@ int fpga_direct_get_stat_frames(
         uint32_t reg_id,
         uint32_t *frame_num);
 
+/**
+ * @brief API which get all Direct Transfer Adapter statistics of a lane at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] lane
+ *   Target lane of FPGA's module
+ * @param[out] fchid_stats
+ *   statistics of each fchid from FUNCTION_CHAIN_ID_MIN, array of `fchid_num` elements
+ * @param[in] fchid_num
+ *   number of fchids to get(1 - FUNCTION_CHAIN_ID_MAX-FUNCTION_CHAIN_ID_MIN+1)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `dev_id` is invalid, `lane` is too large, `fchid_num` is 0
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ *
+ * @details
+ *   Get bytes and frames of all DIRECT_STAT_* of `lane` by a single ioctl.@n
+ *   All counters of one fchid are read in one critical section in the driver,
+ *    but different fchids may be read at slightly different timing.
+ */
+int fpga_direct_get_stat_all(
+        uint32_t dev_id,
+        uint32_t lane,
+        fpga_direct_stat_fchid_t *fchid_stats,
+        uint32_t fchid_num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,44 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+/**
+ * @file libchain_internal.h
+ * @brief Header file for internal definition of function chain control
+ */
+
+#ifndef LIBFPGA_INCLUDE_LIBFPGA_INTERNAL_LIBCHAIN_INTERNAL_H_
+#define LIBFPGA_INCLUDE_LIBFPGA_INTERNAL_LIBCHAIN_INTERNAL_H_
+
+#include <stdint.h>
+
+#include <xpcie_device.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function which read the soft table of all fchids of a lane
+ * @param[in] dev_id FPGA's device id got by fpga_dev_init()
+ * @param[in] lane Target lane, should be checked by the caller
+ * @param[out] ids Soft table of XPCIE_FUNCTION_CHAIN_MAX fchids from XPCIE_FUNCTION_CHAIN_ID_MIN
+ * @retval 0
+ *   Success
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ * @details
+ *   Reads the mapped soft table when fpga_chain_soft_table_mmap() is called,
+ *    otherwise calls XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL.
+ */
+int __fpga_chain_read_soft_table_lane(
+        uint32_t dev_id,
+        uint32_t lane,
+        fpga_ioctl_chain_ids_t *ids);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBFPGA_INCLUDE_LIBFPGA_INTERNAL_LIBCHAIN_INTERNAL_H_
@@ -14,6 +14,8 @@
 #include <rte_malloc.h>
 #include <rte_common.h>
 #include <rte_version.h>
+#include <rte_memzone.h>
+#include <rte_spinlock.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -58,6 +58,44 @@ struct fpga_card_table_elem{
 int __fpga_get_device_card_id(
         uint32_t dev_id);
 
+/**
+ * @brief Function which add a register operation for fpga_reg_rw_vec() into `ops`
+ * @param[out] ops : Array of operations
+ * @param[in,out] num : The num of operations in `ops`, counted up
+ * @param[in] op : XPCIE_DEV_REG_OP_READ32 or XPCIE_DEV_REG_OP_WRITE32
+ * @param[in] offset : Register offset from the head of device
+ * @param[in] value : Value to write, ignored by read
+ */
+static inline void __fpga_reg_vec_add_op(
+  fpga_ioctl_reg_op_t *ops,
+  uint32_t *num,
+  uint32_t op,
+  uint32_t offset,
+  uint32_t value
+) {
+  ops[*num].op = op;
+  ops[*num].offset = offset;
+  ops[*num].value = value;
+  ops[*num].mask = 0;
+  ops[*num].poll_us = 0;
+  (*num)++;
+}
+
+/**
+ * @brief Function which merge a 64bit counter read as high, low and high half by fpga_reg_rw_vec()
+ * @details
+ *   When the high halves differ, the low half wrapped around between them:
+ *    a large low half was read before the carry and a small one after it.
+ */
+static inline uint64_t __fpga_reg_vec_merge64(
+  uint32_t value_h1,
+  uint32_t value_l,
+  uint32_t value_h2
+) {
+  uint32_t value_h = (value_h1 == value_h2 || (value_l & 0x80000000)) ? value_h1 : value_h2;
+  return ((uint64_t)value_h << 32) | (uint64_t)value_l;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,9 @@
 #ifndef LIBFPGA_INCLUDE_LIBFPGA_INTERNAL_LIBSHMEM_INTERNAL_H_
 #define LIBFPGA_INCLUDE_LIBFPGA_INTERNAL_LIBSHMEM_INTERNAL_H_
 
+#include <stddef.h>
+#include <sys/types.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +43,18 @@ int *__fpga_shmem_get_available_limit(void);
  */
 int *__fpga_shmem_get_lcore_limit(void);
 
+/**
+ * @brief Get the num of regions registered into v2p map
+ */
+size_t __fpga_shmem_register_count(void);
+
+/**
+ * @brief Reap a child process, kill it by SIGKILL when it does not exit within `timeout_ms`
+ */
+void __fpga_shmem_reap_child(
+        pid_t pid,
+        int timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
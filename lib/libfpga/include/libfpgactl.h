@@ -646,6 +646,8 @@ int fpga_enable_regrw(
  *
  * @details
  *   Disable to read(),write(),pread(),pwrite() for FPGA's device file.@n
+ *   Register windows mapped by fpga_stat_mmap() are unmapped at first,
+ *    so this API should not be called while other threads call fpga_stat_read32().@n
  *   Normaly, this API will be not called.
  * @sa fpga_enable_regrw()
  */
@@ -687,6 +689,142 @@ int fpga_enable_regrw_all(void);
  */
 int fpga_disable_regrw_all(void);
 
+/**
+ * @brief API which execute register operations in order by one system call
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in,out] ops
+ *   Register operations(read values are returned in place)
+ * @param[in] num
+ *   The num of `ops`(max XPCIE_DEV_REG_VEC_MAX)
+ * @param[out] done
+ *   The num of operations executed(nullable)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value, `ops` is null, `num` is 0 or too large
+ * @retval -FAILURE_READ
+ *   XPCIE_DEV_REG_OP_POLL32 timed out, the operations after it were not executed@n
+ *    (`ops[*done].value` holds the last value read by the timed-out operation)
+ * @retval -FAILURE_IOCTL
+ *   e.g.) read/write is locked(See also fpga_enable_regrw()),
+ *    `ops` are over multiple modules' lanes
+ *
+ * @details
+ *   All `ops` should be in the same module's lane(e.g. the same lane of chain module),@n
+ *    or all be outside of any module.@n
+ *   The driver executes all `ops` in order under the lock of the lane,@n
+ *    so multi-register sequences are atomic with respect to other processes'
+ *    register accesses.@n
+ *   XPCIE_DEV_REG_OP_POLL32 waits until (register & mask) == value for `poll_us`,
+ *    and the total polling time per a call is limited by XPCIE_DEV_REG_POLL_MAX_US.@n
+ *   The lock is held while polling, so poll only for short-lived conditions
+ *    and wait longer by calling this API repeatedly.
+ */
+int fpga_reg_rw_vec(
+        uint32_t dev_id,
+        fpga_ioctl_reg_op_t *ops,
+        uint32_t num,
+        uint32_t *done);
+
+/**
+ * @brief API which map FPGA's statistics/status register windows as read-only
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @retval 0
+ *   Success(at least one window is mapped)
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value
+ * @retval -FAILURE_MMAP
+ *   No window could be mapped, e.g.) the driver does not support it
+ *
+ * @details
+ *   The register windows of chain, direct, ptu, conv and func modules are mapped
+ *    with PROT_READ, and fpga_stat_read32() reads them without any system call.@n
+ *   The driver maps only pages which consist of statistics/status registers
+ *    without side effect on read, so a window sharing a page with control registers,
+ *    fault registers or the PTU event queue is not mapped and read via the driver.@n
+ *   Read/write must be enabled by fpga_enable_regrw() to map,
+ *    and fpga_disable_regrw() unmaps the windows.@n
+ *   Registers which need a selector write(e.g. per channel byte counters) are
+ *    still read via the driver to keep select-and-read atomic.
+ * @sa fpga_stat_munmap()
+ */
+int fpga_stat_mmap(
+        uint32_t dev_id);
+
+/**
+ * @brief API which unmap FPGA's register windows mapped by fpga_stat_mmap()
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @retval 0
+ *   Success(also when not mapped)
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value
+ *
+ * @details
+ *   This API should not be called while other threads call fpga_stat_read32()
+ *    for the same device.@n
+ *   fpga_dev_finish() calls this API internally.
+ */
+int fpga_stat_munmap(
+        uint32_t dev_id);
+
+/**
+ * @brief API which read a 32bit register for statistics/status
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] offset
+ *   Register offset from the head of the device
+ * @param[out] value
+ *   pointer variable to get the register value
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value, `value` is null, `offset` is not 4byte aligned
+ * @retval -FAILURE_READ
+ *   Failed to pread(), e.g.) read/write is locked
+ *
+ * @details
+ *   Reads the mapped window when `offset` is in the window mapped by fpga_stat_mmap(),
+ *    otherwise falls back to pread().
+ */
+int fpga_stat_read32(
+        uint32_t dev_id,
+        uint32_t offset,
+        uint32_t *value);
+
+/**
+ * @brief API which read contiguous 32bit registers for statistics/status at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] offset
+ *   Register offset of the first register from the head of the device
+ * @param[in] num
+ *   The num of registers to read(1 - XPCIE_DEV_REG_VEC_MAX)
+ * @param[out] values
+ *   array of `num` elements to get the register values
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   `dev_id` is invalid value, `values` is null, `num` is out of range,
+ *    `offset` is not 4byte aligned
+ * @retval -FAILURE_IOCTL
+ *   Failed to ioctl, e.g.) read/write is locked
+ *
+ * @details
+ *   Reads the mapped window without any system call when all registers are
+ *    in the window mapped by fpga_stat_mmap(),
+ *    otherwise reads them by one fpga_reg_rw_vec() call,
+ *    i.e. in one critical section of the driver.@n
+ *   All registers should be in the same lane of a module as fpga_reg_rw_vec() requires.
+ */
+int fpga_stat_read_block(
+        uint32_t dev_id,
+        uint32_t offset,
+        uint32_t num,
+        uint32_t *values);
+
 /**
  * @brief Function which get FPGA device management information
  * @details
@@ -0,0 +1,198 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+/**
+ * @file libfpgactl_snapshot.h
+ * @brief Header file for snapshots of all statistics counters of a FPGA
+ */
+
+#ifndef LIBFPGA_INCLUDE_LIBFPGACTL_SNAPSHOT_H_
+#define LIBFPGA_INCLUDE_LIBFPGACTL_SNAPSHOT_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#include <libfpgactl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @enum FPGA_SNAPSHOT_MODULE
+ * @brief Enumeration for the module which a counter in a snapshot belongs to
+ */
+enum FPGA_SNAPSHOT_MODULE {
+  FPGA_SNAPSHOT_CHAIN = 0,        /**< Chain Control, reg_id is enum CHAIN_REG_COUNTER */
+  FPGA_SNAPSHOT_DIRECT,           /**< Direct Transfer Adapter, reg_id is enum DIRECT_REG_COUNTER */
+  FPGA_SNAPSHOT_CONV,             /**< Conversion Adapter, reg_id is enum FUNC_REG_COUNTER_CONV */
+  FPGA_SNAPSHOT_FILTER_RESIZE,    /**< Filter Resize, reg_id is enum FUNC_REG_COUNTER_FR */
+};
+
+/**
+ * @enum FPGA_SNAPSHOT_UNIT
+ * @brief Enumeration for the unit of a counter in a snapshot
+ */
+enum FPGA_SNAPSHOT_UNIT {
+  FPGA_SNAPSHOT_BYTES = 0,        /**< 64bit byte counter */
+  FPGA_SNAPSHOT_FRAMES,           /**< 32bit frame counter */
+};
+
+/**
+ * @struct fpga_snapshot_key_t
+ * @brief Struct which identifies a counter(a column) of a snapshot
+ * @var fpga_snapshot_key_t::module
+ *      enum FPGA_SNAPSHOT_MODULE
+ * @var fpga_snapshot_key_t::unit
+ *      enum FPGA_SNAPSHOT_UNIT
+ * @var fpga_snapshot_key_t::reg_id
+ *      Statistics register id of the module
+ * @var fpga_snapshot_key_t::lane
+ *      Lane of the module
+ * @var fpga_snapshot_key_t::id
+ *      cid for CHAIN_STAT_INGR_RCV0/1 and CHAIN_STAT_EGR_SND0/1 of chain, otherwise fchid
+ */
+typedef struct fpga_snapshot_key {
+  uint8_t  module;
+  uint8_t  unit;
+  uint8_t  reg_id;
+  uint8_t  lane;
+  uint16_t id;
+  uint16_t reserved;
+} fpga_snapshot_key_t;
+
+/**
+ * @struct fpga_snapshot_t
+ * @brief Struct for all counters of a FPGA stored column by column
+ * @var fpga_snapshot_t::dev_id
+ *      FPGA's device id which the counters are captured from
+ * @var fpga_snapshot_t::cid_num
+ *      The num of cids captured per lane of chain
+ * @var fpga_snapshot_t::fchid_num
+ *      The num of fchids captured per lane of each module
+ * @var fpga_snapshot_t::num
+ *      The num of counters, i.e. the num of elements of `keys`, `masks` and `values`
+ * @var fpga_snapshot_t::timestamp
+ *      CLOCK_MONOTONIC time at the middle of the latest capture
+ * @var fpga_snapshot_t::capture_ns
+ *      Time taken by the latest capture[ns]
+ * @var fpga_snapshot_t::keys
+ *      What each counter is
+ * @var fpga_snapshot_t::masks
+ *      Max value of each counter(2^width - 1), used for wrap-around
+ * @var fpga_snapshot_t::values
+ *      Value of each counter
+ */
+typedef struct fpga_snapshot {
+  uint32_t dev_id;
+  uint32_t cid_num;
+  uint32_t fchid_num;
+  uint32_t num;
+  struct timespec timestamp;
+  uint64_t capture_ns;
+  const fpga_snapshot_key_t *keys;
+  const uint64_t *masks;
+  uint64_t *values;
+} fpga_snapshot_t;
+
+
+/**
+ * @brief API which allocate a snapshot of all statistics counters of a FPGA
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] cid_num
+ *   number of cids to capture per lane of chain(0 - XPCIE_CID_MAX-XPCIE_CID_MIN+1)
+ * @param[in] fchid_num
+ *   number of fchids to capture per lane of each module(0 - XPCIE_FUNCTION_CHAIN_MAX)
+ * @param[out] snapshot
+ *   Allocated snapshot, should be released by fpga_snapshot_free()
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `dev_id` is invalid, `cid_num` and `fchid_num` are both 0
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ *
+ * @details
+ *   Decide the columns of the snapshot from the lanes of chain, direct, conv
+ *    and the lanes of function whose module_id is filter_resize.@n
+ *   Each cid/fchid from its minimum gets columns for all of its byte and frame counters,
+ *    but gauges(e.g. header buffer usage) are not included.@n
+ *   The values are 0 until fpga_snapshot_capture() is called.
+ */
+int fpga_snapshot_alloc(
+        uint32_t dev_id,
+        uint32_t cid_num,
+        uint32_t fchid_num,
+        fpga_snapshot_t **snapshot);
+
+/**
+ * @brief API which release a snapshot allocated by fpga_snapshot_alloc()
+ * @param[in] snapshot
+ *   Target snapshot, do nothing when NULL
+ */
+void fpga_snapshot_free(
+        fpga_snapshot_t *snapshot);
+
+/**
+ * @brief API which capture all counters of the FPGA into a snapshot
+ * @param[in,out] snapshot
+ *   Target snapshot
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `snapshot` is NULL, the device of `snapshot` is already finished
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ *
+ * @details
+ *   Read the counters with as few system calls as possible:@n
+ *   one fpga_chain_get_stat_all() and one fpga_direct_get_stat_all() per lane,
+ *    and fpga_conv_get_stat_all()/fpga_filter_resize_get_stat_all()
+ *    which read many fchids per fpga_reg_rw_vec().@n
+ *   Each cid/fchid is read consistently, but different ones may be read at slightly different timing,
+ *    so `timestamp` is the middle of the capture and `capture_ns` is its width.@n
+ *   When this API fails, `values` may be partially updated and `timestamp` is not updated.
+ */
+int fpga_snapshot_capture(
+        fpga_snapshot_t *snapshot);
+
+/**
+ * @brief API which compute deltas and rates of all counters between two snapshots
+ * @param[in] prev
+ *   Snapshot captured earlier
+ * @param[in] cur
+ *   Snapshot captured later, allocated with the same parameters as `prev`
+ * @param[out] deltas
+ *   Increase of each counter, array of `cur->num` elements(may be NULL)
+ * @param[out] rates
+ *   Increase of each counter per second, array of `cur->num` elements(may be NULL)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `prev` and `cur` have different columns, `deltas` and `rates` are both NULL,
+ *         `cur` is not newer than `prev` with `rates`
+ *
+ * @details
+ *   A counter which wrapped around between the snapshots is handled by its width in `masks`.@n
+ *   The computation is plain loops over the columns without branches,
+ *    so the compiler can vectorize them.
+ */
+int fpga_snapshot_rate(
+        const fpga_snapshot_t *prev,
+        const fpga_snapshot_t *cur,
+        uint64_t *deltas,
+        double *rates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBFPGA_INCLUDE_LIBFPGACTL_SNAPSHOT_H_
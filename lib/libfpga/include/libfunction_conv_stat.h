@@ -31,6 +31,15 @@ enum FUNC_REG_COUNTER_CONV {
   /* If statistics register is added, it is added after.*/
 };
 
+/**
+ * @struct fpga_conv_stat_fchid_t
+ * @brief Struct for all Conversion Adapter counters of a fchid
+ */
+typedef struct fpga_conv_stat_fchid {
+  uint64_t bytes[CONV_STAT_EGR_SND + 1];   /**< Indexed by enum FUNC_REG_COUNTER_CONV */
+  uint32_t frames[CONV_STAT_EGR_SND + 1];  /**< Indexed by enum FUNC_REG_COUNTER_CONV */
+} fpga_conv_stat_fchid_t;
+
 
 /**
  * @brief API which get Conversion Adapter statistics (bytes)
@@ -173,6 +182,36 @@ int fpga_conv_get_stat_buff_usage(
         uint32_t fchid,
         uint32_t *usage_num);
 
+/**
+ * @brief API which get all Conversion Adapter statistics of a lane at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] lane
+ *   Target lane of FPGA's module
+ * @param[out] fchid_stats
+ *   statistics of each fchid from XPCIE_FUNCTION_CHAIN_ID_MIN, array of `fchid_num` elements
+ * @param[in] fchid_num
+ *   number of fchids to get(1 - XPCIE_FUNCTION_CHAIN_MAX)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `dev_id` is invalid, `lane` is too large, `fchid_num` is 0
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ *
+ * @details
+ *   Select each fchid and read all its bytes and frames by fpga_reg_rw_vec(),
+ *    packing as many fchids into one call as XPCIE_DEV_REG_VEC_MAX allows.@n
+ *   A 64bit counter is read as high, low and high half,
+ *    so a carry into the high half between the reads is never lost.
+ */
+int fpga_conv_get_stat_all(
+        uint32_t dev_id,
+        uint32_t lane,
+        fpga_conv_stat_fchid_t *fchid_stats,
+        uint32_t fchid_num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,15 @@ enum FUNC_REG_COUNTER_FR {
   /* If statistics register is added, it is added after.*/
 };
 
+/**
+ * @struct fpga_filter_resize_stat_fchid_t
+ * @brief Struct for all Filter Resize counters of a fchid
+ */
+typedef struct fpga_filter_resize_stat_fchid {
+  uint64_t bytes[FR_STAT_EGR_SND1 + 1];   /**< Indexed by enum FUNC_REG_COUNTER_FR */
+  uint32_t frames[FR_STAT_EGR_SND1 + 1];  /**< Indexed by enum FUNC_REG_COUNTER_FR */
+} fpga_filter_resize_stat_fchid_t;
+
 
 /**
  * @brief API which get Filter Resize function statistics (bytes)
@@ -94,6 +103,36 @@ int fpga_filter_resize_get_stat_frames(
         uint32_t reg_id,
         uint32_t *frame_num);
 
+/**
+ * @brief API which get all Filter Resize statistics of a lane at once
+ * @param[in] dev_id
+ *   FPGA's device id got by fpga_dev_init()
+ * @param[in] lane
+ *   Target lane of FPGA's module
+ * @param[out] fchid_stats
+ *   statistics of each fchid from XPCIE_FUNCTION_CHAIN_ID_MIN, array of `fchid_num` elements
+ * @param[in] fchid_num
+ *   number of fchids to get(1 - XPCIE_FUNCTION_CHAIN_MAX)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   Bad argument@n
+ *   e.g.) `dev_id` is invalid, `lane` is too large, `fchid_num` is 0
+ * @retval -FAILURE_IOCTL
+ *   ioctl failure
+ *
+ * @details
+ *   Select each fchid and read all its bytes and frames by fpga_reg_rw_vec(),
+ *    packing as many fchids into one call as XPCIE_DEV_REG_VEC_MAX allows.@n
+ *   A 64bit counter is read as high, low and high half,
+ *    so a carry into the high half between the reads is never lost.
+ */
+int fpga_filter_resize_get_stat_all(
+        uint32_t dev_id,
+        uint32_t lane,
+        fpga_filter_resize_stat_fchid_t *fchid_stats,
+        uint32_t fchid_num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,8 @@
 #ifndef LIBFPGA_INCLUDE_LIBLOGGING_H_
 #define LIBFPGA_INCLUDE_LIBLOGGING_H_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -110,30 +112,60 @@ extern "C" {
 #endif  // FPGA_LOGGER_LIBNAME
 
 
+/**
+ * Macro for the most verbose loglevel compiled into llf_***()@n
+ * llf_***() more verbose than this level are removed at compile time
+ *  and their arguments are never evaluated.
+ *  (e.g. `-DLIBFPGA_LOG_COMPILE_LEVEL=LIBFPGA_LOG_INFO` removes llf_dbg())
+ */
+#ifndef LIBFPGA_LOG_COMPILE_LEVEL
+#define LIBFPGA_LOG_COMPILE_LEVEL     LIBFPGA_LOG_ALL
+#endif  // LIBFPGA_LOG_COMPILE_LEVEL
+
+/**
+ * Macro to check if the loglevel is printed@n
+ * Checked inline before evaluating any arguments of llf_***().
+ */
+#define LIBFPGA_LOG_ENABLED(level)  \
+  ((level) <= LIBFPGA_LOG_COMPILE_LEVEL && __builtin_expect((level) <= libfpga_glevel, 0))
+
+/**
+ * LogLibFpga: common part of llf_***()
+ */
+#define __llf_log(level, fmt, arg...) \
+  do { if (LIBFPGA_LOG_ENABLED(level)) log_libfpga(level, fmt, ##arg); } while (0)
+
 /**
  * LogLibFpga: error level
  */
-#define llf_err(err, fmt, arg...)   log_libfpga(LIBFPGA_LOG_ERROR, FPGA_LOGGER_LIBNAME "[%d]" fmt, -err, ##arg)
+#define llf_err(err, fmt, arg...)   __llf_log(LIBFPGA_LOG_ERROR, FPGA_LOGGER_LIBNAME "[%d]" fmt, -err, ##arg)
 
 /**
  * LogLibFpga: warn level
  */
-#define llf_warn(err, fmt, arg...)  log_libfpga(LIBFPGA_LOG_WARN,  FPGA_LOGGER_LIBNAME "[%d]" fmt, -err, ##arg)
+#define llf_warn(err, fmt, arg...)  __llf_log(LIBFPGA_LOG_WARN,  FPGA_LOGGER_LIBNAME "[%d]" fmt, -err, ##arg)
 
 /**
  * LogLibFpga: info level
  */
-#define llf_info(fmt, arg...)       log_libfpga(LIBFPGA_LOG_INFO,  FPGA_LOGGER_LIBNAME fmt, ##arg)
+#define llf_info(fmt, arg...)       __llf_log(LIBFPGA_LOG_INFO,  FPGA_LOGGER_LIBNAME fmt, ##arg)
 
 /**
  * LogLibFpga: debug level
  */
-#define llf_dbg(fmt, arg...)        log_libfpga(LIBFPGA_LOG_DEBUG, FPGA_LOGGER_LIBNAME fmt, ##arg)
+#define llf_dbg(fmt, arg...)        __llf_log(LIBFPGA_LOG_DEBUG, FPGA_LOGGER_LIBNAME fmt, ##arg)
 
 /**
  * LogLibFpga: print level
  */
-#define llf_pr(fmt, arg...)         log_libfpga(LIBFPGA_LOG_PRINT, "        " FPGA_LOGGER_LIBNAME fmt, ##arg)
+#define llf_pr(fmt, arg...)         __llf_log(LIBFPGA_LOG_PRINT, "        " FPGA_LOGGER_LIBNAME fmt, ##arg)
+
+
+/**
+ * global variable: libfpga's output loglevel
+ *                  (Normaly user will not use this variable, use libfpga_log_set_level())
+ */
+extern int libfpga_glevel;
 
 
 /**
@@ -226,6 +258,51 @@ void libfpga_log_quit_timestamp(void);
  */
 int libfpga_log_get_timestamp(void);
 
+/**
+ * @brief API which enable async mode
+ * @param void
+ * @retval 0 : success
+ * @retval -ALREADY_INITIALIZED : async mode is already enabled
+ * @retval -FAILURE_INITIALIZE : Failed to create the logger thread
+ *
+ * @details
+ *   In async mode, each thread formats its logs into its own lock-free ring buffer
+ *    and a background logger thread writes them into the log output in batches,
+ *    so printing log never blocks the caller.@n
+ *   When the ring buffer is full, the log is dropped and counted,
+ *    see libfpga_log_get_dropped().@n
+ *   A log longer than 255 characters is truncated.@n
+ *   The forked child process prints logs synchronously, because the logger thread is not inherited.
+ */
+int libfpga_log_set_async(void);
+
+/**
+ * @brief API which disable async mode
+ * @param void
+ * @return void
+ *
+ * @details
+ *   Stop the logger thread after writing all logs recorded in ring buffers.@n
+ *   Logs are printed synchronously after this API.@n
+ *   Defalut status.
+ */
+void libfpga_log_quit_async(void);
+
+/**
+ * @brief API which get async mode's status
+ * @param void
+ * @retval true(non-zero) : enabled
+ * @retval false(zero) : disabled
+ */
+int libfpga_log_get_async(void);
+
+/**
+ * @brief API which get the num of logs dropped in async mode
+ * @param void
+ * @return total num of dropped logs
+ */
+uint64_t libfpga_log_get_dropped(void);
+
 /**
  * @brief API which parse logger options
  * @param[in] argc : cmdline's argc
@@ -234,13 +311,14 @@ int libfpga_log_get_timestamp(void);
  * @retval -INVALID_ARGUMENT : Invalid option
  *
  * @details
- *   usage: `<APP> [-ptsf] [-l <level>]@n
+ *   usage: `<APP> [-ptsfa] [-l <level>]@n
  *   options :
  *   @li -l, --lib-loglevel      : set logLevel
  *   @li -p, --set-timestamp     : enable timestamP
  *   @li -t, --quit-timestamp    : disable Timestamp
  *   @li -s, --set-output-stdout : output:only Stdout(not create file)
  *   @li -f, --set-output-file   : output:logFile(create file)
+ *   @li -a, --set-async         : print log by the logger thread(Async mode)
  */
 int libfpga_log_parse_args(
         int argc,
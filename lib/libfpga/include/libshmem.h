@@ -89,6 +89,107 @@ extern "C" {
  */
 #define SHMEM_FMT_NUMA_NODE_CPULIST       "/sys/devices/system/node/node%d/cpulist"
 
+/**
+ * Magic number to identify a token created by fpga_shmem_export_token()
+ */
+#define SHMEM_TOKEN_MAGIC                 0x4b4f5453  /* "STOK" */
+
+/**
+ * Num of size classes for allocation statistics(4KiB, 8KiB, ..., 64MiB, over 64MiB)
+ */
+#define SHMEM_STATS_SIZE_CLASS_NUM        16
+
+/**
+ * Upper bound size of the smallest size class for allocation statistics
+ */
+#define SHMEM_STATS_SIZE_CLASS_MIN        SHMEM_MIN_SIZE_BUF
+
+
+/**
+ * @struct fpga_shmem_token_t
+ * @brief Struct of token to share a buffer on Hugepage with other processes
+ * @var fpga_shmem_token_t::magic
+ *      Magic number(SHMEM_TOKEN_MAGIC)
+ * @var fpga_shmem_token_t::file_prefix
+ *      DPDK's file_prefix of the process which exported the buffer
+ * @var fpga_shmem_token_t::msl_idx
+ *      Index of the memseg list which the buffer belongs to
+ * @var fpga_shmem_token_t::ms_idx
+ *      Index of the memseg in the memseg list
+ * @var fpga_shmem_token_t::offset
+ *      Offset of the buffer from the head of the memseg
+ * @var fpga_shmem_token_t::length
+ *      Length of the buffer
+ */
+typedef struct fpga_shmem_token {
+  uint32_t magic;
+  char file_prefix[SHMEM_MAX_HUGEPAGE_PREFIX];
+  int32_t msl_idx;
+  int32_t ms_idx;
+  uint64_t offset;
+  uint64_t length;
+} fpga_shmem_token_t;
+
+/**
+ * @struct fpga_shmem_socket_stats_t
+ * @brief Struct of DPDK malloc heap statistics of a socket
+ * @var fpga_shmem_socket_stats_t::heap_total_bytes
+ *      Total bytes of the heap
+ * @var fpga_shmem_socket_stats_t::heap_free_bytes
+ *      Free bytes of the heap
+ * @var fpga_shmem_socket_stats_t::heap_alloc_bytes
+ *      Allocated bytes of the heap
+ * @var fpga_shmem_socket_stats_t::greatest_free_bytes
+ *      Bytes of the largest contiguous free block of the heap
+ * @var fpga_shmem_socket_stats_t::free_count
+ *      Num of free blocks of the heap
+ * @var fpga_shmem_socket_stats_t::alloc_count
+ *      Num of allocated blocks of the heap
+ */
+typedef struct fpga_shmem_socket_stats {
+  uint64_t heap_total_bytes;
+  uint64_t heap_free_bytes;
+  uint64_t heap_alloc_bytes;
+  uint64_t greatest_free_bytes;
+  uint32_t free_count;
+  uint32_t alloc_count;
+} fpga_shmem_socket_stats_t;
+
+/**
+ * @struct fpga_shmem_stats_t
+ * @brief Struct of Hugepage memory statistics of a file_prefix
+ * @var fpga_shmem_stats_t::file_prefix
+ *      DPDK's file_prefix of this process
+ * @var fpga_shmem_stats_t::socket_num
+ *      Num of valid elements in socket
+ * @var fpga_shmem_stats_t::socket
+ *      DPDK malloc heap statistics per socket(shared by all processes of the file_prefix)
+ * @var fpga_shmem_stats_t::alloc_bytes
+ *      Bytes allocated through fpga_shmem_alloc(), fpga_shmem_aligned_alloc()
+ *      by all processes of the file_prefix
+ * @var fpga_shmem_stats_t::peak_alloc_bytes
+ *      Peak of alloc_bytes
+ * @var fpga_shmem_stats_t::alloc_count
+ *      Num of buffers allocated by all processes of the file_prefix per size class,
+ *      alloc_count[i] counts buffers of (SHMEM_STATS_SIZE_CLASS_MIN << (i-1), SHMEM_STATS_SIZE_CLASS_MIN << i] bytes,
+ *      the last element counts all larger buffers
+ * @var fpga_shmem_stats_t::alloc_dropped
+ *      Num of buffers not counted in alloc_bytes and alloc_count,
+ *      because too many buffers were alive to record them(non-zero means the statistics are underestimated)
+ * @var fpga_shmem_stats_t::region_num
+ *      Num of regions registered into the v2p map of this process
+ */
+typedef struct fpga_shmem_stats {
+  char file_prefix[SHMEM_MAX_HUGEPAGE_PREFIX];
+  int socket_num;
+  fpga_shmem_socket_stats_t socket[SHMEM_MAX_NUMA_NODE];
+  uint64_t alloc_bytes;
+  uint64_t peak_alloc_bytes;
+  uint64_t alloc_count[SHMEM_STATS_SIZE_CLASS_NUM];
+  uint64_t alloc_dropped;
+  uint64_t region_num;
+} fpga_shmem_stats_t;
+
 
 /**
  * @brief API which initialize DPDK as secondary process
@@ -237,6 +338,100 @@ int fpga_shmem_register(
         uint64_t paddr,
         size_t size);
 
+/**
+ * @brief API which export a buffer on Hugepage as a token
+ * @param[in] addr
+ *   Head address of the buffer allocated by fpga_shmem_alloc(), fpga_shmem_aligned_alloc()
+ * @param[in] length
+ *   Length of the buffer
+ * @param[out] token
+ *   pointer variable to get the token
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `addr` is null, `token` is null, `length` is 0
+ * @retval -NOT_INITIALIZED
+ *   e.g.) fpga_shmem_init() or fpga_shmem_init_sys() is not called yet
+ * @retval -INVALID_ADDRESS
+ *   e.g.) `addr` is not on Hugepage, the buffer is over a hugepage
+ *
+ * @details
+ *   Create a token which identifies the buffer by its file_prefix, memseg and offset.@n
+ *   The token is a plain data, so it can be sent to other processes by any IPC(socket, pipe, ...).@n
+ *   The process which received the token can use the same buffer without copying
+ *    by fpga_shmem_register_by_token().@n
+ *   The exporter keeps the ownership of the buffer,
+ *    so please do NOT call fpga_shmem_free() for the buffer while other processes use it.
+ */
+int fpga_shmem_export_token(
+        void *addr,
+        size_t length,
+        fpga_shmem_token_t *token);
+
+/**
+ * @brief API which map a buffer exported by other process and register it
+ * @param[in] token
+ *   Token created by fpga_shmem_export_token()
+ * @param[in] token_len
+ *   Size of `token`(should be sizeof(fpga_shmem_token_t))
+ * @param[in] length
+ *   Length to use from the head of the buffer(if 0, the length in the token)
+ * @param[out] addr
+ *   pointer variable to get the address of the buffer in this process
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `token` is null, `addr` is null, `token_len` is invalid
+ * @retval -INVALID_DATA
+ *   e.g.) magic of the token is invalid, `length` is larger than the buffer
+ * @retval -NOT_INITIALIZED
+ *   e.g.) fpga_shmem_init() or fpga_shmem_init_sys() is not called yet
+ * @retval -MISMATCH_FILE_PREFIX
+ *   e.g.) file_prefix of the token is different from this process's file_prefix
+ * @retval -INVALID_ADDRESS
+ *   e.g.) memseg of the token is not found
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   e.g.) Failed to register the buffer into v2p map
+ *
+ * @details
+ *   Resolve the buffer from the memseg list/memseg/offset in the token
+ *    and register it into the local v2p map, so the buffer can be used for DMA
+ *    in this process without copying.@n
+ *   This process should be initialized by fpga_shmem_init() with the same file_prefix
+ *    as the exporter(i.e. as DPDK secondary process of the same shmem manager).@n
+ *   When the buffer is no longer used, call fpga_shmem_unregister() with `*addr`.
+ */
+int fpga_shmem_register_by_token(
+        const void *token,
+        size_t token_len,
+        size_t length,
+        void **addr);
+
+/**
+ * @brief API which get Hugepage memory statistics of this process's file_prefix
+ * @param[out] stats
+ *   pointer variable to get the statistics
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `stats` is null
+ * @retval -NOT_INITIALIZED
+ *   e.g.) fpga_shmem_init() or fpga_shmem_init_sys() is not called yet
+ *
+ * @details
+ *   Heap statistics per socket come from DPDK malloc heap, which is shared by
+ *    the shmem manager and all secondary processes of the same file_prefix.@n
+ *   Allocation statistics are kept in a memzone reserved by the shmem manager,
+ *    so they count buffers of all processes of the file_prefix
+ *    until they are released by fpga_shmem_free().@n
+ *   They are 0 when the memzone is not available(e.g. the shmem manager is an older version).@n
+ *   The num of v2p regions is counted in this process.@n
+ *   When greatest_free_bytes is much smaller than heap_free_bytes, the heap is fragmented
+ *    and a large buffer may fail to be allocated in a hugepage.
+ */
+int fpga_shmem_get_stats(
+        fpga_shmem_stats_t *stats);
+
 /**
  * @brief Function which update registerd data
  */
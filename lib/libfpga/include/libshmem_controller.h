@@ -33,6 +33,12 @@ extern "C" {
  */
 #define SHMEM_CONTROLLER_PORT_NOTICE  (SHMEM_CONTROLLER_PORT+1)
 
+/**
+ * shmem_controller's recommended Unix domain socket path
+ *  (used only when set by fpga_shmem_controller_set_unix_path())
+ */
+#define SHMEM_CONTROLLER_UNIX_PATH    "/var/run/libfpga_shmem_controller.sock"
+
 
 /**
  * @brief API which launch shmem_controller
@@ -49,7 +55,10 @@ extern "C" {
  *
  * @details
  *   Execute shmem_controller tasks.@n
- *   Open TCP port and wait for receiving requests to create/delete shmem_manager(s).@n
+ *   Open TCP port(or Unix domain socket set by fpga_shmem_controller_set_unix_path())
+ *    and wait for receiving requests to create/delete shmem_manager(s).@n
+ *   Up to 16 requesters can keep connections at once, and requests on each connection
+ *    are handled in the order of arrival.@n
  *   This API execute inf loop for the tasks, and exit the loop when fpga_shmem_controller_finish() is called.@n
  *   Request APIs are belows.
  * @sa fpga_shmem_enable
@@ -75,10 +84,13 @@ int fpga_shmem_controller_launch(
  * @retval -FAILURE_FORK
  *   Failed fork()
  * @retval -FAILURE_ESTABLISH
- *   Failed pthread_create()
+ *   e.g.) shmem_controller did not become ready, Failed pthread_create()
  *
  * @details
  *   Fork process and execute shmem_controller tasks in background.@n
+ *   This API returns as soon as shmem_controller notifies through a pipe that it starts listening
+ *    (waits for 10 seconds at most).
+ *    When it exits or times out instead, it is terminated and reaped.@n
  *   The parent process(launcher) will create a thread to get a file_prefix of shmem_manager
  *    which secondary process with the same file_prefix has been dead in error with.@n
  *   Please call fpga_shmem_controller_finish() to finish the thread created by parent process.@n
@@ -311,6 +323,58 @@ int fpga_shmem_check_inuse(
         const char *file_prefix,
         uint32_t *is_inuse);
 
+/**
+ * @brief API which request controller to get Process IDs of some managers at once
+ * @param[in] file_prefix
+ *   Array of DPDK's file prefix
+ * @param[in] num
+ *   Num of elements of `file_prefix` and `pid`
+ * @param[out] pid
+ *   Array to get PID of each manager
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `file_prefix` is null, `pid` is NULL, `num` is 0
+ * @retval -FAILURE_ESTABLISH
+ *   e.g.) There is no process which execute fpga_shmem_controller_launch()
+ * @retval -FAILURE_TRANSFER
+ *   e.g.) Failed send()/recv()
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ * @retval -FAILURE_CONTROLLER
+ *   e.g.) shmem_controller failed to get pid of one of shmem_managers
+ *
+ * @details
+ *   Same as fpga_shmem_get_manager_pid() for each `file_prefix[i]`,
+ *    but all requests are pipelined on the connection with shmem_controller,
+ *    so this API costs one round trip for `num` shmem_managers.@n
+ *   The value of `pid[i]` is undefined when this API fails.
+ */
+int fpga_shmem_get_manager_pid_multi(
+        const char *file_prefix[],
+        int num,
+        pid_t pid[]);
+
+/**
+ * @brief API which request controller to check if some shmem_managers are inuse at once
+ * @param[in] file_prefix
+ *   Array of DPDK's file prefix
+ * @param[in] num
+ *   Num of elements of `file_prefix` and `is_inuse`
+ * @param[out] is_inuse
+ *   Array to get the result of each shmem_manager(See fpga_shmem_check_inuse())
+ * @return
+ *   @sa fpga_shmem_get_manager_pid_multi
+ *
+ * @details
+ *   Same as fpga_shmem_check_inuse() for each `file_prefix[i]` in one round trip.@n
+ *   The value of `is_inuse[i]` is undefined when this API fails.
+ */
+int fpga_shmem_check_inuse_multi(
+        const char *file_prefix[],
+        int num,
+        uint32_t is_inuse[]);
+
 /**
  * @brief API which request controller to finish all managers and controller
  * @param void
@@ -491,6 +555,44 @@ int fpga_shmem_controller_get_ip(
         unsigned short *port,
         char **addr);
 
+/**
+ * @brief API which set Unix domain socket path which shmem_controller listen
+ * @param[in] path
+ *   Unix domain socket path(if NULL or "", use TCP)
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `path` is too long
+ *
+ * @details
+ *   Switch the transport between shmem_controller and requesters from TCP to Unix domain socket.@n
+ *   Both of the process which launches shmem_controller and the processes which request
+ *    (fpga_shmem_enable(),...) should call this API with the same `path` before using shmem_controller.@n
+ *   SHMEM_CONTROLLER_UNIX_PATH is recommended as `path`.@n
+ *   Regardless of the transport, the connection with shmem_controller is kept by each requester
+ *    and requests are sent as fixed-size frames, so this API only removes TCP's overhead.
+ */
+int fpga_shmem_controller_set_unix_path(
+        const char *path);
+
+/**
+ * @brief API which get Unix domain socket path which shmem_controller listen
+ * @param[out] path
+ *   pointer variable to get Unix domain socket path
+ * @retval 0
+ *   Success
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `path` is null
+ * @retval -FAILURE_MEMORY_ALLOC
+ *   Failed to allocate memory
+ *
+ * @details
+ *   `*path` will be allocated by this API, so please explicitly free `*path` by free().@n
+ *   When shmem_controller uses TCP, `*path` will be NULL.
+ */
+int fpga_shmem_controller_get_unix_path(
+        char **path);
+
 /**
  * @brief API which set IP address/port which launcher TCP listen
  * @param[in] port
@@ -54,6 +54,31 @@ typedef struct fpga_shmem_manager_info {
   char file_prefix[SHMEM_MAX_HUGEPAGE_PREFIX];
 }fpga_shmem_manager_info_t;
 
+/**
+ * @struct fpga_shmem_manager_param_t
+ * @brief Struct of a request for fpga_shmem_manager_init_batch()
+ * @var fpga_shmem_manager_param_t::file_prefix
+ *      [in] DPDK's file_prefix
+ * @var fpga_shmem_manager_param_t::socket_limit
+ *      [in] Request Hugepage size(GB) per a socket
+ * @var fpga_shmem_manager_param_t::lcore_mask
+ *      [in] Request logic cpu core
+ * @var fpga_shmem_manager_param_t::clb
+ *      [in] Callback function for detecting secondary process finish
+ * @var fpga_shmem_manager_param_t::arg
+ *      [in] Argument for call back function
+ * @var fpga_shmem_manager_param_t::result
+ *      [out] The same value as the retval of fpga_shmem_manager_init()
+ */
+typedef struct fpga_shmem_manager_param {
+  const char *file_prefix;
+  const uint32_t *socket_limit;
+  const bool *lcore_mask;
+  shmem_func clb;
+  void *arg;
+  int result;
+}fpga_shmem_manager_param_t;
+
 
 /**
  * @brief API which register signal for finish shmem manager safely
@@ -94,20 +119,26 @@ int fpga_shmem_set_signal(void);
  *   e.g.) Failed to mkdir()
  * @retval -FAILURE_FORK
  *   e.g.) Failed to fork()
+ * @retval -FULL_ELEMENT
+ *   e.g.) List for management is full
+ * @retval -FAILURE_INITIALIZE
+ *   e.g.) Failed to initialize DPDK at the child process
  * @retval -INVALID_ARGUMENT
  *   e.g.) The same `file_prefix` exist, `socket_limit` is over avaliable pages
  *
  * @details
  *   Fork process and initialize DPDK at the child process(i.e. background).@n
  *   The parent (own) process judges whether the DPDK initialization
- *    in the child process has started successfully, If successful,
- *    it registers child process's info as managed data and returns to
- *    the caller of the function.@n
+ *    in the child process has started successfully by the status notified
+ *    through a pipe, If successful, it registers child process's info
+ *    as managed data and returns to the caller of the function.@n
+ *   The exit of the child process is detected through its pidfd,
+ *    see fpga_shmem_manager_get_event_fd().@n
  *   For normal termination of the child process,
  *    fpga_shmem_manager_finish() should be called.@n
  *   The child process executes the callback function in 500ms cycles
- *    to check whether the signal has been notified,
- *    after DPDK initialization and notification of the result to the parent process.@n
+ *    after DPDK initialization and notification of the result to the parent process.
+ *    The signal is received through signalfd and wakes up the child process immediately.@n
  *   When the callback function returns a non-zero value or a signal is notified,
  *    the DPDK is finalized and the child process is terminated.@n
  *   If the callback function requires an argument, pass it as a generic pointer(arg).@n
@@ -120,6 +151,32 @@ int fpga_shmem_manager_init(
         const shmem_func clb,
         void *arg);
 
+/**
+ * @brief API which launch multiple shmem_managers concurrently
+ * @param[in,out] params
+ *   Requests for each shmem manager, the result is set into params[i].result
+ * @param[in] num
+ *   Num of requests(1 ~ SHMEM_MAX_HUGEPAGES)
+ * @retval 0
+ *   Success to launch all shmem managers
+ * @retval -INVALID_ARGUMENT
+ *   e.g.) `params` is null, `num` is out of range
+ * @retval -FAILURE_INITIALIZE
+ *   e.g.) Failed to launch some of shmem managers, check params[i].result
+ *
+ * @details
+ *   Equivalent to calling fpga_shmem_manager_init() for each request in order,
+ *    except that all child processes are forked before waiting for any of them,
+ *    so DPDK initializations run in parallel.@n
+ *   Requests are checked in order including the preceding requests in `params`,
+ *    i.e. the same `file_prefix` in `params` and the sum of `socket_limit` over
+ *    available pages are rejected by -INVALID_ARGUMENT.@n
+ *   Rejected or failed requests do not affect the other requests.
+ */
+int fpga_shmem_manager_init_batch(
+        fpga_shmem_manager_param_t params[],
+        int num);
+
 /**
  * @brief API which finish shmem manager
  * @param[in] file_prefix
@@ -159,6 +216,22 @@ int fpga_shmem_manager_finish(
  */
 int fpga_shmem_manager_finish_all(void);
 
+/**
+ * @brief API which get fd to wait for the exit of shmem managers
+ * @param void
+ * @retval (>=0)
+ *   epoll fd which becomes readable when any shmem manager exits
+ * @retval -FAILURE_INITIALIZE
+ *   e.g.) Failed to epoll_create1()
+ *
+ * @details
+ *   The fd can be used by poll()/epoll in the caller's event loop.
+ *   When it becomes readable, call fpga_shmem_get_available_pages() or
+ *    fpga_shmem_get_pid_from_prefix() to update the management data.@n
+ *   The fd is owned by this library, so the caller must not close it.
+ */
+int fpga_shmem_manager_get_event_fd(void);
+
 
 /**
  * @brief Function which print management data or copy to arg
@@ -52,6 +52,44 @@ int fpga_shmem_get_fd_client(
         unsigned short port,
         const char *addr);
 
+/**
+ * @brief Function which bind and listen at addr:port without accepting
+ */
+int fpga_shmem_get_fd_listen(
+        unsigned short port,
+        const char *addr);
+
+/**
+ * @brief Function which bind and listen at Unix domain socket path without accepting
+ */
+int fpga_shmem_get_fd_listen_unix(
+        const char *path);
+
+/**
+ * @brief Function which connect to Unix domain socket path
+ */
+int fpga_shmem_get_fd_client_unix(
+        const char *path);
+
+/**
+ * @brief Function which send a fixed-size frame
+ * @retval 0 Success
+ * @retval -1 Failed before sending any byte of the frame
+ * @retval 1 Failed after sending a part of the frame
+ */
+int fpga_shmem_send_frame(
+        int fd,
+        const void *frame,
+        size_t len);
+
+/**
+ * @brief Function which recv a fixed-size frame into caller's buffer
+ */
+int fpga_shmem_recv_frame(
+        int fd,
+        void *frame,
+        size_t len);
+
 /**
  * @brief Function which send data
  */
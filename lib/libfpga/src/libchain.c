@@ -7,12 +7,17 @@
 #include <libchain.h>
 #include <liblogging.h>
 
+#include <libfpga_internal/libchain_internal.h>
 #include <libfpga_internal/libfpgautil.h>
 #include <libfpga_internal/libfpgacommon_internal.h>
 
 #include <errno.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 
 
 // LogLibFpga
@@ -398,6 +403,121 @@ invalid_arg:
 }
 
 
+/**
+ * @brief Function which convert status of XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH into retval
+ */
+static int __fpga_chain_batch_status(
+  int32_t status
+) {
+  if (status == 0)
+    return 0;
+  else if (status == -XPCIE_DEV_UPDATE_TIMEOUT)
+    return -TABLE_UPDATE_TIMEOUT;
+  else
+    return -FAILURE_IOCTL;  // same as __fpga_chain_connect()
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_chain_connect_batch(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_chain_conn_t *conns,
+  uint32_t num
+) {
+  fpga_ioctl_chain_batch_entry_t *entries;
+  fpga_ioctl_chain_batch_t ioctl_batch;
+  uint32_t head, failed = 0;
+  // ingress and egress of a connection are always in the same ioctl
+  const uint32_t conn_max = XPCIE_DEV_CHAIN_BATCH_MAX / FPGA_CID_KIND_MAX;
+
+  // Check input
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || (lane >= KERNEL_NUM_CHAIN(dev)) || !conns || num == 0) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u), lane(%u), conns(%#lx), num(%u))\n",
+      __func__, dev_id, lane, (uintptr_t)conns, num);
+    return -INVALID_ARGUMENT;
+  }
+
+  llf_dbg("%s(dev_id(%u), lane(%u), num(%u))\n", __func__, dev_id, lane, num);
+
+  entries = (fpga_ioctl_chain_batch_entry_t*)malloc(  // NOLINT
+    sizeof(fpga_ioctl_chain_batch_entry_t) * FPGA_CID_KIND_MAX * (num < conn_max ? num : conn_max));
+  if (!entries) {
+    llf_err(FAILURE_MEMORY_ALLOC, "%s: Failed to allocate memory\n", __func__);
+    return -FAILURE_MEMORY_ALLOC;
+  }
+
+  for (head = 0; head < num;) {
+    uint32_t tail, entry_num = 0;
+
+    // Pack valid connections into entries, ingress and egress for each
+    for (tail = head; tail < num && entry_num < conn_max * FPGA_CID_KIND_MAX; tail++) {
+      fpga_chain_conn_t *conn = &conns[tail];
+      if (!IS_VALID_FUNCTION_CHAIN_ID(conn->fchid)
+        || conn->ingress_extif_id > FPGA_EXTIF_NUMBER_1 || conn->egress_extif_id > FPGA_EXTIF_NUMBER_1
+        || conn->ingress_cid < CID_MIN || conn->ingress_cid > CID_MAX
+        || conn->egress_cid < CID_MIN || conn->egress_cid > CID_MAX
+        || conn->ingress_active_flag > 0x1 || conn->egress_active_flag > 0x1 || conn->direct_flag > 0x1
+        || conn->egress_virtual_flag > 0x1 || conn->egress_blocking_flag > 0x1) {
+        llf_err(INVALID_ARGUMENT, "%s(conns[%u]: fchid(%u), ingress_extif_id(%u), ingress_cid(%u), egress_extif_id(%u), egress_cid(%u))\n",
+          __func__, tail, conn->fchid, conn->ingress_extif_id, conn->ingress_cid,
+          conn->egress_extif_id, conn->egress_cid);
+        conn->result = -INVALID_ARGUMENT;
+        continue;
+      }
+      conn->result = 0;
+      // enable_flag is always 1
+      __fpga_set_id_info(&entries[entry_num].id, lane, conn->fchid, conn->ingress_extif_id, conn->ingress_cid,
+        1, conn->ingress_active_flag, conn->direct_flag, 0, 0);
+      entries[entry_num++].kind = FPGA_CID_KIND_INGRESS;
+      __fpga_set_id_info(&entries[entry_num].id, lane, conn->fchid, conn->egress_extif_id, conn->egress_cid,
+        1, conn->egress_active_flag, 0, conn->egress_virtual_flag, conn->egress_blocking_flag);
+      entries[entry_num++].kind = FPGA_CID_KIND_EGRESS;
+    }
+
+    if (entry_num) {
+      ioctl_batch.lane    = lane;
+      ioctl_batch.num     = entry_num;
+      ioctl_batch.entries = (uint64_t)(uintptr_t)entries;  // NOLINT
+      if (fpgautil_ioctl(dev->fd, XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH, &ioctl_batch) < 0) {
+        int err = errno;
+        llf_err(FAILURE_IOCTL, "Failed to ioctl XPCIE_DEV_CHAIN_UPDATE_TABLE_BATCH(errno:%d)\n", err);
+        free(entries);
+        return -FAILURE_IOCTL;
+      }
+    }
+
+    // Unpack results in the same order
+    for (entry_num = 0; head < tail; head++) {
+      fpga_chain_conn_t *conn = &conns[head];
+      int ingr_ret, egr_ret;
+      if (conn->result) {
+        failed++;
+        continue;
+      }
+      ingr_ret = __fpga_chain_batch_status(entries[entry_num++].status);
+      egr_ret = __fpga_chain_batch_status(entries[entry_num++].status);
+      // Delete the half of the connection which was established, as fpga_chain_connect() does
+      if (ingr_ret && !egr_ret)
+        fpga_chain_disconnect_egress(dev_id, lane, conn->fchid);
+      else if (!ingr_ret && egr_ret)
+        fpga_chain_disconnect_ingress(dev_id, lane, conn->fchid);
+      conn->result = ingr_ret ? ingr_ret : egr_ret;
+      if (conn->result) {
+        llf_err(-conn->result, "%s(conns[%u]: fchid(%u)): Failed to update table\n",
+          __func__, head, conn->fchid);
+        failed++;
+      }
+    }
+  }
+
+  free(entries);
+
+  return failed ? -FAILURE_ESTABLISH : 0;
+}
+
+
 /**
  * @brief Function which delete function chain connection
  */
@@ -663,6 +783,184 @@ int fpga_chain_read_table_egress(
 }
 
 
+/**
+ * Max num of retrying to copy the mapped soft table while the driver updates it
+ */
+#define FPGA_CHAIN_SOFT_TABLE_RETRY_MAX  1000
+
+/**
+ * static global variable: Soft tables of function chains mapped read-only per device
+ */
+static const fpga_chain_soft_table_t *fpga_chain_soft_tables[FPGA_MAX_DEVICES];
+
+/**
+ * static global variable: mutex for fpga_chain_soft_table_mmap()/fpga_chain_soft_table_munmap()
+ */
+static pthread_mutex_t fpga_chain_soft_table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * @brief Function which copy a part of the mapped soft table without any system call
+ * @retval true Success(`dst` is a consistent copy)
+ * @retval false The table is not mapped or kept being updated
+ */
+static bool __fpga_chain_soft_table_copy(
+  uint32_t dev_id,
+  const void *src,
+  size_t size,
+  void *dst
+) {
+  const fpga_chain_soft_table_t *soft = fpga_chain_soft_tables[dev_id];
+  if (!soft)
+    return false;
+
+  for (int retry = 0; retry < FPGA_CHAIN_SOFT_TABLE_RETRY_MAX; retry++) {
+    uint32_t seq = __atomic_load_n(&soft->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1) {
+      // The driver is updating the table
+      sched_yield();
+      continue;
+    }
+    memcpy(dst, src, size);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&soft->seq, __ATOMIC_RELAXED) == seq)
+      return true;
+  }
+
+  return false;
+}
+
+
+int __fpga_chain_read_soft_table_lane(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_ioctl_chain_ids_t *ids
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  const fpga_chain_soft_table_t *soft = fpga_chain_soft_tables[dev_id];
+  fpga_chain_soft_entry_t entries[XPCIE_FUNCTION_CHAIN_MAX][FPGA_CID_KIND_MAX];
+
+  if (soft && __fpga_chain_soft_table_copy(dev_id, soft->table[lane], sizeof(entries), entries)) {
+    for (uint32_t index = 0; index < XPCIE_FUNCTION_CHAIN_MAX; index++) {
+      ids[index].lane             = lane;
+      ids[index].fchid            = FUNCTION_CHAIN_ID_MIN + index;
+      ids[index].ingress_extif_id = entries[index][FPGA_CID_KIND_INGRESS].extif_id;
+      ids[index].ingress_cid      = entries[index][FPGA_CID_KIND_INGRESS].cid;
+      ids[index].egress_extif_id  = entries[index][FPGA_CID_KIND_EGRESS].extif_id;
+      ids[index].egress_cid       = entries[index][FPGA_CID_KIND_EGRESS].cid;
+    }
+    return 0;
+  }
+
+  fpga_ioctl_chain_soft_table_t ioctl_soft_table;
+  memset(&ioctl_soft_table, 0, sizeof(ioctl_soft_table));
+  ioctl_soft_table.lane = lane;
+  ioctl_soft_table.num = XPCIE_FUNCTION_CHAIN_MAX;
+  ioctl_soft_table.ids = (uint64_t)ids;  // NOLINT
+  if (fpgautil_ioctl(dev->fd, XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL, &ioctl_soft_table)) {
+    int err = errno;
+    llf_err(FAILURE_IOCTL, "Failed to ioctl XPCIE_DEV_CHAIN_READ_SOFT_TABLE_ALL(errno:%d)\n", err);
+    return -FAILURE_IOCTL;
+  }
+
+  return 0;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_chain_soft_table_mmap(
+  uint32_t dev_id
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u))\n", __func__, dev_id);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u))\n", __func__, dev_id);
+
+  pthread_mutex_lock(&fpga_chain_soft_table_mutex);
+  if (!fpga_chain_soft_tables[dev_id]) {
+    void *addr = mmap(NULL, sizeof(fpga_chain_soft_table_t), PROT_READ, MAP_SHARED, dev->fd,
+      (off_t)XPCIE_DEV_MMAP_SOFT_TABLE_OFFSET);  // NOLINT
+    if (addr == MAP_FAILED) {
+      int err = errno;
+      pthread_mutex_unlock(&fpga_chain_soft_table_mutex);
+      llf_err(FAILURE_MMAP, "%s(dev_id(%u)): Failed to mmap soft table(errno:%d)\n", __func__, dev_id, err);
+      return -FAILURE_MMAP;
+    }
+    fpga_chain_soft_tables[dev_id] = (const fpga_chain_soft_table_t *)addr;  // NOLINT
+  }
+  pthread_mutex_unlock(&fpga_chain_soft_table_mutex);
+
+  return 0;
+}
+
+
+int fpga_chain_soft_table_munmap(
+  uint32_t dev_id
+) {
+  if (dev_id >= FPGA_MAX_DEVICES) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u))\n", __func__, dev_id);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u))\n", __func__, dev_id);
+
+  pthread_mutex_lock(&fpga_chain_soft_table_mutex);
+  if (fpga_chain_soft_tables[dev_id]) {
+    munmap((void *)fpga_chain_soft_tables[dev_id], sizeof(fpga_chain_soft_table_t));  // NOLINT
+    fpga_chain_soft_tables[dev_id] = NULL;
+  }
+  pthread_mutex_unlock(&fpga_chain_soft_table_mutex);
+
+  return 0;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_chain_soft_table_snapshot(
+  uint32_t dev_id,
+  fpga_chain_soft_table_t *snapshot
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || !snapshot) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u), snapshot(%#lx))\n", __func__, dev_id, (uintptr_t)snapshot);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u), snapshot(%#lx))\n", __func__, dev_id, (uintptr_t)snapshot);
+
+  const fpga_chain_soft_table_t *soft = fpga_chain_soft_tables[dev_id];
+  if (soft && __fpga_chain_soft_table_copy(dev_id, soft, sizeof(*snapshot), snapshot))
+    return 0;
+
+  // Read each lane by ioctl when the table is not mapped
+  fpga_ioctl_chain_ids_t *ids = (fpga_ioctl_chain_ids_t*)malloc(  // NOLINT
+    sizeof(fpga_ioctl_chain_ids_t) * XPCIE_FUNCTION_CHAIN_MAX);
+  if (!ids) {
+    llf_err(FAILURE_MEMORY_ALLOC, "%s: Failed to allocate memory\n", __func__);
+    return -FAILURE_MEMORY_ALLOC;
+  }
+  memset(snapshot, 0xFF, sizeof(*snapshot));
+  snapshot->seq = 0;
+  snapshot->reserved = 0;
+  for (uint32_t lane = 0; lane < KERNEL_NUM_CHAIN(dev) && lane < XPCIE_KERNEL_LANE_MAX; lane++) {
+    int ret = __fpga_chain_read_soft_table_lane(dev_id, lane, ids);
+    if (ret) {
+      free(ids);
+      return ret;
+    }
+    for (uint32_t index = 0; index < XPCIE_FUNCTION_CHAIN_MAX; index++) {
+      snapshot->table[lane][index][FPGA_CID_KIND_INGRESS].extif_id = ids[index].ingress_extif_id;
+      snapshot->table[lane][index][FPGA_CID_KIND_INGRESS].cid      = ids[index].ingress_cid;
+      snapshot->table[lane][index][FPGA_CID_KIND_EGRESS].extif_id  = ids[index].egress_extif_id;
+      snapshot->table[lane][index][FPGA_CID_KIND_EGRESS].cid       = ids[index].egress_cid;
+    }
+  }
+  free(ids);
+
+  return 0;
+}
+
+
 int fpga_chain_read_soft_table(
   uint32_t dev_id,
   uint32_t lane,
@@ -700,7 +998,16 @@ int fpga_chain_read_soft_table(
   ioctl_chains_ids.lane = lane;
   ioctl_chains_ids.fchid = fchid;
 
-  if (fpgautil_ioctl(dev->fd, XPCIE_DEV_CHAIN_READ_SOFT_TABLE, &ioctl_chains_ids)) {
+  // Read the mapped soft table without any system call if possible
+  const fpga_chain_soft_table_t *soft = fpga_chain_soft_tables[dev_id];
+  fpga_chain_soft_entry_t entry[FPGA_CID_KIND_MAX];
+  if (soft && lane < XPCIE_KERNEL_LANE_MAX
+    && __fpga_chain_soft_table_copy(dev_id, soft->table[lane][fchid - FUNCTION_CHAIN_ID_MIN], sizeof(entry), entry)) {
+    ioctl_chains_ids.ingress_extif_id = entry[FPGA_CID_KIND_INGRESS].extif_id;
+    ioctl_chains_ids.ingress_cid      = entry[FPGA_CID_KIND_INGRESS].cid;
+    ioctl_chains_ids.egress_extif_id  = entry[FPGA_CID_KIND_EGRESS].extif_id;
+    ioctl_chains_ids.egress_cid       = entry[FPGA_CID_KIND_EGRESS].cid;
+  } else if (fpgautil_ioctl(dev->fd, XPCIE_DEV_CHAIN_READ_SOFT_TABLE, &ioctl_chains_ids)) {
     int err = errno;
     llf_err(FAILURE_IOCTL, "Failed to ioctl XPCIE_DEV_CHAIN_READ_SOFT_TABLE(errno:%d)\n", err);
     return -FAILURE_IOCTL;
@@ -943,6 +1250,130 @@ int fpga_chain_wait_disconnection_egress(
 }
 
 
+/**
+ * @struct fpga_chain_wait_set_struct
+ * @brief Struct for __fpga_chain_wait_set_clb
+ */
+struct fpga_chain_wait_set_struct {
+  fpga_chain_wait_t *waits;     /**< Entries to wait for */
+  uint32_t num;                 /**< The num of waits */
+  bool *is_checked;             /**< Work area: the entry is checked in the current sweep */
+  fpga_ioctl_chain_ids_t *ids;  /**< Work area: soft table of a lane */
+};
+
+
+/**
+ * @brief Function which check all waits with one soft table read per (dev_id, lane)
+ * @retval 0 All entries are satisfied
+ * @retval 1 Some entries are not satisfied(continue polling)
+ * @retval (<0) Error(stop polling)
+ */
+static int __fpga_chain_wait_set_clb(
+  void *arg
+) {
+  struct fpga_chain_wait_set_struct *argument = (struct fpga_chain_wait_set_struct*)arg;  // NOLINT
+  fpga_chain_wait_t *waits = argument->waits;
+  int remain = 0;
+
+  for (uint32_t index = 0; index < argument->num; index++)
+    argument->is_checked[index] = waits[index].is_success;
+
+  for (uint32_t index = 0; index < argument->num; index++) {
+    if (argument->is_checked[index])
+      continue;
+
+    int ret = __fpga_chain_read_soft_table_lane(waits[index].dev_id, waits[index].lane, argument->ids);
+    if (ret)
+      return ret;
+
+    // Check all the entries of the same lane with this soft table
+    for (uint32_t target = index; target < argument->num; target++) {
+      fpga_chain_wait_t *wait = &waits[target];
+      if (argument->is_checked[target]
+        || wait->dev_id != waits[index].dev_id || wait->lane != waits[index].lane)
+        continue;
+      const fpga_ioctl_chain_ids_t *id = &argument->ids[wait->fchid - FUNCTION_CHAIN_ID_MIN];
+      uint32_t extif_id = wait->dir == FUNCTION_CHAIN_DIR_INGRESS ? id->ingress_extif_id : id->egress_extif_id;
+      uint32_t cid      = wait->dir == FUNCTION_CHAIN_DIR_INGRESS ? id->ingress_cid      : id->egress_cid;
+      if (wait->is_established)
+        wait->is_success = (extif_id != -1 && cid != -1);
+      else
+        wait->is_success = (extif_id == -1 && cid == -1);
+      argument->is_checked[target] = true;
+      if (!wait->is_success)
+        remain++;
+    }
+  }
+
+  return remain ? 1 : 0;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_chain_wait_set(
+  fpga_chain_wait_t *waits,
+  uint32_t num,
+  const struct timeval *timeout,
+  const struct timeval *interval,
+  uint32_t *missing_num
+) {
+  // Check input
+  if (!waits || num == 0) {
+    llf_err(INVALID_ARGUMENT,
+      "%s(waits(%#lx), num(%u), timeout(%#lx), interval(%#lx), missing_num(%#lx))\n",
+      __func__, (uintptr_t)waits, num, (uintptr_t)timeout, (uintptr_t)interval, (uintptr_t)missing_num);
+    return -INVALID_ARGUMENT;
+  }
+  for (uint32_t index = 0; index < num; index++) {
+    fpga_device_t *dev = fpga_get_device(waits[index].dev_id);
+    if (!dev || (waits[index].lane >= KERNEL_NUM_CHAIN(dev))
+      || !IS_VALID_FUNCTION_CHAIN_ID(waits[index].fchid)
+      || (waits[index].dir >= FUNCTION_CHAIN_DIR_MAX)) {
+      llf_err(INVALID_ARGUMENT, "%s(waits[%u]: dev_id(%u), lane(%u), fchid(%u), dir(%u))\n",
+        __func__, index, waits[index].dev_id, waits[index].lane, waits[index].fchid, waits[index].dir);
+      return -INVALID_ARGUMENT;
+    }
+  }
+  llf_dbg("%s(waits(%#lx), num(%u), timeout(%#lx), interval(%#lx), missing_num(%#lx))\n",
+    __func__, (uintptr_t)waits, num, (uintptr_t)timeout, (uintptr_t)interval, (uintptr_t)missing_num);
+
+  struct fpga_chain_wait_set_struct clb_argument = {
+    .waits = waits,
+    .num = num,
+    .is_checked = (bool*)malloc(sizeof(bool) * num),  // NOLINT
+    .ids = (fpga_ioctl_chain_ids_t*)malloc(sizeof(fpga_ioctl_chain_ids_t) * XPCIE_FUNCTION_CHAIN_MAX)};  // NOLINT
+  if (!clb_argument.is_checked || !clb_argument.ids) {
+    llf_err(FAILURE_MEMORY_ALLOC, "%s: Failed to allocate memory\n", __func__);
+    free(clb_argument.is_checked);
+    free(clb_argument.ids);
+    return -FAILURE_MEMORY_ALLOC;
+  }
+  for (uint32_t index = 0; index < num; index++)
+    waits[index].is_success = false;
+
+  int ret = __fpga_common_polling(
+    timeout,
+    interval,
+    __fpga_chain_wait_set_clb,
+    (void*)&clb_argument);  // NOLINT
+
+  free(clb_argument.is_checked);
+  free(clb_argument.ids);
+
+  if (ret < 0)
+    return ret;
+
+  if (missing_num) {
+    *missing_num = 0;
+    for (uint32_t index = 0; index < num; index++)
+      if (!waits[index].is_success)
+        (*missing_num)++;
+  }
+
+  return 0;
+}
+
+
 int fpga_chain_get_control(
   uint32_t dev_id,
   uint32_t lane,
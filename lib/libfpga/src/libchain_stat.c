@@ -470,3 +470,49 @@ int fpga_chain_wait_stat_egr_free(
 
   return 0;
 }
+
+
+// cppcheck-suppress unusedFunction
+int fpga_chain_get_stat_all(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_chain_stat_cid_t *cid_stats,
+  uint32_t cid_num,
+  fpga_chain_stat_fchid_t *fchid_stats,
+  uint32_t fchid_num
+) {
+  fpga_ioctl_chain_stat_all_t ioctl_chain_stat_all;
+
+  llf_dbg("%s()\n", __func__);
+
+  /* input check */
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || (lane >= KERNEL_NUM_CHAIN(dev))
+    || (cid_num == 0 && fchid_num == 0)
+    || (cid_num > CID_MAX - CID_MIN + 1)
+    || (fchid_num > FUNCTION_CHAIN_ID_MAX - FUNCTION_CHAIN_ID_MIN + 1)
+    || (cid_num && !cid_stats) || (fchid_num && !fchid_stats)) {
+    llf_err(INVALID_ARGUMENT,
+      "%s(dev_id(%u), lane(%u), cid_stats(%#lx), cid_num(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+      __func__, dev_id, lane, (uintptr_t)cid_stats, cid_num, (uintptr_t)fchid_stats, fchid_num);
+    return -INVALID_ARGUMENT;
+  }
+
+  llf_dbg("%s(dev_id(%u), lane(%u), cid_stats(%#lx), cid_num(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+    __func__, dev_id, lane, (uintptr_t)cid_stats, cid_num, (uintptr_t)fchid_stats, fchid_num);
+
+  memset(&ioctl_chain_stat_all, 0, sizeof(ioctl_chain_stat_all));
+  ioctl_chain_stat_all.lane        = (int)lane;  // NOLINT
+  ioctl_chain_stat_all.cid_num     = cid_num;
+  ioctl_chain_stat_all.fchid_num   = fchid_num;
+  ioctl_chain_stat_all.cid_stats   = (uint64_t)(uintptr_t)cid_stats;  // NOLINT
+  ioctl_chain_stat_all.fchid_stats = (uint64_t)(uintptr_t)fchid_stats;  // NOLINT
+
+  if (fpgautil_ioctl(dev->fd, XPCIE_DEV_CHAIN_GET_STAT_ALL, &ioctl_chain_stat_all) < 0) {
+    int err = errno;
+    llf_err(FAILURE_IOCTL, "Failed to ioctl XPCIE_DEV_CHAIN_GET_STAT_ALL(errno:%d)\n", err);
+    return -FAILURE_IOCTL;
+  }
+
+  return 0;
+}
@@ -0,0 +1,460 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+
+#include <libchain.h>
+#include <liblogging.h>
+
+#include <libfpga_internal/libchain_internal.h>
+#include <libfpga_internal/libfpgacommon_internal.h>
+
+#include <parson.h>  // parson
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// LogLibFpga
+#undef FPGA_LOGGER_LIBNAME
+#define FPGA_LOGGER_LIBNAME LIBCHAIN
+
+
+#define TOPOLOGY_NO_CHAIN  ((uint32_t)-1)  /**< extif_id/cid in soft table when there is no chain */
+
+/**
+ * @struct chain_topology_dir_t
+ * @brief Setting of a direction of a function chain
+ */
+typedef struct chain_topology_dir {
+  bool     valid;          /**< false when the direction is not connected */
+  uint32_t extif_id;       /**< external IF ID */
+  uint32_t cid;            /**< connection id */
+  uint8_t  active_flag;    /**< transfer permission flag */
+  uint8_t  direct_flag;    /**< direct transfer flag(ingress only) */
+  uint8_t  virtual_flag;   /**< virtual connection flag(egress only) */
+  uint8_t  blocking_flag;  /**< blocking forwarding flag(egress only) */
+} chain_topology_dir_t;
+
+/**
+ * @enum CHAIN_TOPOLOGY_OP
+ * @brief Operation for a direction of a function chain
+ */
+enum CHAIN_TOPOLOGY_OP {
+  CHAIN_TOPOLOGY_OP_NONE = 0,    /**< Already as desired */
+  CHAIN_TOPOLOGY_OP_DISCONNECT,  /**< Disconnect only */
+  CHAIN_TOPOLOGY_OP_CONNECT,     /**< Connect only(also used to change flags in place) */
+  CHAIN_TOPOLOGY_OP_RECONNECT,   /**< Disconnect and connect */
+};
+
+/**
+ * @struct chain_topology_lane_t
+ * @brief Desired topology of a lane and the result of applying it
+ */
+typedef struct chain_topology_lane {
+  uint32_t dev_id;     /**< Target device */
+  uint32_t lane;       /**< Target lane */
+  chain_topology_dir_t desired[FUNCTION_CHAIN_ID_MAX + 1][FUNCTION_CHAIN_DIR_MAX];  /**< [fchid][dir] */
+  uint8_t  op[FUNCTION_CHAIN_ID_MAX + 1][FUNCTION_CHAIN_DIR_MAX];                    /**< [fchid][dir] */
+  uint32_t op_num;     /**< [out]The num of executed operations */
+  int      ret;        /**< [out]Result */
+  pthread_t thread;    /**< Thread applying this lane */
+  bool     threaded;   /**< true when `thread` is created */
+} chain_topology_lane_t;
+
+
+/**
+ * @brief Function which get a uint32_t member of json object
+ * @retval 0 Success(`def` is set when `name` is not exist and `required` is false)
+ * @retval -INVALID_DATA `name` is not exist, not number or larger than `max`
+ */
+static int __topology_get_u32(
+  JSON_Object *obj,
+  const char *name,
+  bool required,
+  uint32_t def,
+  uint32_t max,
+  uint32_t *value
+) {
+  if (!json_object_has_value(obj, name)) {
+    if (required) {
+      llf_err(INVALID_DATA, "Invalid data: Parameter(%s) is not exist\n", name);
+      return -INVALID_DATA;
+    }
+    *value = def;
+    return 0;
+  }
+  if (!json_object_has_value_of_type(obj, name, JSONNumber)) {
+    llf_err(INVALID_DATA, "Invalid data: Parameter(%s) is not number\n", name);
+    return -INVALID_DATA;
+  }
+  double number = json_object_get_number(obj, name);
+  if (number < 0 || number > max || number != (uint32_t)number) {  // NOLINT
+    llf_err(INVALID_DATA, "Invalid data: Parameter(%s) is out of range(%f)\n", name, number);
+    return -INVALID_DATA;
+  }
+  *value = (uint32_t)number;  // NOLINT
+  return 0;
+}
+
+
+/**
+ * @brief Function which parse ingress/egress object of a function chain
+ */
+static int __topology_parse_dir(
+  JSON_Object *obj,
+  int dir,
+  chain_topology_dir_t *setting
+) {
+  uint32_t active = 1, direct = 0, virt = 0, blocking = 0;
+  int ret;
+
+  if ((ret = __topology_get_u32(obj, "extif_id", true, 0, FPGA_EXTIF_NUMBER_1, &setting->extif_id))
+    || (ret = __topology_get_u32(obj, "cid", true, 0, CID_MAX, &setting->cid))
+    || (ret = __topology_get_u32(obj, "active", false, 1, 1, &active)))
+    return ret;
+  if (dir == FUNCTION_CHAIN_DIR_INGRESS) {
+    if ((ret = __topology_get_u32(obj, "direct", false, 0, 1, &direct)))
+      return ret;
+  } else {
+    if ((ret = __topology_get_u32(obj, "virtual", false, 0, 1, &virt))
+      || (ret = __topology_get_u32(obj, "blocking", false, 0, 1, &blocking)))
+      return ret;
+  }
+  if (setting->cid < CID_MIN) {
+    llf_err(INVALID_DATA, "Invalid data: cid(%u) is out of range\n", setting->cid);
+    return -INVALID_DATA;
+  }
+
+  setting->valid         = true;
+  setting->active_flag   = (uint8_t)active;
+  setting->direct_flag   = (uint8_t)direct;
+  setting->virtual_flag  = (uint8_t)virt;
+  setting->blocking_flag = (uint8_t)blocking;
+
+  return 0;
+}
+
+
+/**
+ * @brief Function which parse a lane object of the topology
+ */
+static int __topology_parse_lane(
+  JSON_Object *obj,
+  chain_topology_lane_t *lane
+) {
+  int ret;
+
+  if ((ret = __topology_get_u32(obj, "dev_id", true, 0, UINT32_MAX, &lane->dev_id))
+    || (ret = __topology_get_u32(obj, "lane", true, 0, UINT32_MAX, &lane->lane)))
+    return ret;
+
+  fpga_device_t *dev = fpga_get_device(lane->dev_id);
+  if (!dev || lane->lane >= KERNEL_NUM_CHAIN(dev)) {
+    llf_err(INVALID_DATA, "Invalid data: dev_id(%u), lane(%u)\n", lane->dev_id, lane->lane);
+    return -INVALID_DATA;
+  }
+
+  // missing "chains" means the lane has no function chain
+  JSON_Array *chains = json_object_get_array(obj, "chains");
+  for (size_t index = 0; index < json_array_get_count(chains); index++) {
+    JSON_Object *chain = json_array_get_object(chains, index);
+    uint32_t fchid;
+    if (!chain) {
+      llf_err(INVALID_DATA, "Failed to access chains[index:%zu]\n", index);
+      return -INVALID_DATA;
+    }
+    if ((ret = __topology_get_u32(chain, "fchid", true, 0, FUNCTION_CHAIN_ID_MAX, &fchid)))
+      return ret;
+    if (!IS_VALID_FUNCTION_CHAIN_ID(fchid)
+      || lane->desired[fchid][FUNCTION_CHAIN_DIR_INGRESS].valid
+      || lane->desired[fchid][FUNCTION_CHAIN_DIR_EGRESS].valid) {
+      llf_err(INVALID_DATA, "Invalid data: fchid(%u) is invalid or duplicated\n", fchid);
+      return -INVALID_DATA;
+    }
+    JSON_Object *ingress = json_object_get_object(chain, "ingress");
+    if (ingress && (ret = __topology_parse_dir(ingress, FUNCTION_CHAIN_DIR_INGRESS,
+        &lane->desired[fchid][FUNCTION_CHAIN_DIR_INGRESS])))
+      return ret;
+    JSON_Object *egress = json_object_get_object(chain, "egress");
+    if (egress && (ret = __topology_parse_dir(egress, FUNCTION_CHAIN_DIR_EGRESS,
+        &lane->desired[fchid][FUNCTION_CHAIN_DIR_EGRESS])))
+      return ret;
+  }
+
+  // An ingress connection is identified by extif_id and cid in the FPGA
+  for (uint32_t fchid = FUNCTION_CHAIN_ID_MIN; fchid <= FUNCTION_CHAIN_ID_MAX; fchid++) {
+    chain_topology_dir_t *a = &lane->desired[fchid][FUNCTION_CHAIN_DIR_INGRESS];
+    if (!a->valid)
+      continue;
+    for (uint32_t other = fchid + 1; other <= FUNCTION_CHAIN_ID_MAX; other++) {
+      chain_topology_dir_t *b = &lane->desired[other][FUNCTION_CHAIN_DIR_INGRESS];
+      if (b->valid && a->extif_id == b->extif_id && a->cid == b->cid) {
+        llf_err(INVALID_DATA, "Invalid data: ingress extif_id(%u), cid(%u) is used by fchid(%u) and fchid(%u)\n",
+          a->extif_id, a->cid, fchid, other);
+        return -INVALID_DATA;
+      }
+    }
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Function which decide the operation of a direction from the current state
+ */
+static int __topology_plan_dir(
+  chain_topology_lane_t *lane,
+  uint32_t fchid,
+  int dir,
+  uint32_t cur_extif_id,
+  uint32_t cur_cid
+) {
+  const chain_topology_dir_t *want = &lane->desired[fchid][dir];
+  bool connected = cur_cid != TOPOLOGY_NO_CHAIN;
+  uint8_t enable = 0, active = 0, direct = 0, virt = 0, blocking = 0;
+  uint32_t read_fchid, read_extif_id, read_cid;
+  int ret;
+
+  if (!want->valid) {
+    lane->op[fchid][dir] = connected ? CHAIN_TOPOLOGY_OP_DISCONNECT : CHAIN_TOPOLOGY_OP_NONE;
+    return 0;
+  }
+  if (!connected) {
+    lane->op[fchid][dir] = CHAIN_TOPOLOGY_OP_CONNECT;
+    return 0;
+  }
+  if (cur_extif_id != want->extif_id || cur_cid != want->cid) {
+    lane->op[fchid][dir] = CHAIN_TOPOLOGY_OP_RECONNECT;
+    return 0;
+  }
+
+  // Same connection, the soft table does not have flags
+  if (dir == FUNCTION_CHAIN_DIR_INGRESS) {
+    ret = fpga_chain_read_table_ingress(lane->dev_id, lane->lane, cur_extif_id, cur_cid,
+      &enable, &active, &direct, &read_fchid);
+  } else {
+    ret = fpga_chain_read_table_egress(lane->dev_id, lane->lane, fchid,
+      &enable, &active, &virt, &blocking, &read_extif_id, &read_cid);
+  }
+  if (ret)
+    return ret;
+
+  if (enable && active == want->active_flag && direct == want->direct_flag
+    && virt == want->virtual_flag && blocking == want->blocking_flag)
+    lane->op[fchid][dir] = CHAIN_TOPOLOGY_OP_NONE;
+  else
+    lane->op[fchid][dir] = CHAIN_TOPOLOGY_OP_CONNECT;  // overwritten in place
+
+  return 0;
+}
+
+
+/**
+ * @brief Function which connect a direction of a function chain as desired
+ */
+static int __topology_connect_dir(
+  chain_topology_lane_t *lane,
+  uint32_t fchid,
+  int dir
+) {
+  const chain_topology_dir_t *want = &lane->desired[fchid][dir];
+
+  if (dir == FUNCTION_CHAIN_DIR_INGRESS)
+    return fpga_chain_connect_ingress(lane->dev_id, lane->lane, fchid,
+      want->extif_id, want->cid, want->active_flag, want->direct_flag);
+  else
+    return fpga_chain_connect_egress(lane->dev_id, lane->lane, fchid,
+      want->extif_id, want->cid, want->active_flag, want->virtual_flag, want->blocking_flag);
+}
+
+
+/**
+ * @brief Function which set both directions of a function chain as desired into a connection of batch
+ */
+static void __topology_set_conn(
+  const chain_topology_lane_t *lane,
+  uint32_t fchid,
+  fpga_chain_conn_t *conn
+) {
+  const chain_topology_dir_t *ingress = &lane->desired[fchid][FUNCTION_CHAIN_DIR_INGRESS];
+  const chain_topology_dir_t *egress = &lane->desired[fchid][FUNCTION_CHAIN_DIR_EGRESS];
+
+  memset(conn, 0, sizeof(*conn));
+  conn->fchid                = fchid;
+  conn->ingress_extif_id     = ingress->extif_id;
+  conn->ingress_cid          = ingress->cid;
+  conn->egress_extif_id      = egress->extif_id;
+  conn->egress_cid           = egress->cid;
+  conn->ingress_active_flag  = ingress->active_flag;
+  conn->egress_active_flag   = egress->active_flag;
+  conn->direct_flag          = ingress->direct_flag;
+  conn->egress_virtual_flag  = egress->virtual_flag;
+  conn->egress_blocking_flag = egress->blocking_flag;
+}
+
+
+/**
+ * @brief Thread which apply the desired topology to a lane
+ */
+static void *__topology_apply_lane(
+  void *arg
+) {
+  chain_topology_lane_t *lane = (chain_topology_lane_t*)arg;  // NOLINT
+  fpga_ioctl_chain_ids_t ids[XPCIE_FUNCTION_CHAIN_MAX];
+  fpga_chain_conn_t conns[XPCIE_FUNCTION_CHAIN_MAX];
+  uint32_t fchid, index, conn_num = 0;
+  int dir;
+
+  // Read the current state of the whole lane at once and decide operations
+  if ((lane->ret = __fpga_chain_read_soft_table_lane(lane->dev_id, lane->lane, ids)))
+    return NULL;
+  for (index = 0; index < XPCIE_FUNCTION_CHAIN_MAX; index++) {
+    fchid = FUNCTION_CHAIN_ID_MIN + index;
+    if ((lane->ret = __topology_plan_dir(lane, fchid, FUNCTION_CHAIN_DIR_INGRESS,
+        ids[index].ingress_extif_id, ids[index].ingress_cid))
+      || (lane->ret = __topology_plan_dir(lane, fchid, FUNCTION_CHAIN_DIR_EGRESS,
+        ids[index].egress_extif_id, ids[index].egress_cid)))
+      return NULL;
+  }
+
+  // Disconnect at first, so that cids moved to other fchids are free
+  for (fchid = FUNCTION_CHAIN_ID_MIN; fchid <= FUNCTION_CHAIN_ID_MAX; fchid++) {
+    for (dir = 0; dir < FUNCTION_CHAIN_DIR_MAX; dir++) {
+      if (lane->op[fchid][dir] != CHAIN_TOPOLOGY_OP_DISCONNECT
+        && lane->op[fchid][dir] != CHAIN_TOPOLOGY_OP_RECONNECT)
+        continue;
+      if (dir == FUNCTION_CHAIN_DIR_INGRESS)
+        lane->ret = fpga_chain_disconnect_ingress(lane->dev_id, lane->lane, fchid);
+      else
+        lane->ret = fpga_chain_disconnect_egress(lane->dev_id, lane->lane, fchid);
+      if (lane->ret)
+        return NULL;
+      lane->op_num++;
+    }
+  }
+
+  // Connect both directions of a function chain by batch, a single direction by itself
+  for (fchid = FUNCTION_CHAIN_ID_MIN; fchid <= FUNCTION_CHAIN_ID_MAX; fchid++) {
+    bool connect[FUNCTION_CHAIN_DIR_MAX];
+    for (dir = 0; dir < FUNCTION_CHAIN_DIR_MAX; dir++)
+      connect[dir] = lane->op[fchid][dir] == CHAIN_TOPOLOGY_OP_CONNECT
+        || lane->op[fchid][dir] == CHAIN_TOPOLOGY_OP_RECONNECT;
+    if (connect[FUNCTION_CHAIN_DIR_INGRESS] && connect[FUNCTION_CHAIN_DIR_EGRESS]) {
+      __topology_set_conn(lane, fchid, &conns[conn_num++]);
+      continue;
+    }
+    for (dir = 0; dir < FUNCTION_CHAIN_DIR_MAX; dir++) {
+      if (!connect[dir])
+        continue;
+      if ((lane->ret = __topology_connect_dir(lane, fchid, dir)))
+        return NULL;
+      lane->op_num++;
+    }
+  }
+  if (conn_num) {
+    lane->ret = fpga_chain_connect_batch(lane->dev_id, lane->lane, conns, conn_num);
+    for (index = 0; index < conn_num; index++) {
+      if (!conns[index].result)
+        lane->op_num += FUNCTION_CHAIN_DIR_MAX;
+      else if (lane->ret == -FAILURE_ESTABLISH)
+        lane->ret = conns[index].result;  // report the first failure as it is
+    }
+  }
+
+  return NULL;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_chain_apply_topology(
+  const char *json_txt,
+  uint32_t *op_num
+) {
+  chain_topology_lane_t *lanes = NULL;
+  size_t lane_num = 0, index;
+  JSON_Value *root;
+  JSON_Object *obj;
+  int ret = 0;
+
+  // Check input
+  if (!json_txt) {
+    llf_err(INVALID_ARGUMENT, "%s(json_txt(<null>), op_num(%#lx))\n", __func__, (uintptr_t)op_num);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(json_txt(%s), op_num(%#lx))\n", __func__, json_txt, (uintptr_t)op_num);
+
+  root = json_parse_string_with_comments(json_txt);
+  obj = json_value_get_object(root);
+  if (!obj) {
+    llf_err(INVALID_ARGUMENT, "Failed to parse string: %s\n", json_txt);
+    json_value_free(root);
+    return -INVALID_ARGUMENT;
+  }
+
+  // Parse and check all lanes before touching any of them
+  JSON_Array *topology = json_object_get_array(obj, "topology");
+  lane_num = json_array_get_count(topology);
+  if (lane_num) {
+    lanes = (chain_topology_lane_t*)calloc(lane_num, sizeof(chain_topology_lane_t));  // NOLINT
+    if (!lanes) {
+      llf_err(FAILURE_MEMORY_ALLOC, "%s: Failed to allocate memory\n", __func__);
+      json_value_free(root);
+      return -FAILURE_MEMORY_ALLOC;
+    }
+  }
+  for (index = 0; index < lane_num; index++) {
+    JSON_Object *elem = json_array_get_object(topology, index);
+    if (!elem) {
+      llf_err(INVALID_DATA, "Failed to access topology[index:%zu]\n", index);
+      ret = -INVALID_DATA;
+      break;
+    }
+    if ((ret = __topology_parse_lane(elem, &lanes[index])))
+      break;
+    for (size_t other = 0; other < index; other++) {
+      if (lanes[other].dev_id == lanes[index].dev_id && lanes[other].lane == lanes[index].lane) {
+        llf_err(INVALID_DATA, "Invalid data: dev_id(%u), lane(%u) is duplicated\n",
+          lanes[index].dev_id, lanes[index].lane);
+        ret = -INVALID_DATA;
+        break;
+      }
+    }
+    if (ret)
+      break;
+  }
+  json_value_free(root);
+  if (ret) {
+    free(lanes);
+    return ret;
+  }
+
+  // Apply each lane in parallel, the driver serializes nothing across lanes
+  for (index = 0; index < lane_num; index++) {
+    if (!pthread_create(&lanes[index].thread, NULL, __topology_apply_lane, &lanes[index]))
+      lanes[index].threaded = true;
+    else
+      __topology_apply_lane(&lanes[index]);
+  }
+  if (op_num)
+    *op_num = 0;
+  for (index = 0; index < lane_num; index++) {
+    if (lanes[index].threaded)
+      pthread_join(lanes[index].thread, NULL);
+    if (op_num)
+      *op_num += lanes[index].op_num;
+    if (lanes[index].ret && !ret) {
+      llf_err(-lanes[index].ret, "%s: Failed to apply dev_id(%u), lane(%u)\n",
+        __func__, lanes[index].dev_id, lanes[index].lane);
+      ret = lanes[index].ret;
+    }
+  }
+
+  free(lanes);
+
+  return ret;
+}
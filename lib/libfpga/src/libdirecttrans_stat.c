@@ -94,3 +94,42 @@ int fpga_direct_get_stat_frames(
 
   return 0;
 }
+
+
+// cppcheck-suppress unusedFunction
+int fpga_direct_get_stat_all(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_direct_stat_fchid_t *fchid_stats,
+  uint32_t fchid_num
+) {
+  fpga_ioctl_direct_stat_all_t ioctl_direct_stat_all;
+
+  llf_dbg("%s()\n", __func__);
+
+  /* input check */
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || !fchid_stats || (lane >= KERNEL_NUM_DIRECT(dev))
+    || (fchid_num == 0) || (fchid_num > FUNCTION_CHAIN_ID_MAX - FUNCTION_CHAIN_ID_MIN + 1)) {
+    llf_err(INVALID_ARGUMENT,
+      "%s(dev_id(%u), lane(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+      __func__, dev_id, lane, (uintptr_t)fchid_stats, fchid_num);
+    return -INVALID_ARGUMENT;
+  }
+
+  llf_dbg("%s(dev_id(%u), lane(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+      __func__, dev_id, lane, (uintptr_t)fchid_stats, fchid_num);
+
+  memset(&ioctl_direct_stat_all, 0, sizeof(ioctl_direct_stat_all));
+  ioctl_direct_stat_all.lane        = (int)lane;  // NOLINT
+  ioctl_direct_stat_all.fchid_num   = fchid_num;
+  ioctl_direct_stat_all.fchid_stats = (uint64_t)(uintptr_t)fchid_stats;  // NOLINT
+
+  if (fpgautil_ioctl(dev->fd, XPCIE_DEV_DIRECT_GET_STAT_ALL, &ioctl_direct_stat_all) < 0) {
+    int err = errno;
+    llf_err(FAILURE_IOCTL, "Failed to ioctl XPCIE_DEV_DIRECT_GET_STAT_ALL(errno:%d)\n", err);
+    return -FAILURE_IOCTL;
+  }
+
+  return 0;
+}
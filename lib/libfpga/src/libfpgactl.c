@@ -5,6 +5,7 @@
 *************************************************/
 
 #include <libfpgactl.h>
+#include <libchain.h>
 #include <liblogging.h>
 
 #include <libfpga_internal/libfpgactl_internal.h>
@@ -491,6 +492,8 @@ int fpga_dev_finish(
   }
   llf_dbg("%s(dev_id(%u))\n", __func__, dev_id);
 
+  fpga_stat_munmap(dev_id);
+  fpga_chain_soft_table_munmap(dev_id);
   free(dev->name);
   fpgautil_close(dev->fd);
   memset(dev, 0, sizeof(fpga_device_t));
@@ -936,6 +939,9 @@ int fpga_disable_regrw(
   }
   llf_dbg("%s(dev_id(%u))\n", __func__, dev_id);
 
+  // The driver refuses to lock while register windows are mapped
+  fpga_stat_munmap(dev_id);
+
   uint32_t flag = XPCIE_DEV_REG_DISABLE;
   int ret = fpgautil_ioctl(dev->fd, XPCIE_DEV_DRIVER_SET_REG_LOCK, &flag);
   if (ret) {
@@ -978,3 +984,41 @@ int fpga_disable_regrw_all(void) {
 
   return 0;
 }
+
+
+int fpga_reg_rw_vec(
+  uint32_t dev_id,
+  fpga_ioctl_reg_op_t *ops,
+  uint32_t num,
+  uint32_t *done
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || !ops || num == 0 || num > XPCIE_DEV_REG_VEC_MAX) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u), ops(%#lx), num(%u))\n",
+      __func__, dev_id, (uintptr_t)ops, num);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u), ops(%#lx), num(%u))\n", __func__, dev_id, (uintptr_t)ops, num);
+
+  fpga_ioctl_reg_vec_t ioctl_data;
+  ioctl_data.ops = (uint64_t)(uintptr_t)ops;  // NOLINT
+  ioctl_data.num = num;
+  ioctl_data.done = 0;
+  int ret = fpgautil_ioctl(dev->fd, XPCIE_DEV_DRIVER_RW_REGS, &ioctl_data);
+  int err = errno;
+  if (done)
+    *done = ioctl_data.done;
+  if (ret) {
+    if (err == ETIMEDOUT) {
+      llf_err(FAILURE_READ, "%s(Polling register(%#x) timed out at ops[%u].)\n",
+        __func__, ops[ioctl_data.done].offset, ioctl_data.done);
+      return -FAILURE_READ;
+    }
+    llf_err(FAILURE_IOCTL, "Failed to ioctl XPCIE_DEV_DRIVER_RW_REGS(errno:%d)\n", err);
+    if (err == EBUSY)
+      llf_err(FAILURE_IOCTL, "%s(Invalid operation: Maybe FPGA registers are locked yet.)\n", __func__);
+    return -FAILURE_IOCTL;
+  }
+
+  return 0;
+}
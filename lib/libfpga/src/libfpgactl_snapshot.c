@@ -0,0 +1,551 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+
+#include <libfpgactl_snapshot.h>
+#include <libchain_stat.h>
+#include <libdirecttrans_stat.h>
+#include <libfunction_conv_stat.h>
+#include <liblogging.h>
+
+#ifndef enable_external_libfunction_filter_resize  // defined by Makefile if need
+#include <libfunction_filter_resize.h>
+#include <libfunction_filter_resize_stat.h>
+#include <libfpga_internal/libfunction_regmap.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// LogLibFpga
+#undef FPGA_LOGGER_LIBNAME
+#define FPGA_LOGGER_LIBNAME LIBFPGACTL
+
+
+/**
+ * Alignment of the arrays of a snapshot, large enough for any SIMD register
+ */
+#define FPGA_SNAPSHOT_ALIGN               64
+
+/**
+ * The num of columns per cid of chain: ingr_rcv_bytes[2], egr_snd_bytes[2]
+ */
+#define FPGA_SNAPSHOT_CHAIN_CID_COLUMNS   4
+
+/**
+ * The num of columns per fchid of chain: 8 byte counters and 4 frame counters
+ */
+#define FPGA_SNAPSHOT_CHAIN_FCHID_COLUMNS 12
+
+/**
+ * The num of byte counters(and frame counters) per fchid of each module
+ */
+#define FPGA_SNAPSHOT_DIRECT_COUNTERS     (DIRECT_STAT_EGR_SND + 1)
+#define FPGA_SNAPSHOT_CONV_COUNTERS       (CONV_STAT_EGR_SND + 1)
+#ifdef LIBFPGA_INCLUDE_LIBFUNCTION_FILTER_RESIZE_STAT_H_
+#define FPGA_SNAPSHOT_FR_COUNTERS         (FR_STAT_EGR_SND1 + 1)
+#endif
+
+/**
+ * static global variable: reg_id of each column of a cid of chain
+ */
+static const uint8_t fpga_snapshot_chain_cid_bytes[FPGA_SNAPSHOT_CHAIN_CID_COLUMNS] = {
+  CHAIN_STAT_INGR_RCV0, CHAIN_STAT_INGR_RCV1,
+  CHAIN_STAT_EGR_SND0, CHAIN_STAT_EGR_SND1
+};
+
+/**
+ * static global variable: reg_id of each byte column of a fchid of chain
+ */
+static const uint8_t fpga_snapshot_chain_fchid_bytes[] = {
+  CHAIN_STAT_INGR_SND0, CHAIN_STAT_INGR_SND1,
+  CHAIN_STAT_EGR_RCV0, CHAIN_STAT_EGR_RCV1,
+  CHAIN_STAT_INGR_DISCARD0, CHAIN_STAT_INGR_DISCARD1,
+  CHAIN_STAT_EGR_DISCARD0, CHAIN_STAT_EGR_DISCARD1
+};
+
+/**
+ * static global variable: reg_id of each frame column of a fchid of chain
+ */
+static const uint8_t fpga_snapshot_chain_fchid_frames[] = {
+  CHAIN_STAT_INGR_SND0, CHAIN_STAT_INGR_SND1,
+  CHAIN_STAT_EGR_RCV0, CHAIN_STAT_EGR_RCV1
+};
+
+
+/**
+ * @brief Function which round up `size` to FPGA_SNAPSHOT_ALIGN
+ */
+static inline size_t __fpga_snapshot_align(
+  size_t size
+) {
+  return (size + FPGA_SNAPSHOT_ALIGN - 1) & ~((size_t)FPGA_SNAPSHOT_ALIGN - 1);
+}
+
+
+/**
+ * @brief Function which get the num of columns of a lane of the module
+ */
+static uint32_t __fpga_snapshot_lane_columns(
+  uint32_t module,
+  uint32_t cid_num,
+  uint32_t fchid_num
+) {
+  switch (module) {
+  case FPGA_SNAPSHOT_CHAIN:
+    return cid_num * FPGA_SNAPSHOT_CHAIN_CID_COLUMNS + fchid_num * FPGA_SNAPSHOT_CHAIN_FCHID_COLUMNS;
+  case FPGA_SNAPSHOT_DIRECT:
+    return fchid_num * FPGA_SNAPSHOT_DIRECT_COUNTERS * 2;
+  case FPGA_SNAPSHOT_CONV:
+    return fchid_num * FPGA_SNAPSHOT_CONV_COUNTERS * 2;
+#ifdef LIBFPGA_INCLUDE_LIBFUNCTION_FILTER_RESIZE_STAT_H_
+  case FPGA_SNAPSHOT_FILTER_RESIZE:
+    return fchid_num * FPGA_SNAPSHOT_FR_COUNTERS * 2;
+#endif
+  default:
+    return 0;
+  }
+}
+
+
+/**
+ * @brief Function which add a column into `keys` and `masks`
+ * @details Only count up `num` when `keys` is NULL
+ */
+static inline void __fpga_snapshot_add_column(
+  fpga_snapshot_key_t *keys,
+  uint64_t *masks,
+  uint32_t *num,
+  uint32_t module,
+  uint32_t unit,
+  uint32_t reg_id,
+  uint32_t lane,
+  uint32_t id
+) {
+  if (keys) {
+    memset(&keys[*num], 0, sizeof(fpga_snapshot_key_t));
+    keys[*num].module = (uint8_t)module;
+    keys[*num].unit   = (uint8_t)unit;
+    keys[*num].reg_id = (uint8_t)reg_id;
+    keys[*num].lane   = (uint8_t)lane;
+    keys[*num].id     = (uint16_t)id;
+    masks[*num] = unit == FPGA_SNAPSHOT_FRAMES ? UINT32_MAX : UINT64_MAX;
+  }
+  (*num)++;
+}
+
+
+/**
+ * @brief Function which add columns of a lane whose counters are bytes[counters] and frames[counters]
+ */
+static void __fpga_snapshot_add_lane(
+  fpga_snapshot_key_t *keys,
+  uint64_t *masks,
+  uint32_t *num,
+  uint32_t module,
+  uint32_t lane,
+  uint32_t fchid_num,
+  uint32_t counters
+) {
+  for (uint32_t index = 0; index < fchid_num; index++) {
+    uint32_t fchid = XPCIE_FUNCTION_CHAIN_ID_MIN + index;
+    for (uint32_t reg_id = 0; reg_id < counters; reg_id++)
+      __fpga_snapshot_add_column(keys, masks, num, module, FPGA_SNAPSHOT_BYTES, reg_id, lane, fchid);
+    for (uint32_t reg_id = 0; reg_id < counters; reg_id++)
+      __fpga_snapshot_add_column(keys, masks, num, module, FPGA_SNAPSHOT_FRAMES, reg_id, lane, fchid);
+  }
+}
+
+
+/**
+ * @brief Function which decide the columns of a snapshot
+ * @details
+ *   Only count the columns when `keys` is NULL.@n
+ *   The columns of a lane are contiguous, so fpga_snapshot_capture() finds the lanes
+ *    to read by walking the keys.
+ */
+static uint32_t __fpga_snapshot_layout(
+  uint32_t dev_id,
+  uint32_t cid_num,
+  uint32_t fchid_num,
+  fpga_snapshot_key_t *keys,
+  uint64_t *masks
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  uint32_t num = 0;
+  uint32_t lane, index, i;
+
+  for (lane = 0; lane < KERNEL_NUM_CHAIN(dev); lane++) {
+    for (index = 0; index < cid_num; index++)
+      for (i = 0; i < FPGA_SNAPSHOT_CHAIN_CID_COLUMNS; i++)
+        __fpga_snapshot_add_column(keys, masks, &num, FPGA_SNAPSHOT_CHAIN, FPGA_SNAPSHOT_BYTES,
+          fpga_snapshot_chain_cid_bytes[i], lane, XPCIE_CID_MIN + index);
+    for (index = 0; index < fchid_num; index++) {
+      for (i = 0; i < sizeof(fpga_snapshot_chain_fchid_bytes); i++)
+        __fpga_snapshot_add_column(keys, masks, &num, FPGA_SNAPSHOT_CHAIN, FPGA_SNAPSHOT_BYTES,
+          fpga_snapshot_chain_fchid_bytes[i], lane, XPCIE_FUNCTION_CHAIN_ID_MIN + index);
+      for (i = 0; i < sizeof(fpga_snapshot_chain_fchid_frames); i++)
+        __fpga_snapshot_add_column(keys, masks, &num, FPGA_SNAPSHOT_CHAIN, FPGA_SNAPSHOT_FRAMES,
+          fpga_snapshot_chain_fchid_frames[i], lane, XPCIE_FUNCTION_CHAIN_ID_MIN + index);
+    }
+  }
+
+  // The other modules have no counters per cid
+  if (fchid_num == 0)
+    return num;
+
+  for (lane = 0; lane < KERNEL_NUM_DIRECT(dev); lane++)
+    __fpga_snapshot_add_lane(keys, masks, &num, FPGA_SNAPSHOT_DIRECT, lane, fchid_num,
+      FPGA_SNAPSHOT_DIRECT_COUNTERS);
+
+  for (lane = 0; lane < KERNEL_NUM_CONV(dev); lane++)
+    __fpga_snapshot_add_lane(keys, masks, &num, FPGA_SNAPSHOT_CONV, lane, fchid_num,
+      FPGA_SNAPSHOT_CONV_COUNTERS);
+
+#ifdef LIBFPGA_INCLUDE_LIBFUNCTION_FILTER_RESIZE_STAT_H_
+  // Only the function lanes whose kernel is filter_resize have its counters
+  for (lane = 0; lane < KERNEL_NUM_FUNC(dev); lane++) {
+    uint32_t module_id = 0;
+    if (fpga_filter_resize_get_module_id(dev_id, lane, &module_id)
+      || module_id != XPCIE_FPGA_FRFUNC_MODULE_ID_VALUE)
+      continue;
+    __fpga_snapshot_add_lane(keys, masks, &num, FPGA_SNAPSHOT_FILTER_RESIZE, lane, fchid_num,
+      FPGA_SNAPSHOT_FR_COUNTERS);
+  }
+#endif
+
+  return num;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_snapshot_alloc(
+  uint32_t dev_id,
+  uint32_t cid_num,
+  uint32_t fchid_num,
+  fpga_snapshot_t **snapshot
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || !snapshot || (cid_num == 0 && fchid_num == 0)
+    || (cid_num > XPCIE_CID_MAX - XPCIE_CID_MIN + 1)
+    || (fchid_num > XPCIE_FUNCTION_CHAIN_MAX)) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u), cid_num(%u), fchid_num(%u), snapshot(%#lx))\n",
+      __func__, dev_id, cid_num, fchid_num, (uintptr_t)snapshot);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u), cid_num(%u), fchid_num(%u), snapshot(%#lx))\n",
+    __func__, dev_id, cid_num, fchid_num, (uintptr_t)snapshot);
+
+  uint32_t num = __fpga_snapshot_layout(dev_id, cid_num, fchid_num, NULL, NULL);
+
+  // Allocate the struct and all arrays at once, each array starts at FPGA_SNAPSHOT_ALIGN
+  size_t head_size = __fpga_snapshot_align(sizeof(fpga_snapshot_t));
+  size_t array_size = __fpga_snapshot_align(sizeof(uint64_t) * num);
+  size_t keys_size = __fpga_snapshot_align(sizeof(fpga_snapshot_key_t) * num);
+  void *buf = NULL;
+  if (posix_memalign(&buf, FPGA_SNAPSHOT_ALIGN, head_size + array_size * 2 + keys_size)) {
+    llf_err(FAILURE_MEMORY_ALLOC, "Failed to allocate memory for %u counters.\n", num);
+    return -FAILURE_MEMORY_ALLOC;
+  }
+  memset(buf, 0, head_size + array_size * 2 + keys_size);
+
+  fpga_snapshot_t *snap = (fpga_snapshot_t *)buf;  // NOLINT
+  uint64_t *values = (uint64_t *)((uint8_t *)buf + head_size);  // NOLINT
+  uint64_t *masks = (uint64_t *)((uint8_t *)buf + head_size + array_size);  // NOLINT
+  fpga_snapshot_key_t *keys = (fpga_snapshot_key_t *)((uint8_t *)buf + head_size + array_size * 2);  // NOLINT
+
+  snap->dev_id = dev_id;
+  snap->cid_num = cid_num;
+  snap->fchid_num = fchid_num;
+  snap->num = __fpga_snapshot_layout(dev_id, cid_num, fchid_num, keys, masks);
+  snap->keys = keys;
+  snap->masks = masks;
+  snap->values = values;
+
+  if (snap->num != num) {
+    // The function kernels changed between the two walks
+    llf_err(INVALID_DATA, "%s(The num of counters changed from %u to %u.)\n", __func__, num, snap->num);
+    free(buf);
+    return -INVALID_DATA;
+  }
+
+  *snapshot = snap;
+
+  return 0;
+}
+
+
+// cppcheck-suppress unusedFunction
+void fpga_snapshot_free(
+  fpga_snapshot_t *snapshot
+) {
+  llf_dbg("%s(snapshot(%#lx))\n", __func__, (uintptr_t)snapshot);
+  free(snapshot);
+}
+
+
+/**
+ * @brief Function which capture the columns of a lane of chain
+ */
+static int __fpga_snapshot_capture_chain(
+  const fpga_snapshot_t *snapshot,
+  uint32_t lane,
+  void *work,
+  uint64_t *values
+) {
+  fpga_chain_stat_cid_t *cid_stats = (fpga_chain_stat_cid_t *)work;  // NOLINT
+  fpga_chain_stat_fchid_t *fchid_stats = (fpga_chain_stat_fchid_t *)(cid_stats + snapshot->cid_num);  // NOLINT
+  uint32_t index, num = 0;
+
+  int ret = fpga_chain_get_stat_all(snapshot->dev_id, lane,
+    cid_stats, snapshot->cid_num, fchid_stats, snapshot->fchid_num);
+  if (ret)
+    return ret;
+
+  for (index = 0; index < snapshot->cid_num; index++) {
+    const fpga_chain_stat_cid_t *stat = &cid_stats[index];
+    values[num++] = stat->ingr_rcv_bytes[0];
+    values[num++] = stat->ingr_rcv_bytes[1];
+    values[num++] = stat->egr_snd_bytes[0];
+    values[num++] = stat->egr_snd_bytes[1];
+  }
+  for (index = 0; index < snapshot->fchid_num; index++) {
+    const fpga_chain_stat_fchid_t *stat = &fchid_stats[index];
+    values[num++] = stat->ingr_snd_bytes[0];
+    values[num++] = stat->ingr_snd_bytes[1];
+    values[num++] = stat->egr_rcv_bytes[0];
+    values[num++] = stat->egr_rcv_bytes[1];
+    values[num++] = stat->ingr_discard_bytes[0];
+    values[num++] = stat->ingr_discard_bytes[1];
+    values[num++] = stat->egr_discard_bytes[0];
+    values[num++] = stat->egr_discard_bytes[1];
+    values[num++] = stat->ingr_snd_frames[0];
+    values[num++] = stat->ingr_snd_frames[1];
+    values[num++] = stat->egr_rcv_frames[0];
+    values[num++] = stat->egr_rcv_frames[1];
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Function which copy bytes[counters] and frames[counters] of a fchid into the columns
+ */
+static inline void __fpga_snapshot_copy_fchid(
+  uint64_t *values,
+  const uint64_t *bytes,
+  const uint32_t *frames,
+  uint32_t counters
+) {
+  for (uint32_t reg_id = 0; reg_id < counters; reg_id++)
+    values[reg_id] = bytes[reg_id];
+  for (uint32_t reg_id = 0; reg_id < counters; reg_id++)
+    values[counters + reg_id] = frames[reg_id];
+}
+
+
+/**
+ * @brief Function which capture the columns of a lane of the module except chain
+ */
+static int __fpga_snapshot_capture_fchid(
+  const fpga_snapshot_t *snapshot,
+  uint32_t module,
+  uint32_t lane,
+  void *work,
+  uint64_t *values
+) {
+  uint32_t fchid_num = snapshot->fchid_num;
+  uint32_t index;
+  int ret;
+
+  switch (module) {
+  case FPGA_SNAPSHOT_DIRECT:
+    {
+      fpga_direct_stat_fchid_t *stats = (fpga_direct_stat_fchid_t *)work;  // NOLINT
+      ret = fpga_direct_get_stat_all(snapshot->dev_id, lane, stats, fchid_num);
+      if (ret)
+        return ret;
+      for (index = 0; index < fchid_num; index++)
+        __fpga_snapshot_copy_fchid(&values[index * FPGA_SNAPSHOT_DIRECT_COUNTERS * 2],
+          stats[index].bytes, stats[index].frames, FPGA_SNAPSHOT_DIRECT_COUNTERS);
+    }
+    break;
+
+  case FPGA_SNAPSHOT_CONV:
+    {
+      fpga_conv_stat_fchid_t *stats = (fpga_conv_stat_fchid_t *)work;  // NOLINT
+      ret = fpga_conv_get_stat_all(snapshot->dev_id, lane, stats, fchid_num);
+      if (ret)
+        return ret;
+      for (index = 0; index < fchid_num; index++)
+        __fpga_snapshot_copy_fchid(&values[index * FPGA_SNAPSHOT_CONV_COUNTERS * 2],
+          stats[index].bytes, stats[index].frames, FPGA_SNAPSHOT_CONV_COUNTERS);
+    }
+    break;
+
+#ifdef LIBFPGA_INCLUDE_LIBFUNCTION_FILTER_RESIZE_STAT_H_
+  case FPGA_SNAPSHOT_FILTER_RESIZE:
+    {
+      fpga_filter_resize_stat_fchid_t *stats = (fpga_filter_resize_stat_fchid_t *)work;  // NOLINT
+      ret = fpga_filter_resize_get_stat_all(snapshot->dev_id, lane, stats, fchid_num);
+      if (ret)
+        return ret;
+      for (index = 0; index < fchid_num; index++)
+        __fpga_snapshot_copy_fchid(&values[index * FPGA_SNAPSHOT_FR_COUNTERS * 2],
+          stats[index].bytes, stats[index].frames, FPGA_SNAPSHOT_FR_COUNTERS);
+    }
+    break;
+#endif
+
+  default:
+    llf_err(INVALID_DATA, "%s(Invalid module(%u).)\n", __func__, module);
+    return -INVALID_DATA;
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Function which get the time from `start` to `end`[ns]
+ */
+static inline int64_t __fpga_snapshot_diff_ns(
+  const struct timespec *start,
+  const struct timespec *end
+) {
+  return (int64_t)(end->tv_sec - start->tv_sec) * 1000000000 + (end->tv_nsec - start->tv_nsec);
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_snapshot_capture(
+  fpga_snapshot_t *snapshot
+) {
+  if (!snapshot || !fpga_get_device(snapshot->dev_id)) {
+    llf_err(INVALID_ARGUMENT, "%s(snapshot(%#lx))\n", __func__, (uintptr_t)snapshot);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u), num(%u))\n", __func__, snapshot->dev_id, snapshot->num);
+
+  // Work area large enough for the statistics of a lane of any module
+  size_t work_size = sizeof(fpga_chain_stat_cid_t) * snapshot->cid_num
+    + sizeof(fpga_chain_stat_fchid_t) * snapshot->fchid_num;
+  if (work_size < sizeof(fpga_direct_stat_fchid_t) * snapshot->fchid_num)
+    work_size = sizeof(fpga_direct_stat_fchid_t) * snapshot->fchid_num;
+  if (work_size < sizeof(fpga_conv_stat_fchid_t) * snapshot->fchid_num)
+    work_size = sizeof(fpga_conv_stat_fchid_t) * snapshot->fchid_num;
+#ifdef LIBFPGA_INCLUDE_LIBFUNCTION_FILTER_RESIZE_STAT_H_
+  if (work_size < sizeof(fpga_filter_resize_stat_fchid_t) * snapshot->fchid_num)
+    work_size = sizeof(fpga_filter_resize_stat_fchid_t) * snapshot->fchid_num;
+#endif
+  void *work = malloc(work_size);
+  if (!work) {
+    llf_err(FAILURE_MEMORY_ALLOC, "Failed to allocate memory for work area.\n");
+    return -FAILURE_MEMORY_ALLOC;
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  // The columns of a lane are contiguous, read them by the head key of each lane
+  int ret = 0;
+  uint32_t index = 0;
+  while (index < snapshot->num) {
+    const fpga_snapshot_key_t *key = &snapshot->keys[index];
+    if (key->module == FPGA_SNAPSHOT_CHAIN)
+      ret = __fpga_snapshot_capture_chain(snapshot, key->lane, work, &snapshot->values[index]);
+    else
+      ret = __fpga_snapshot_capture_fchid(snapshot, key->module, key->lane, work, &snapshot->values[index]);
+    if (ret) {
+      llf_err(-ret, "%s(Failed to capture module(%u) lane(%u).)\n", __func__, key->module, key->lane);
+      break;
+    }
+    index += __fpga_snapshot_lane_columns(key->module, snapshot->cid_num, snapshot->fchid_num);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  free(work);
+  if (ret)
+    return ret;
+
+  int64_t width_ns = __fpga_snapshot_diff_ns(&start, &end);
+  int64_t middle_ns = (int64_t)start.tv_nsec + width_ns / 2;
+  snapshot->timestamp.tv_sec = start.tv_sec + middle_ns / 1000000000;
+  snapshot->timestamp.tv_nsec = middle_ns % 1000000000;
+  snapshot->capture_ns = (uint64_t)width_ns;
+
+  return 0;
+}
+
+
+/**
+ * @brief Function which compute the increase of each counter
+ * @details No branch in the loop and no alias among arrays, so that it is vectorized
+ */
+static void __fpga_snapshot_delta(
+  uint32_t num,
+  const uint64_t *restrict prev,
+  const uint64_t *restrict cur,
+  const uint64_t *restrict masks,
+  uint64_t *restrict deltas
+) {
+  for (uint32_t index = 0; index < num; index++)
+    deltas[index] = (cur[index] - prev[index]) & masks[index];
+}
+
+
+/**
+ * @brief Function which compute the increase of each counter per second
+ * @details No branch in the loop and no alias among arrays, so that it is vectorized
+ */
+static void __fpga_snapshot_rate(
+  uint32_t num,
+  const uint64_t *restrict prev,
+  const uint64_t *restrict cur,
+  const uint64_t *restrict masks,
+  double scale,
+  double *restrict rates
+) {
+  for (uint32_t index = 0; index < num; index++)
+    rates[index] = (double)((cur[index] - prev[index]) & masks[index]) * scale;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_snapshot_rate(
+  const fpga_snapshot_t *prev,
+  const fpga_snapshot_t *cur,
+  uint64_t *deltas,
+  double *rates
+) {
+  if (!prev || !cur || (!deltas && !rates)
+    || prev->dev_id != cur->dev_id || prev->num != cur->num
+    || memcmp(prev->keys, cur->keys, sizeof(fpga_snapshot_key_t) * cur->num)) {
+    llf_err(INVALID_ARGUMENT, "%s(prev(%#lx), cur(%#lx), deltas(%#lx), rates(%#lx))\n",
+      __func__, (uintptr_t)prev, (uintptr_t)cur, (uintptr_t)deltas, (uintptr_t)rates);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(prev(%#lx), cur(%#lx), deltas(%#lx), rates(%#lx))\n",
+    __func__, (uintptr_t)prev, (uintptr_t)cur, (uintptr_t)deltas, (uintptr_t)rates);
+
+  int64_t interval_ns = __fpga_snapshot_diff_ns(&prev->timestamp, &cur->timestamp);
+  if (rates && interval_ns <= 0) {
+    llf_err(INVALID_ARGUMENT, "%s(cur is not newer than prev: interval(%ld ns))\n",
+      __func__, (long)interval_ns);  // NOLINT
+    return -INVALID_ARGUMENT;
+  }
+
+  if (deltas)
+    __fpga_snapshot_delta(cur->num, prev->values, cur->values, cur->masks, deltas);
+
+  if (rates)
+    __fpga_snapshot_rate(cur->num, prev->values, cur->values, cur->masks,
+      1000000000.0 / (double)interval_ns, rates);
+
+  return 0;
+}
@@ -0,0 +1,223 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+
+#include <libfpgactl.h>
+#include <liblogging.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+
+// LogLibFpga
+#undef FPGA_LOGGER_LIBNAME
+#define FPGA_LOGGER_LIBNAME LIBFPGACTL
+
+
+/**
+ * @brief The num of modules whose register window can be mapped read-only
+ * @details chain, direct, ptu, conv, func
+ */
+#define FPGA_STAT_WINDOW_NUM  5
+
+/**
+ * @struct fpga_stat_window_t
+ * @brief Read-only mapped register window of a module
+ * @var fpga_stat_window_t::base
+ *      Register offset of the head of the window
+ * @var fpga_stat_window_t::size
+ *      Size of the window
+ * @var fpga_stat_window_t::addr
+ *      Mapped address(NULL when not mapped)
+ */
+typedef struct fpga_stat_window {
+  uint64_t base;
+  uint64_t size;
+  volatile uint32_t *addr;
+} fpga_stat_window_t;
+
+/**
+ * static global variable: Read-only mapped register windows per device
+ */
+static fpga_stat_window_t fpga_stat_windows[FPGA_MAX_DEVICES][FPGA_STAT_WINDOW_NUM];
+
+/**
+ * static global variable: mutex for fpga_stat_mmap()/fpga_stat_munmap()
+ */
+static pthread_mutex_t fpga_stat_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * @brief Function which unmap all register windows of the device
+ * @details fpga_stat_mutex should be locked by caller
+ */
+static void __fpga_stat_munmap_locked(
+  uint32_t dev_id
+) {
+  for (int index = 0; index < FPGA_STAT_WINDOW_NUM; index++) {
+    fpga_stat_window_t *window = &fpga_stat_windows[dev_id][index];
+    if (window->addr)
+      munmap((void *)window->addr, window->size);  // NOLINT
+    memset(window, 0, sizeof(fpga_stat_window_t));
+  }
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_stat_mmap(
+  uint32_t dev_id
+) {
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u))\n", __func__, dev_id);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u))\n", __func__, dev_id);
+
+  const fpga_address_info_t *mods[FPGA_STAT_WINDOW_NUM] = {
+    &dev->map.chain,
+    &dev->map.direct,
+    &dev->map.ptu,
+    &dev->map.conv,
+    &dev->map.func,
+  };
+  uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);  // NOLINT
+  int mapped_num = 0;
+
+  pthread_mutex_lock(&fpga_stat_mutex);
+
+  // Map again from scratch to follow the latest address map
+  __fpga_stat_munmap_locked(dev_id);
+
+  for (int index = 0; index < FPGA_STAT_WINDOW_NUM; index++) {
+    fpga_stat_window_t *window = &fpga_stat_windows[dev_id][index];
+    uint64_t size = (uint64_t)mods[index]->len * mods[index]->num;
+    if (size == 0 || (mods[index]->base % page_size) != 0)
+      continue;
+    size = (size + page_size - 1) / page_size * page_size;
+
+    void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, dev->fd,
+      (off_t)(XPCIE_DEV_MMAP_REG_OFFSET + mods[index]->base));  // NOLINT
+    if (addr == MAP_FAILED) {
+      // Not fatal: fpga_stat_read32() uses pread() for this window
+      llf_dbg("  Failed to mmap register window(base:%#lx, size:%#lx)\n",
+        mods[index]->base, size);
+      continue;
+    }
+    window->base = mods[index]->base;
+    window->size = size;
+    window->addr = (volatile uint32_t *)addr;  // NOLINT
+    mapped_num++;
+  }
+
+  pthread_mutex_unlock(&fpga_stat_mutex);
+
+  if (mapped_num == 0) {
+    llf_err(FAILURE_MMAP, "%s(dev_id(%u)): Failed to mmap any register window.\n", __func__, dev_id);
+    return -FAILURE_MMAP;
+  }
+
+  return 0;
+}
+
+
+int fpga_stat_munmap(
+  uint32_t dev_id
+) {
+  if (dev_id >= FPGA_MAX_DEVICES) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u))\n", __func__, dev_id);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(dev_id(%u))\n", __func__, dev_id);
+
+  pthread_mutex_lock(&fpga_stat_mutex);
+  __fpga_stat_munmap_locked(dev_id);
+  pthread_mutex_unlock(&fpga_stat_mutex);
+
+  return 0;
+}
+
+
+int fpga_stat_read32(
+  uint32_t dev_id,
+  uint32_t offset,
+  uint32_t *value
+) {
+  if (dev_id >= FPGA_MAX_DEVICES || !value || (offset % sizeof(uint32_t)) != 0) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u), offset(%#x), value(%#lx))\n",
+      __func__, dev_id, offset, (uintptr_t)value);
+    return -INVALID_ARGUMENT;
+  }
+
+  // Read from the mapped window without any system call
+  for (int index = 0; index < FPGA_STAT_WINDOW_NUM; index++) {
+    const fpga_stat_window_t *window = &fpga_stat_windows[dev_id][index];
+    if (window->addr && offset >= window->base && offset < window->base + window->size) {
+      *value = window->addr[(offset - window->base) / sizeof(uint32_t)];
+      return 0;
+    }
+  }
+
+  // Fall back to pread() when the window is not mapped
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u))\n", __func__, dev_id);
+    return -INVALID_ARGUMENT;
+  }
+  if (pread(dev->fd, value, sizeof(uint32_t), offset) != sizeof(uint32_t)) {
+    llf_err(FAILURE_READ, "%s(dev_id(%u), offset(%#x))\n", __func__, dev_id, offset);
+    return -FAILURE_READ;
+  }
+
+  return 0;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_stat_read_block(
+  uint32_t dev_id,
+  uint32_t offset,
+  uint32_t num,
+  uint32_t *values
+) {
+  if (dev_id >= FPGA_MAX_DEVICES || !values || num == 0 || num > XPCIE_DEV_REG_VEC_MAX
+    || (offset % sizeof(uint32_t)) != 0) {
+    llf_err(INVALID_ARGUMENT, "%s(dev_id(%u), offset(%#x), num(%u), values(%#lx))\n",
+      __func__, dev_id, offset, num, (uintptr_t)values);
+    return -INVALID_ARGUMENT;
+  }
+
+  // Read from the mapped window without any system call
+  uint64_t end = (uint64_t)offset + (uint64_t)num * sizeof(uint32_t);
+  for (int index = 0; index < FPGA_STAT_WINDOW_NUM; index++) {
+    const fpga_stat_window_t *window = &fpga_stat_windows[dev_id][index];
+    if (window->addr && offset >= window->base && end <= window->base + window->size) {
+      const volatile uint32_t *addr = &window->addr[(offset - window->base) / sizeof(uint32_t)];
+      for (uint32_t i = 0; i < num; i++)
+        values[i] = addr[i];
+      return 0;
+    }
+  }
+
+  // Fall back to one vectored register access
+  fpga_ioctl_reg_op_t ops[XPCIE_DEV_REG_VEC_MAX];
+  for (uint32_t i = 0; i < num; i++) {
+    ops[i].op      = XPCIE_DEV_REG_OP_READ32;
+    ops[i].offset  = offset + i * sizeof(uint32_t);
+    ops[i].value   = 0;
+    ops[i].mask    = 0;
+    ops[i].poll_us = 0;
+  }
+  int ret = fpga_reg_rw_vec(dev_id, ops, num, NULL);
+  if (ret)
+    return ret;
+  for (uint32_t i = 0; i < num; i++)
+    values[i] = ops[i].value;
+
+  return 0;
+}
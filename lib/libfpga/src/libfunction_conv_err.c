@@ -31,8 +31,6 @@ int fpga_conv_get_check_err(
   uint32_t lane,
   uint32_t *err_det
 ) {
-  size_t len = sizeof(uint32_t);
-
   llf_dbg("%s()\n", __func__);
 
   /* input check */
@@ -45,7 +43,7 @@ int fpga_conv_get_check_err(
 
   llf_dbg("%s(dev_id(%u), lane(%u), err_det(%#lx))\n", __func__, dev_id, lane, (uintptr_t)err_det);
 
-  if (pread(dev->fd, err_det, len, XPCIE_FPGA_CONV_DETECT_FAULT(lane)) != len) goto failed;
+  if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_DETECT_FAULT(lane), err_det)) goto failed;
 
   return 0;
 
@@ -64,7 +62,6 @@ int fpga_conv_get_err_prot(
   fpga_func_err_prot_t *func_err_prot
 ) {
   uint32_t value;
-  size_t len = sizeof(uint32_t);
 
   llf_dbg("%s()\n", __func__);
 
@@ -79,9 +76,9 @@ int fpga_conv_get_err_prot(
   llf_dbg("%s(dev_id(%u), lane(%u), dir(%u), func_err_prot(%#lx))\n", __func__, dev_id, lane, dir, (uintptr_t)func_err_prot);
 
   if (dir == CONV_DIR_INGRESS) {
-    if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_INGR_RCV_PROTOCOL_FAULT(lane)) != len) goto failed;
+    if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_INGR_RCV_PROTOCOL_FAULT(lane), &value)) goto failed;
   } else if (dir == CONV_DIR_EGRESS) {
-    if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_EGR_SND_PROTOCOL_FAULT(lane)) != len) goto failed;
+    if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_EGR_SND_PROTOCOL_FAULT(lane), &value)) goto failed;
   } else {
     // Do Nothing
     llf_err(INVALID_ARGUMENT, "dir(%u) is not the expected value.\n", dir);
@@ -382,7 +379,6 @@ int fpga_conv_get_err_prot_func(
   fpga_func_err_prot_t *func_err_prot
 ) {
   uint32_t value;
-  size_t len = sizeof(uint32_t);
 
   llf_dbg("%s()\n", __func__);
 
@@ -398,9 +394,9 @@ int fpga_conv_get_err_prot_func(
 
   if (dir == CONV_DIR_INGRESS) {
     if (fr_id == CONV_FUNC_NUMBER_0) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_INGR_SND_PROTOCOL_FAULT_0(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_INGR_SND_PROTOCOL_FAULT_0(lane), &value)) goto failed;
     } else if (fr_id == CONV_FUNC_NUMBER_1) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_INGR_SND_PROTOCOL_FAULT_1(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_INGR_SND_PROTOCOL_FAULT_1(lane), &value)) goto failed;
     } else {
       // Do Nothing
       llf_err(INVALID_ARGUMENT, "fr_id(%u) is not the expected value.\n", fr_id);
@@ -408,9 +404,9 @@ int fpga_conv_get_err_prot_func(
     }
   } else if (dir == CONV_DIR_EGRESS) {
     if (fr_id == CONV_FUNC_NUMBER_0) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_EGR_RCV_PROTOCOL_FAULT_0(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_EGR_RCV_PROTOCOL_FAULT_0(lane), &value)) goto failed;
     } else if (fr_id == CONV_FUNC_NUMBER_1) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_EGR_RCV_PROTOCOL_FAULT_1(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_EGR_RCV_PROTOCOL_FAULT_1(lane), &value)) goto failed;
     } else {
       // Do Nothing
       llf_err(INVALID_ARGUMENT, "fr_id(%u) is not the expected value.\n", fr_id);
@@ -800,7 +796,6 @@ int fpga_conv_get_err_stif(
   fpga_conv_err_stif_t *conv_err_stif
 ) {
   uint32_t value;
-  size_t len = sizeof(uint32_t);
 
   llf_dbg("%s()\n", __func__);
 
@@ -814,7 +809,7 @@ int fpga_conv_get_err_stif(
 
   llf_dbg("%s(dev_id(%u), lane(%u), conv_err_stif(%#lx))\n", __func__, dev_id, lane, (uintptr_t)conv_err_stif);
 
-  if (pread(dev->fd, &value, len, XPCIE_FPGA_CONV_STREAMIF_STALL(lane)) != len) goto failed;
+  if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_STREAMIF_STALL(lane), &value)) goto failed;
 
   conv_err_stif->ingress_rcv_req   = (uint8_t)(value  & 0x00000001);
   conv_err_stif->ingress_rcv_resp  = (uint8_t)((value & 0x00000002) >> 1);
@@ -8,6 +8,7 @@
 #include <liblogging.h>
 
 #include <libfpga_internal/libfpga_json.h>
+#include <libfpga_internal/libfpgactl_internal.h>
 #include <libfpga_internal/libfpgautil.h>
 
 /**
@@ -189,8 +190,6 @@ int fpga_conv_get_stat_ovf(
   uint32_t lane,
   uint32_t *ovf_result
 ) {
-  size_t len = sizeof(uint32_t);
-
   llf_dbg("%s()\n", __func__);
 
   /* input check */
@@ -203,7 +202,7 @@ int fpga_conv_get_stat_ovf(
 
   llf_dbg("%s(dev_id(%u), lane(%u), ovf_result(%#lx))\n", __func__, dev_id, lane, (uintptr_t)ovf_result);
 
-  if (pread(dev->fd, ovf_result, len, XPCIE_FPGA_CONV_STAT_INGR_FRAME_BUFFER_OVERFLOW(lane)) != len) goto failed;
+  if (fpga_stat_read32(dev_id, XPCIE_FPGA_CONV_STAT_INGR_FRAME_BUFFER_OVERFLOW(lane), ovf_result)) goto failed;
 
   return 0;
 
@@ -283,3 +282,98 @@ failed_R:
     llf_err(FAILURE_READ, "Invalid operation: Maybe FPGA registers are locked yet.\n");
   return -FAILURE_READ;
 }
+
+
+/**
+ * The num of register operations per fchid: select + (high, low, high, frames) per counter
+ */
+#define FPGA_CONV_STAT_OPS_PER_FCHID  (1 + (CONV_STAT_EGR_SND + 1) * 4)
+
+
+// cppcheck-suppress unusedFunction
+int fpga_conv_get_stat_all(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_conv_stat_fchid_t *fchid_stats,
+  uint32_t fchid_num
+) {
+  fpga_ioctl_reg_op_t ops[XPCIE_DEV_REG_VEC_MAX];
+  uint32_t fchid_per_vec = XPCIE_DEV_REG_VEC_MAX / FPGA_CONV_STAT_OPS_PER_FCHID;
+  uint32_t head, num, index, reg_id, op_num;
+
+  llf_dbg("%s()\n", __func__);
+
+  /* input check */
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || !fchid_stats || (lane >= KERNEL_NUM_CONV(dev))
+    || (fchid_num == 0) || (fchid_num > XPCIE_FUNCTION_CHAIN_MAX)) {
+    llf_err(INVALID_ARGUMENT,
+      "%s(dev_id(%u), lane(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+      __func__, dev_id, lane, (uintptr_t)fchid_stats, fchid_num);
+    return -INVALID_ARGUMENT;
+  }
+
+  llf_dbg("%s(dev_id(%u), lane(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+    __func__, dev_id, lane, (uintptr_t)fchid_stats, fchid_num);
+
+  const uint32_t addr_l[CONV_STAT_EGR_SND + 1] = {
+    XPCIE_FPGA_CONV_STAT_INGR_RCV_DATA_VALUE_L(lane),
+    XPCIE_FPGA_CONV_STAT_INGR_SND_DATA_0_VALUE_L(lane),
+    XPCIE_FPGA_CONV_STAT_INGR_SND_DATA_1_VALUE_L(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_RCV_DATA_0_VALUE_L(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_RCV_DATA_1_VALUE_L(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_SND_DATA_VALUE_L(lane)
+  };
+  const uint32_t addr_h[CONV_STAT_EGR_SND + 1] = {
+    XPCIE_FPGA_CONV_STAT_INGR_RCV_DATA_VALUE_H(lane),
+    XPCIE_FPGA_CONV_STAT_INGR_SND_DATA_0_VALUE_H(lane),
+    XPCIE_FPGA_CONV_STAT_INGR_SND_DATA_1_VALUE_H(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_RCV_DATA_0_VALUE_H(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_RCV_DATA_1_VALUE_H(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_SND_DATA_VALUE_H(lane)
+  };
+  const uint32_t addr_f[CONV_STAT_EGR_SND + 1] = {
+    XPCIE_FPGA_CONV_STAT_INGR_RCV_FRAME_VALUE(lane),
+    XPCIE_FPGA_CONV_STAT_INGR_SND_FRAME_0_VALUE(lane),
+    XPCIE_FPGA_CONV_STAT_INGR_SND_FRAME_1_VALUE(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_RCV_FRAME_0_VALUE(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_RCV_FRAME_1_VALUE(lane),
+    XPCIE_FPGA_CONV_STAT_EGR_SND_FRAME_VALUE(lane)
+  };
+
+  for (head = 0; head < fchid_num; head += num) {
+    num = fchid_num - head;
+    if (num > fchid_per_vec)
+      num = fchid_per_vec;
+
+    op_num = 0;
+    for (index = 0; index < num; index++) {
+      __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_WRITE32,
+        XPCIE_FPGA_CONV_STAT_SEL_CHANNEL(lane), XPCIE_FUNCTION_CHAIN_ID_MIN + head + index);
+      for (reg_id = 0; reg_id <= CONV_STAT_EGR_SND; reg_id++) {
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_h[reg_id], 0);
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_l[reg_id], 0);
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_h[reg_id], 0);
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_f[reg_id], 0);
+      }
+    }
+
+    int ret = fpga_reg_rw_vec(dev_id, ops, op_num, NULL);
+    if (ret)
+      return ret;
+
+    op_num = 0;
+    for (index = 0; index < num; index++) {
+      fpga_conv_stat_fchid_t *stat = &fchid_stats[head + index];
+      op_num++;  // select
+      for (reg_id = 0; reg_id <= CONV_STAT_EGR_SND; reg_id++) {
+        stat->bytes[reg_id] = __fpga_reg_vec_merge64(
+          ops[op_num].value, ops[op_num + 1].value, ops[op_num + 2].value);
+        stat->frames[reg_id] = ops[op_num + 3].value;
+        op_num += 4;
+      }
+    }
+  }
+
+  return 0;
+}
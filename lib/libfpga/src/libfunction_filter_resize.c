@@ -119,9 +119,12 @@ static int fpga_filter_resize_init(
 
 /**
  * @brief Function which set value into register as filter_resize of modulized fpga
+ * @details
+ *   All registers are written by one fpga_reg_rw_vec(),
+ *    so other processes never see the function kernel half-configured.
  */
 static int __fpga_filter_resize_set(
-  fpga_device_t *dev,
+  uint32_t dev_id,
   uint32_t lane,
   uint32_t i_width,
   uint32_t i_height,
@@ -129,42 +132,40 @@ static int __fpga_filter_resize_set(
   uint32_t o_height,
   uint32_t module
 ) {
-  int len = sizeof(uint32_t);
-  uint32_t value;
+  fpga_ioctl_reg_op_t ops[6];
+  uint32_t num = 0;
 
   // [MODULE]Stop function kernel module before set frame size of function kernel
   // When all parameters for Function kernel are not ALL F, skip this parameter
-  if (i_width != -1 && i_height != -1 && o_width != -1 && o_height != -1) {
-    value = XPCIE_FPGA_STOP_MODULE;
-    if (pwrite(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_KRNL_OFFSET(lane)) != len) goto failed;
-  }
+  if (i_width != -1 && i_height != -1 && o_width != -1 && o_height != -1)
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_FRFUNC_KRNL_OFFSET(lane), XPCIE_FPGA_STOP_MODULE);
 
   // [FRAME]Set output height frame size
   // When i_width is ALL F, skip this parameter
   if (~i_width) {
     llf_dbg("  parameter(%s) : %u\n", "i_width", i_width);
-    if (pwrite(dev->fd, &i_width, len, XPCIE_FPGA_FRFUNC_COLS_INPUT(lane)) != len) goto failed;
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_FRFUNC_COLS_INPUT(lane), i_width);
   }
 
   // [FRAME]Set output height frame size
   // When i_height is ALL F, skip this parameter
   if (~i_height) {
     llf_dbg("  parameter(%s): %u\n", "i_height", i_height);
-    if (pwrite(dev->fd, &i_height, len, XPCIE_FPGA_FRFUNC_ROWS_INPUT(lane)) != len) goto failed;
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_FRFUNC_ROWS_INPUT(lane), i_height);
   }
 
   // [FRAME]Set output height frame size
   // When o_width is ALL F, skip this parameter
   if (~o_width) {
     llf_dbg("  parameter(%s) : %u\n", "o_width", o_width);
-    if (pwrite(dev->fd, &o_width, len, XPCIE_FPGA_FRFUNC_COLS_OUTPUT(lane)) != len) goto failed;
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_FRFUNC_COLS_OUTPUT(lane), o_width);
   }
 
   // [FRAME]Set output height frame size
   // When o_height is ALL F, skip this parameter
   if (~o_height) {
     llf_dbg("  parameter(%s): %u\n", "o_height", o_height);
-    if (pwrite(dev->fd, &o_height, len, XPCIE_FPGA_FRFUNC_ROWS_OUTPUT(lane)) != len) goto failed;
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_FRFUNC_ROWS_OUTPUT(lane), o_height);
   }
 
   // Check Later
@@ -173,8 +174,7 @@ static int __fpga_filter_resize_set(
   // When payload is ALL F, skip this parameter
   if (~payload) {
     llf_dbg("  parameter(%s) : %u\n", "payload", payload);
-    value = XPCIE_FPGA_PAYLOAD_TYPE_IMAGE;
-    if (pwrite(dev->fd, &value, len, XPCIE_FPGA_SUB_PAYLOAD_TYPE(lane)) != len) goto failed;
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_SUB_PAYLOAD_TYPE(lane), XPCIE_FPGA_PAYLOAD_TYPE_IMAGE);
   }
   */
 
@@ -182,20 +182,19 @@ static int __fpga_filter_resize_set(
   // When module is ALL F, skip this parameter
   if (~module) {
     llf_dbg("  parameter(%s)  : %u\n", "module", module);
-    if (module == 1)
-      value = XPCIE_FPGA_START_MODULE;
-    else
-      value = XPCIE_FPGA_STOP_MODULE;
-    if (pwrite(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_KRNL_OFFSET(lane)) != len) goto failed;
+    __fpga_reg_vec_add_op(ops, &num, XPCIE_DEV_REG_OP_WRITE32, XPCIE_FPGA_FRFUNC_KRNL_OFFSET(lane),
+      module == 1 ? XPCIE_FPGA_START_MODULE : XPCIE_FPGA_STOP_MODULE);
   }
 
-  return 0;
+  if (num == 0)
+    return 0;
 
-failed:
-  llf_err(FAILURE_WRITE, "%s(Failed to set parameter.)\n", __func__);
-  if (errno == EBUSY)
-    llf_err(FAILURE_WRITE, "%s(Invalid operation: Maybe FPGA registers are locked yet.)\n", __func__);
-  return -FAILURE_WRITE;
+  if (fpga_reg_rw_vec(dev_id, ops, num, NULL)) {
+    llf_err(FAILURE_WRITE, "%s(Failed to set parameter.)\n", __func__);
+    return -FAILURE_WRITE;
+  }
+
+  return 0;
 }
 
 
@@ -268,7 +267,7 @@ static int fpga_filter_resize_set(
   }
 
   int ret_fr = __fpga_filter_resize_set(
-    dev,
+    dev_id,
     lane,
     i_width,
     i_height,
@@ -415,7 +414,7 @@ static int fpga_filter_resize_finish(
     __func__, dev_id, lane, json_txt ? json_txt : "<null>");
 
   int ret_fr = __fpga_filter_resize_set(
-    dev,
+    dev_id,
     lane,
     0,          // i_width
     0,          // i_height
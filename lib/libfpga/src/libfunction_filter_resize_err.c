@@ -27,8 +27,6 @@ int fpga_filter_resize_get_check_err(
   uint32_t lane,
   uint32_t *err_det
 ) {
-  size_t len = sizeof(uint32_t);
-
   llf_dbg("%s()\n", __func__);
 
   /* input check */
@@ -41,7 +39,7 @@ int fpga_filter_resize_get_check_err(
 
   llf_dbg("%s(dev_id(%u), lane(%u), err_det(%#lx))\n", __func__, dev_id, lane, (uintptr_t)err_det);
 
-  if (pread(dev->fd, err_det, len, XPCIE_FPGA_FRFUNC_DETECT_FAULT(lane)) != len) goto failed;
+  if (fpga_stat_read32(dev_id, XPCIE_FPGA_FRFUNC_DETECT_FAULT(lane), err_det)) goto failed;
 
   return 0;
 
@@ -61,7 +59,6 @@ int fpga_filter_resize_get_err_prot(
   fpga_func_err_prot_t *func_err_prot
 ) {
   uint32_t value;
-  size_t len = sizeof(uint32_t);
 
   llf_dbg("%s()\n", __func__);
 
@@ -77,9 +74,9 @@ int fpga_filter_resize_get_err_prot(
 
   if (dir == FRFUNC_DIR_INGRESS) {
     if (fr_id == FRFUNC_FUNC_NUMBER_0) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_INGR_RCV_PROTOCOL_FAULT_0(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_FRFUNC_INGR_RCV_PROTOCOL_FAULT_0(lane), &value)) goto failed;
     } else if (fr_id == FRFUNC_FUNC_NUMBER_1) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_INGR_RCV_PROTOCOL_FAULT_1(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_FRFUNC_INGR_RCV_PROTOCOL_FAULT_1(lane), &value)) goto failed;
     } else {
       // Do Nothing
       llf_err(INVALID_ARGUMENT, "fr_id(%u) is not the expected value.\n", fr_id);
@@ -87,9 +84,9 @@ int fpga_filter_resize_get_err_prot(
     }
   } else if (dir == FRFUNC_DIR_EGRESS) {
     if (fr_id == FRFUNC_FUNC_NUMBER_0) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_EGR_SND_PROTOCOL_FAULT_0(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_FRFUNC_EGR_SND_PROTOCOL_FAULT_0(lane), &value)) goto failed;
     } else if (fr_id == FRFUNC_FUNC_NUMBER_1) {
-      if (pread(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_EGR_SND_PROTOCOL_FAULT_1(lane)) != len) goto failed;
+      if (fpga_stat_read32(dev_id, XPCIE_FPGA_FRFUNC_EGR_SND_PROTOCOL_FAULT_1(lane), &value)) goto failed;
     } else {
       // Do Nothing
       llf_err(INVALID_ARGUMENT, "fr_id(%u) is not the expected value.\n", fr_id);
@@ -479,7 +476,6 @@ int fpga_filter_resize_get_err_stif(
   fpga_fr_err_stif_t *fr_err_stif
 ) {
   uint32_t value;
-  size_t len = sizeof(uint32_t);
 
   llf_dbg("%s()\n", __func__);
 
@@ -493,7 +489,7 @@ int fpga_filter_resize_get_err_stif(
 
   llf_dbg("%s(dev_id(%u), lane(%u), fr_err_stif(%#lx))\n", __func__, dev_id, lane, (uintptr_t)fr_err_stif);
 
-  if (pread(dev->fd, &value, len, XPCIE_FPGA_FRFUNC_STREAMIF_STALL(lane)) != len) goto failed;
+  if (fpga_stat_read32(dev_id, XPCIE_FPGA_FRFUNC_STREAMIF_STALL(lane), &value)) goto failed;
 
   fr_err_stif->ingress0_rcv_req  = (uint8_t)(value & 0x00000001);
   fr_err_stif->ingress0_rcv_resp = (uint8_t)((value & 0x00000002) >> 1);
@@ -8,6 +8,7 @@
 #include <liblogging.h>
 
 #include <libfpga_internal/libfpga_json.h>
+#include <libfpga_internal/libfpgactl_internal.h>
 #include <libfpga_internal/libfpgautil.h>
 #include <libfpga_internal/libfunction_regmap.h>
 
@@ -160,3 +161,92 @@ failed_R:
     llf_err(FAILURE_READ, "Invalid operation: Maybe FPGA registers are locked yet.\n");
   return -FAILURE_READ;
 }
+
+
+/**
+ * The num of register operations per fchid: select + (high, low, high, frames) per counter
+ */
+#define FPGA_FILTER_RESIZE_STAT_OPS_PER_FCHID  (1 + (FR_STAT_EGR_SND1 + 1) * 4)
+
+
+// cppcheck-suppress unusedFunction
+int fpga_filter_resize_get_stat_all(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_filter_resize_stat_fchid_t *fchid_stats,
+  uint32_t fchid_num
+) {
+  fpga_ioctl_reg_op_t ops[XPCIE_DEV_REG_VEC_MAX];
+  uint32_t fchid_per_vec = XPCIE_DEV_REG_VEC_MAX / FPGA_FILTER_RESIZE_STAT_OPS_PER_FCHID;
+  uint32_t head, num, index, reg_id, op_num;
+
+  llf_dbg("%s()\n", __func__);
+
+  /* input check */
+  fpga_device_t *dev = fpga_get_device(dev_id);
+  if (!dev || !fchid_stats || (lane >= KERNEL_NUM_FUNC(dev))
+    || (fchid_num == 0) || (fchid_num > XPCIE_FUNCTION_CHAIN_MAX)) {
+    llf_err(INVALID_ARGUMENT,
+      "%s(dev_id(%u), lane(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+      __func__, dev_id, lane, (uintptr_t)fchid_stats, fchid_num);
+    return -INVALID_ARGUMENT;
+  }
+
+  llf_dbg("%s(dev_id(%u), lane(%u), fchid_stats(%#lx), fchid_num(%u))\n",
+    __func__, dev_id, lane, (uintptr_t)fchid_stats, fchid_num);
+
+  const uint32_t addr_l[FR_STAT_EGR_SND1 + 1] = {
+    XPCIE_FPGA_FRFUNC_STAT_INGR_RCV_DATA_0_VALUE_L(lane),
+    XPCIE_FPGA_FRFUNC_STAT_INGR_RCV_DATA_1_VALUE_L(lane),
+    XPCIE_FPGA_FRFUNC_STAT_EGR_SND_DATA_0_VALUE_L(lane),
+    XPCIE_FPGA_FRFUNC_STAT_EGR_SND_DATA_1_VALUE_L(lane)
+  };
+  const uint32_t addr_h[FR_STAT_EGR_SND1 + 1] = {
+    XPCIE_FPGA_FRFUNC_STAT_INGR_RCV_DATA_0_VALUE_H(lane),
+    XPCIE_FPGA_FRFUNC_STAT_INGR_RCV_DATA_1_VALUE_H(lane),
+    XPCIE_FPGA_FRFUNC_STAT_EGR_SND_DATA_0_VALUE_H(lane),
+    XPCIE_FPGA_FRFUNC_STAT_EGR_SND_DATA_1_VALUE_H(lane)
+  };
+  const uint32_t addr_f[FR_STAT_EGR_SND1 + 1] = {
+    XPCIE_FPGA_FRFUNC_STAT_INGR_RCV_FRAME_0_VALUE(lane),
+    XPCIE_FPGA_FRFUNC_STAT_INGR_RCV_FRAME_1_VALUE(lane),
+    XPCIE_FPGA_FRFUNC_STAT_EGR_SND_FRAME_0_VALUE(lane),
+    XPCIE_FPGA_FRFUNC_STAT_EGR_SND_FRAME_1_VALUE(lane)
+  };
+
+  for (head = 0; head < fchid_num; head += num) {
+    num = fchid_num - head;
+    if (num > fchid_per_vec)
+      num = fchid_per_vec;
+
+    op_num = 0;
+    for (index = 0; index < num; index++) {
+      __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_WRITE32,
+        XPCIE_FPGA_FRFUNC_STAT_SEL_CHANNEL(lane), XPCIE_FUNCTION_CHAIN_ID_MIN + head + index);
+      for (reg_id = 0; reg_id <= FR_STAT_EGR_SND1; reg_id++) {
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_h[reg_id], 0);
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_l[reg_id], 0);
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_h[reg_id], 0);
+        __fpga_reg_vec_add_op(ops, &op_num, XPCIE_DEV_REG_OP_READ32, addr_f[reg_id], 0);
+      }
+    }
+
+    int ret = fpga_reg_rw_vec(dev_id, ops, op_num, NULL);
+    if (ret)
+      return ret;
+
+    op_num = 0;
+    for (index = 0; index < num; index++) {
+      fpga_filter_resize_stat_fchid_t *stat = &fchid_stats[head + index];
+      op_num++;  // select
+      for (reg_id = 0; reg_id <= FR_STAT_EGR_SND1; reg_id++) {
+        stat->bytes[reg_id] = __fpga_reg_vec_merge64(
+          ops[op_num].value, ops[op_num + 1].value, ops[op_num + 2].value);
+        stat->frames[reg_id] = ops[op_num + 3].value;
+        op_num += 4;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -7,11 +7,15 @@
 #include <liblogging.h>
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <getopt.h>
 #include <errno.h>
+#include <pthread.h>
 
 
 // LogLibFpga
@@ -19,6 +23,22 @@
 #define FPGA_LOGGER_LIBNAME LIBLOGGING
 
 
+/**
+ * Num of log records in a ring buffer of a thread for async mode(should be power of 2)
+ */
+#define FPGA_LOGGER_ASYNC_RING_SIZE     256
+
+/**
+ * Max length of a log record for async mode(longer log is truncated)
+ */
+#define FPGA_LOGGER_ASYNC_MSG_LEN       256
+
+/**
+ * Interval(us) of the logger thread to check ring buffers when there is no log
+ */
+#define FPGA_LOGGER_ASYNC_INTERVAL_US   1000
+
+
 /**
  * @enum FPGA_LOGGER_TIMESTAMP
  * @brief Enumeration for status of timestamp
@@ -51,6 +71,45 @@ enum FPGA_LOGGER_FILE {
 };
 
 
+/**
+ * @struct libfpga_log_record_t
+ * @brief Struct of a log record for async mode
+ * @var libfpga_log_record_t::level
+ *      loglevel
+ * @var libfpga_log_record_t::time
+ *      time when the log is recorded
+ * @var libfpga_log_record_t::msg
+ *      formatted log
+ */
+typedef struct libfpga_log_record {
+  int level;
+  time_t time;
+  char msg[FPGA_LOGGER_ASYNC_MSG_LEN];
+} libfpga_log_record_t;
+
+/**
+ * @struct libfpga_log_ring_t
+ * @brief Struct of a single-producer/single-consumer ring buffer for async mode
+ * @var libfpga_log_ring_t::next
+ *      next ring buffer in the list
+ * @var libfpga_log_ring_t::in_use
+ *      whether a thread owns this ring buffer
+ * @var libfpga_log_ring_t::head
+ *      index to write next(updated only by the owner thread)
+ * @var libfpga_log_ring_t::tail
+ *      index to read next(updated only by the logger thread)
+ * @var libfpga_log_ring_t::records
+ *      log records
+ */
+typedef struct libfpga_log_ring {
+  struct libfpga_log_ring *next;
+  int in_use;
+  uint32_t head;
+  uint32_t tail;
+  libfpga_log_record_t records[FPGA_LOGGER_ASYNC_RING_SIZE];
+} libfpga_log_ring_t;
+
+
 /**
  * static global variable: long options for libfpga_log_parse_args()
  */
@@ -61,6 +120,7 @@ libfpga_log_long_options[] = {
   { "quit-timestamp", no_argument , NULL, 't' },
   { "set-output-stdout", no_argument , NULL, 's' },
   { "set-output-file", no_argument , NULL, 'f' },
+  { "set-async", no_argument , NULL, 'a' },
   { NULL, 0, 0, 0 },
 };
 
@@ -69,13 +129,13 @@ libfpga_log_long_options[] = {
  */
 static const char
 libfpga_log_short_options[] = {
-  "l:ptsf"
+  "l:ptsfa"
 };
 
 /**
- * static global variable: libfpga's output loglevel
+ * global variable: libfpga's output loglevel(referred by llf_***() inline)
  */
-static int libfpga_glevel = LIBFPGA_LOG_ERROR;
+int libfpga_glevel = LIBFPGA_LOG_ERROR;
 
 /**
  * static global variable: libfpga's timestamp's status
@@ -92,6 +152,51 @@ static int libfpga_stdout = FPGA_LOGGER_STDOUT_OFF;
  */
 static int libfpga_flag_create_file = FPGA_LOGGER_FILE_CLOSED;
 
+/**
+ * static global variable: Whether async mode is enabled
+ */
+static int libfpga_async = 0;
+
+/**
+ * static global variable: Flag to stop the logger thread
+ */
+static int libfpga_async_stop = 0;
+
+/**
+ * static global variable: The logger thread which writes logs from ring buffers
+ */
+static pthread_t libfpga_async_thread;
+
+/**
+ * static global variable: List of ring buffers(ring buffers are never freed for reuse)
+ */
+static libfpga_log_ring_t *libfpga_async_rings = NULL;
+
+/**
+ * static global variable: Num of logs dropped because the ring buffer was full
+ */
+static uint64_t libfpga_async_dropped = 0;
+
+/**
+ * static global variable: Mutex for libfpga_log_set_async()/libfpga_log_quit_async()
+ */
+static pthread_mutex_t libfpga_async_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * static global variable: pthread key to release the ring buffer when the thread exits
+ */
+static pthread_key_t libfpga_async_ring_key;
+
+/**
+ * static global variable: pthread once control for libfpga_async_ring_key and atfork
+ */
+static pthread_once_t libfpga_async_once = PTHREAD_ONCE_INIT;
+
+/**
+ * thread local variable: Ring buffer owned by this thread
+ */
+static __thread libfpga_log_ring_t *libfpga_async_ring = NULL;
+
 
 void libfpga_log_set_level(
   int level
@@ -174,6 +279,10 @@ int libfpga_log_parse_args(
       libfpga_log_quit_output_stdout();
       break;
     }
+    case 'a': {
+      libfpga_log_set_async();
+      break;
+    }
     default:
       llf_err(INVALID_ARGUMENT, "Invalid operation: unable to parse option[%s].\n", argvopt[optind - 1]);
       ret = -INVALID_ARGUMENT;
@@ -205,11 +314,13 @@ void libfpga_log_reset_output_file(void) {
  */
 static int __log_libfpga(
   int level,
+  const time_t *log_time,
   FILE **file
 ) {
   FILE *fp = NULL;
   static FILE *fp_logfile = NULL;
   time_t t;
+  struct tm tm;
   char date[32];
 
   if (libfpga_stdout == FPGA_LOGGER_STDOUT_ON) {
@@ -261,8 +372,11 @@ static int __log_libfpga(
 
   // print timestamp
   if (libfpga_gtime == FPGA_LOGGER_TIMESTAMP_ON) {
-    time(&t);
-    strftime(date, sizeof(date), "%H:%M:%S", localtime(&t));
+    if (log_time)
+      t = *log_time;
+    else
+      time(&t);
+    strftime(date, sizeof(date), "%H:%M:%S", localtime_r(&t, &tm));
     fprintf(fp, "%s", date);
   }
 
@@ -294,6 +408,231 @@ static int __log_libfpga(
 }
 
 
+/**
+ * @brief Release the ring buffer of the exiting thread so that other threads can reuse it
+ */
+static void __libfpga_async_release_ring(
+  void *arg
+) {
+  libfpga_log_ring_t *ring = (libfpga_log_ring_t*)arg;  // NOLINT
+  __atomic_store_n(&ring->in_use, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Disable async mode in the forked child process, because the logger thread is not inherited
+ */
+static void __libfpga_async_atfork_child(void) {
+  libfpga_async = 0;
+  libfpga_async_ring = NULL;
+}
+
+
+/**
+ * @brief Initialize pthread key and atfork handler only once
+ */
+static void __libfpga_async_init_once(void) {
+  pthread_key_create(&libfpga_async_ring_key, __libfpga_async_release_ring);
+  pthread_atfork(NULL, NULL, __libfpga_async_atfork_child);
+}
+
+
+/**
+ * @brief Get the ring buffer owned by this thread
+ */
+static libfpga_log_ring_t *__libfpga_async_get_ring(void) {
+  if (libfpga_async_ring)
+    return libfpga_async_ring;
+
+  // Reuse the ring buffer released by the exited thread
+  libfpga_log_ring_t *ring;
+  for (ring = __atomic_load_n(&libfpga_async_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+    int expected = 0;
+    if (__atomic_compare_exchange_n(&ring->in_use, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      break;
+  }
+
+  // Create a new ring buffer and push it into the list
+  if (!ring) {
+    ring = (libfpga_log_ring_t*)calloc(1, sizeof(libfpga_log_ring_t));  // NOLINT
+    if (!ring)
+      return NULL;
+    ring->in_use = 1;
+    ring->next = __atomic_load_n(&libfpga_async_rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&libfpga_async_rings, &ring->next, ring,
+      false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+      continue;
+  }
+
+  pthread_setspecific(libfpga_async_ring_key, ring);
+  libfpga_async_ring = ring;
+
+  return ring;
+}
+
+
+/**
+ * @brief Format log into the ring buffer of this thread(never blocks)
+ */
+static int __log_libfpga_async_push(
+  int level,
+  const char *format,
+  va_list args
+) {
+  libfpga_log_ring_t *ring = __libfpga_async_get_ring();
+  if (!ring) {
+    __atomic_fetch_add(&libfpga_async_dropped, 1, __ATOMIC_RELAXED);
+    return -1;
+  }
+
+  // Drop the log when the ring buffer is full
+  uint32_t head = ring->head;
+  if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= FPGA_LOGGER_ASYNC_RING_SIZE) {
+    __atomic_fetch_add(&libfpga_async_dropped, 1, __ATOMIC_RELAXED);
+    return 0;
+  }
+
+  libfpga_log_record_t *record = &ring->records[head & (FPGA_LOGGER_ASYNC_RING_SIZE - 1)];
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+  record->level = level;
+  record->time = ts.tv_sec;
+  int len = vsnprintf(record->msg, sizeof(record->msg), format, args);
+  if (len >= (int)sizeof(record->msg))
+    record->msg[sizeof(record->msg) - 2] = '\n';
+
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+  return 0;
+}
+
+
+/**
+ * @brief Format log into the ring buffer of this thread
+ */
+static int __log_libfpga_async(
+  int level,
+  const char *format,
+  ...
+) {
+  va_list args;
+  int ret;
+
+  va_start(args, format);
+  ret = __log_libfpga_async_push(level, format, args);
+  va_end(args);
+
+  return ret;
+}
+
+
+/**
+ * @brief Write all logs in ring buffers into the target output
+ * @return num of written logs
+ */
+static int __libfpga_async_drain(void) {
+  static uint64_t reported_dropped = 0;
+  FILE *fp = NULL;
+  int num = 0;
+
+  for (libfpga_log_ring_t *ring = __atomic_load_n(&libfpga_async_rings, __ATOMIC_ACQUIRE);
+    ring; ring = ring->next) {
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    for (; tail != head; tail++) {
+      const libfpga_log_record_t *record = &ring->records[tail & (FPGA_LOGGER_ASYNC_RING_SIZE - 1)];
+      if (!__log_libfpga(record->level, &record->time, &fp))
+        fputs(record->msg, fp);
+      num++;
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+  }
+
+  // Report dropped logs
+  uint64_t dropped = __atomic_load_n(&libfpga_async_dropped, __ATOMIC_RELAXED);
+  if (dropped != reported_dropped) {
+    time_t t = time(NULL);
+    if (!__log_libfpga(LIBFPGA_LOG_WARN, &t, &fp))
+      fprintf(fp, FPGA_LOGGER_LIBNAME "%llu logs were dropped(total:%llu).\n",
+        (unsigned long long)(dropped - reported_dropped), (unsigned long long)dropped);
+    reported_dropped = dropped;
+  }
+
+  // Flush once per batch
+  if (fp)
+    fflush(fp);
+
+  return num;
+}
+
+
+/**
+ * @brief The logger thread for async mode
+ */
+static void *__libfpga_async_thread(
+  void *arg
+) {
+  (void)arg;
+
+  while (1) {
+    int stop = __atomic_load_n(&libfpga_async_stop, __ATOMIC_ACQUIRE);
+    int num = __libfpga_async_drain();
+    if (stop && !num)
+      break;
+    if (!num)
+      usleep(FPGA_LOGGER_ASYNC_INTERVAL_US);
+  }
+
+  return NULL;
+}
+
+
+int libfpga_log_set_async(void) {
+  int ret = 0;
+
+  pthread_once(&libfpga_async_once, __libfpga_async_init_once);
+
+  pthread_mutex_lock(&libfpga_async_mutex);
+  if (libfpga_async) {
+    ret = -ALREADY_INITIALIZED;
+    goto out;
+  }
+  libfpga_async_stop = 0;
+  if (pthread_create(&libfpga_async_thread, NULL, __libfpga_async_thread, NULL)) {
+    ret = -FAILURE_INITIALIZE;
+    goto out;
+  }
+  __atomic_store_n(&libfpga_async, 1, __ATOMIC_RELEASE);
+
+out:
+  pthread_mutex_unlock(&libfpga_async_mutex);
+  return ret;
+}
+
+
+void libfpga_log_quit_async(void) {
+  pthread_mutex_lock(&libfpga_async_mutex);
+  if (libfpga_async) {
+    // New logs are printed synchronously from now on
+    __atomic_store_n(&libfpga_async, 0, __ATOMIC_RELEASE);
+    // The logger thread finishes after writing all the remaining logs
+    __atomic_store_n(&libfpga_async_stop, 1, __ATOMIC_RELEASE);
+    pthread_join(libfpga_async_thread, NULL);
+  }
+  pthread_mutex_unlock(&libfpga_async_mutex);
+}
+
+
+int libfpga_log_get_async(void) {
+  return __atomic_load_n(&libfpga_async, __ATOMIC_ACQUIRE);
+}
+
+
+uint64_t libfpga_log_get_dropped(void) {
+  return __atomic_load_n(&libfpga_async_dropped, __ATOMIC_RELAXED);
+}
+
+
 int log_libfpga(
   int level,
   const char *format,
@@ -308,16 +647,23 @@ int log_libfpga(
   FILE *fp;
   int ret;
 
-  // Create log file if need, and print prefix(timestamp,loglevel) into the target output
-  ret = __log_libfpga(level, &fp);
-  if (ret < 0)
-    return ret;
+  if (__atomic_load_n(&libfpga_async, __ATOMIC_ACQUIRE)) {
+    // Record log into the ring buffer, the logger thread prints it
+    va_start(args, format);
+    ret = __log_libfpga_async_push(level, format, args);
+    va_end(args);
+  } else {
+    // Create log file if need, and print prefix(timestamp,loglevel) into the target output
+    ret = __log_libfpga(level, NULL, &fp);
+    if (ret < 0)
+      return ret;
 
-  // Print log into the target output
-  va_start(args, format);
-  vfprintf(fp, format, args);
-  va_end(args);
-  fflush(fp);
+    // Print log into the target output
+    va_start(args, format);
+    vfprintf(fp, format, args);
+    va_end(args);
+    fflush(fp);
+  }
 
   // Print log into stdout without timestamp and loglevel
   // when argument's log level is `LIBFPGA_LOG_PRINT` and libfpga_log_set_output_stdout() is not called
@@ -348,23 +694,39 @@ int log_libfpga_cmdline_arg(
   FILE *fp;
   int ret;
 
-  // Create log file if need, and print prefix(timestamp,loglevel) into the target output
-  ret = __log_libfpga(level, &fp);
-  if (ret < 0)
-    return ret;
+  if (__atomic_load_n(&libfpga_async, __ATOMIC_ACQUIRE)) {
+    // Format log into a buffer and record it into the ring buffer
+    char msg[FPGA_LOGGER_ASYNC_MSG_LEN];
+    size_t len;
+    va_start(args, format);
+    vsnprintf(msg, sizeof(msg), format, args);
+    va_end(args);
+    len = strlen(msg);
+    len += snprintf(msg + len, sizeof(msg) - len, "(argc(%d)", argc);
+    for (int i = 0; i < argc && len < sizeof(msg); i++)
+      len += snprintf(msg + len, sizeof(msg) - len, ", argv[%d](%s)", i, argv[i]);
+    if (len < sizeof(msg))
+      snprintf(msg + len, sizeof(msg) - len, ")\n");
+    ret = __log_libfpga_async(level, "%s", msg);
+  } else {
+    // Create log file if need, and print prefix(timestamp,loglevel) into the target output
+    ret = __log_libfpga(level, NULL, &fp);
+    if (ret < 0)
+      return ret;
 
-  // Print log into the target output
-  va_start(args, format);
-  vfprintf(fp, format, args);
-  va_end(args);
+    // Print log into the target output
+    va_start(args, format);
+    vfprintf(fp, format, args);
+    va_end(args);
 
-  // Print argc and argv into the target output
-  fprintf(fp, "(argc(%d)", argc);
-  for (int i = 0; i < argc; i++) {
-    fprintf(fp, ", argv[%d](%s)", i, argv[i]);
+    // Print argc and argv into the target output
+    fprintf(fp, "(argc(%d)", argc);
+    for (int i = 0; i < argc; i++) {
+      fprintf(fp, ", argv[%d](%s)", i, argv[i]);
+    }
+    fprintf(fp, ")\n");
+    fflush(fp);
   }
-  fprintf(fp, ")\n");
-  fflush(fp);
 
   // Print log into stdout without timestamp and loglevel
   // when argument's log level is `LIBFPGA_LOG_PRINT` and libfpga_log_set_output_stdout() is not called
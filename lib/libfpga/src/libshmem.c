@@ -13,8 +13,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <signal.h>
 #include <sys/stat.h>
 #include <sys/file.h>
+#include <sys/wait.h>
 #include <pthread.h>
 
 
@@ -28,6 +31,16 @@
  */
 #define DMA_WORD_LINE_MASK  (0x3)
 
+/**
+ * Name of the memzone for allocation statistics(memzones are separated by file_prefix)
+ */
+#define SHMEM_STATS_MEMZONE_NAME  "fpga_shmem_stats"
+
+/**
+ * Max num of buffers counted in allocation statistics(must be power of 2)
+ */
+#define SHMEM_STATS_RECORD_MAX    (16 * 1024)
+
 
 /**
  * static global variable: Num of Numa Node
@@ -64,6 +77,45 @@ static int shmem_lock_file_fd = -1;
  */
 static char shmem_file_prefix[SHMEM_MAX_FILE_NAME_LEN] = {'\0'};
 
+/**
+ * @struct shmem_stats_zone_t
+ * @brief Struct of allocation statistics placed in the memzone shared by all processes of a file_prefix
+ * @var shmem_stats_zone_t::lock
+ *      Lock among processes(region_mutex is only valid in a process)
+ * @var shmem_stats_zone_t::alloc_bytes
+ *      Bytes allocated by fpga_shmem_alloc()/fpga_shmem_aligned_alloc()
+ * @var shmem_stats_zone_t::peak_alloc_bytes
+ *      Peak of alloc_bytes
+ * @var shmem_stats_zone_t::alloc_count
+ *      Num of allocated buffers per size class
+ * @var shmem_stats_zone_t::dropped
+ *      Num of buffers not counted because record was almost full
+ * @var shmem_stats_zone_t::record_num
+ *      Num of valid elements in record
+ * @var shmem_stats_zone_t::record
+ *      Open addressing table of buffers counted in the statistics,
+ *      hugepage memory is mapped at the same address in all processes,
+ *      so the address allocated by a process can be freed by another process
+ */
+typedef struct shmem_stats_zone {
+  rte_spinlock_t lock;
+  uint64_t alloc_bytes;
+  uint64_t peak_alloc_bytes;
+  uint64_t alloc_count[SHMEM_STATS_SIZE_CLASS_NUM];
+  uint64_t dropped;
+  uint32_t record_num;
+  struct {
+    uintptr_t va;
+    uint64_t size;
+  } record[SHMEM_STATS_RECORD_MAX];
+} shmem_stats_zone_t;
+
+/**
+ * static global variable: Allocation statistics in the shared memzone
+ *                         (NULL when the memzone is not available)
+ */
+static shmem_stats_zone_t *shmem_stats_zone = NULL;
+
 
 /**
  * @enum SHMEM_VERSION_FILE_OPS
@@ -411,6 +463,35 @@ static void __fpga_shmem_unlock_lock_file(
 }
 
 
+/**
+ * @brief Reserve(primary) or look up(secondary) the memzone for allocation statistics
+ * @details
+ *   The statistics are only disabled when the memzone is not available,
+ *    because allocation itself does not depend on them.
+ */
+static void __fpga_shmem_stats_attach(
+  bool is_primary
+) {
+  const struct rte_memzone *mz;
+  if (is_primary) {
+    mz = rte_memzone_reserve(SHMEM_STATS_MEMZONE_NAME, sizeof(shmem_stats_zone_t), SOCKET_ID_ANY, 0);
+    if (mz) {
+      memset(mz->addr, 0, sizeof(shmem_stats_zone_t));
+      rte_spinlock_init(&((shmem_stats_zone_t *)mz->addr)->lock);  // NOLINT
+    }
+  } else {
+    mz = rte_memzone_lookup(SHMEM_STATS_MEMZONE_NAME);
+  }
+  if (!mz) {
+    llf_warn(FAILURE_MEMORY_ALLOC, "  Failed to %s memzone(%s), allocation statistics are disabled.\n",
+      is_primary ? "reserve" : "look up", SHMEM_STATS_MEMZONE_NAME);
+    shmem_stats_zone = NULL;
+    return;
+  }
+  shmem_stats_zone = (shmem_stats_zone_t *)mz->addr;  // NOLINT
+}
+
+
 int fpga_shmem_init(
   const char *file_prefix,
   const bool lcore_mask[],
@@ -448,6 +529,9 @@ int fpga_shmem_init(
     return -FAILURE_INITIALIZE;
   }
 
+  // Attach allocation statistics shared with the primary process
+  __fpga_shmem_stats_attach(false);
+
   memset(shmem_file_prefix, 0, sizeof(shmem_file_prefix));
   snprintf(shmem_file_prefix, sizeof(shmem_file_prefix), "%s", file_prefix_alt);
 
@@ -490,6 +574,9 @@ int fpga_shmem_init_sys(
     return ret;
   }
 
+  // Reserve allocation statistics shared with secondary processes
+  __fpga_shmem_stats_attach(true);
+
   // Store file_prefix
   memset(shmem_file_prefix, 0, sizeof(shmem_file_prefix));
   snprintf(shmem_file_prefix, sizeof(shmem_file_prefix), "%s", file_prefix_alt);
@@ -503,6 +590,11 @@ int fpga_shmem_finish(void) {
 
   fpga_shmem_unregister_all();
 
+  // Detach allocation statistics before the memzone is unmapped
+  pthread_mutex_lock(&region_mutex);
+  shmem_stats_zone = NULL;
+  pthread_mutex_unlock(&region_mutex);
+
   int ret = rte_eal_cleanup();
 
   if (shmem_lock_file_fd >= 0) {
@@ -587,6 +679,151 @@ static inline int __remap_region(
 }
 
 
+/**
+ * @brief Get size class of allocation statistics
+ */
+static int __fpga_shmem_get_size_class(
+  size_t size
+) {
+  int size_class = 0;
+  size_t bound = SHMEM_STATS_SIZE_CLASS_MIN;
+  while (size > bound && size_class < SHMEM_STATS_SIZE_CLASS_NUM - 1) {
+    bound <<= 1;
+    size_class++;
+  }
+  return size_class;
+}
+
+
+/**
+ * @brief Get home slot of a buffer in the record table of allocation statistics
+ */
+static uint32_t __fpga_shmem_stats_home(
+  uintptr_t va
+) {
+  // buffers are aligned by RTE_CACHE_LINE_SIZE at least
+  return (uint32_t)(va / RTE_CACHE_LINE_SIZE) & (SHMEM_STATS_RECORD_MAX - 1);  // NOLINT
+}
+
+
+/**
+ * @brief Find the slot of a buffer in the record table(should be called under shmem_stats_zone->lock)
+ * @retval slot of `va` when found, otherwise the empty slot to insert `va`
+ */
+static uint32_t __fpga_shmem_stats_find(
+  const shmem_stats_zone_t *zone,
+  uintptr_t va
+) {
+  uint32_t slot = __fpga_shmem_stats_home(va);
+  while (zone->record[slot].va && zone->record[slot].va != va)
+    slot = (slot + 1) & (SHMEM_STATS_RECORD_MAX - 1);
+  return slot;
+}
+
+
+/**
+ * @brief Remove a slot from the record table(should be called under shmem_stats_zone->lock)
+ * @details
+ *   Shift the following entries back instead of leaving a tombstone,
+ *    so that the table never fills up with deleted slots.
+ */
+static void __fpga_shmem_stats_remove(
+  shmem_stats_zone_t *zone,
+  uint32_t slot
+) {
+  uint32_t next = slot;
+  for (;;) {
+    next = (next + 1) & (SHMEM_STATS_RECORD_MAX - 1);
+    if (!zone->record[next].va)
+      break;
+    uint32_t home = __fpga_shmem_stats_home(zone->record[next].va);
+    // keep the entry when its home is cyclically in (slot, next]
+    if (((next - home) & (SHMEM_STATS_RECORD_MAX - 1))
+        < ((next - slot) & (SHMEM_STATS_RECORD_MAX - 1)))
+      continue;
+    zone->record[slot] = zone->record[next];
+    slot = next;
+  }
+  zone->record[slot].va = 0;
+  zone->record[slot].size = 0;
+  zone->record_num--;
+}
+
+
+/**
+ * @brief Discount a recorded buffer from statistics(should be called under shmem_stats_zone->lock)
+ * @retval true when `va` was recorded
+ */
+static bool __fpga_shmem_stats_discount(
+  shmem_stats_zone_t *zone,
+  uintptr_t va
+) {
+  uint32_t slot = __fpga_shmem_stats_find(zone, va);
+  if (!zone->record[slot].va)
+    return false;
+  uint64_t size = zone->record[slot].size;
+  zone->alloc_bytes -= size;
+  zone->alloc_count[__fpga_shmem_get_size_class(size)]--;
+  __fpga_shmem_stats_remove(zone, slot);
+  return true;
+}
+
+
+/**
+ * @brief Count the allocated buffer into statistics(should be called under region_mutex)
+ * @details
+ *   The buffer is recorded with its size, so that only recorded buffers are discounted
+ *    by __fpga_shmem_stats_free().@n
+ *   When the record table is almost full, the buffer is not counted but only `dropped` is incremented.
+ */
+static void __fpga_shmem_stats_alloc(
+  const void *va
+) {
+  shmem_stats_zone_t *zone = shmem_stats_zone;
+  size_t size;
+  if (!zone || rte_malloc_validate(va, &size) < 0)
+    return;
+
+  rte_spinlock_lock(&zone->lock);
+  // A stale record remains when the buffer was released without fpga_shmem_free()
+  __fpga_shmem_stats_discount(zone, (uintptr_t)va);  // NOLINT
+  if (zone->record_num >= SHMEM_STATS_RECORD_MAX / 8 * 7) {
+    zone->dropped++;
+    rte_spinlock_unlock(&zone->lock);
+    llf_dbg("  Too many buffers to record, %#llx is not counted in statistics.\n", (uintptr_t)va);
+    return;
+  }
+  uint32_t slot = __fpga_shmem_stats_find(zone, (uintptr_t)va);  // NOLINT
+  zone->record[slot].va = (uintptr_t)va;  // NOLINT
+  zone->record[slot].size = size;
+  zone->record_num++;
+  zone->alloc_bytes += size;
+  if (zone->alloc_bytes > zone->peak_alloc_bytes)
+    zone->peak_alloc_bytes = zone->alloc_bytes;
+  zone->alloc_count[__fpga_shmem_get_size_class(size)]++;
+  rte_spinlock_unlock(&zone->lock);
+}
+
+
+/**
+ * @brief Discount the buffer to be freed from statistics
+ * @details
+ *   Buffers which are not recorded by __fpga_shmem_stats_alloc() are ignored.
+ */
+static void __fpga_shmem_stats_free(
+  const void *va
+) {
+  pthread_mutex_lock(&region_mutex);
+  shmem_stats_zone_t *zone = shmem_stats_zone;
+  if (zone && va) {
+    rte_spinlock_lock(&zone->lock);
+    __fpga_shmem_stats_discount(zone, (uintptr_t)va);  // NOLINT
+    rte_spinlock_unlock(&zone->lock);
+  }
+  pthread_mutex_unlock(&region_mutex);
+}
+
+
 // cppcheck-suppress unusedFunction
 void *fpga_shmem_alloc(
   size_t length
@@ -620,6 +857,7 @@ void *fpga_shmem_alloc(
     llf_warn(INVALID_DATA, "  Cannot allocate memory in a hugepage.\n");
     goto err_out;
   }
+  __fpga_shmem_stats_alloc(va);
   pthread_mutex_unlock(&region_mutex);
 
   return va;
@@ -667,6 +905,7 @@ void *fpga_shmem_aligned_alloc(
     llf_warn(INVALID_DATA, "  Cannot allocate memory in a hugepage.\n");
     goto err_out;
   }
+  __fpga_shmem_stats_alloc(va);
   pthread_mutex_unlock(&region_mutex);
 
   return va;
@@ -687,11 +926,258 @@ void fpga_shmem_free(
 ) {
   llf_dbg("%s(addr(%#llx))\n", __func__, (uintptr_t)addr);
 
+  __fpga_shmem_stats_free(addr);
   rte_free(addr);
   fpga_shmem_unregister(addr);
 }
 
 
+// cppcheck-suppress unusedFunction
+int fpga_shmem_get_stats(
+  fpga_shmem_stats_t *stats
+) {
+  // Check input
+  if (!stats) {
+    llf_err(INVALID_ARGUMENT, "%s(stats(<null>))\n", __func__);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(stats(%#llx))\n", __func__, (uintptr_t)stats);
+
+  if (!shmem_file_prefix[0]) {
+    llf_err(NOT_INITIALIZED, "Invalid operation: DPDK is not initialized yet.\n");
+    return -NOT_INITIALIZED;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  snprintf(stats->file_prefix, sizeof(stats->file_prefix), "%s", shmem_file_prefix);
+
+  // DPDK malloc heap statistics per socket
+  stats->socket_num = fpga_shmem_socket_num < SHMEM_MAX_NUMA_NODE
+    ? fpga_shmem_socket_num : SHMEM_MAX_NUMA_NODE;
+  for (int i = 0; i < stats->socket_num; i++) {
+    struct rte_malloc_socket_stats socket_stats;
+    if (rte_malloc_get_socket_stats(i, &socket_stats) < 0)
+      continue;
+    stats->socket[i].heap_total_bytes = socket_stats.heap_totalsz_bytes;
+    stats->socket[i].heap_free_bytes = socket_stats.heap_freesz_bytes;
+    stats->socket[i].heap_alloc_bytes = socket_stats.heap_allocsz_bytes;
+    stats->socket[i].greatest_free_bytes = socket_stats.greatest_free_size;
+    stats->socket[i].free_count = socket_stats.free_count;
+    stats->socket[i].alloc_count = socket_stats.alloc_count;
+  }
+
+  // Allocation statistics shared by all processes of the file_prefix
+  pthread_mutex_lock(&region_mutex);
+  shmem_stats_zone_t *zone = shmem_stats_zone;
+  if (zone) {
+    rte_spinlock_lock(&zone->lock);
+    stats->alloc_bytes = zone->alloc_bytes;
+    stats->peak_alloc_bytes = zone->peak_alloc_bytes;
+    memcpy(stats->alloc_count, zone->alloc_count, sizeof(stats->alloc_count));
+    stats->alloc_dropped = zone->dropped;
+    rte_spinlock_unlock(&zone->lock);
+  }
+  pthread_mutex_unlock(&region_mutex);
+
+  // v2p map is per process
+
+  stats->region_num = __fpga_shmem_register_count();
+
+  return 0;
+}
+
+
+/**
+ * @struct shmem_msl_walk_arg_t
+ * @brief Struct for argument of __fpga_shmem_msl_walk()
+ * @var shmem_msl_walk_arg_t::msl
+ *      memseg list to search(when searching by pointer)
+ * @var shmem_msl_walk_arg_t::msl_idx
+ *      index of memseg list(in: when searching by index, out: when searching by pointer)
+ * @var shmem_msl_walk_arg_t::cur_idx
+ *      index of memseg list now walking
+ */
+typedef struct shmem_msl_walk_arg {
+  const struct rte_memseg_list *msl;
+  int msl_idx;
+  int cur_idx;
+} shmem_msl_walk_arg_t;
+
+
+/**
+ * @brief Callback for rte_memseg_list_walk() to convert memseg list and its index each other
+ * @details
+ *   memseg lists are placed in the shared memory config of DPDK,
+ *    so the walking order is the same between primary and secondary processes.
+ */
+static int __fpga_shmem_msl_walk(
+  const struct rte_memseg_list *msl,
+  void *arg
+) {
+  shmem_msl_walk_arg_t *walk_arg = (shmem_msl_walk_arg_t*)arg;  // NOLINT
+  int cur_idx = walk_arg->cur_idx++;
+
+  if (walk_arg->msl) {
+    // Search index by pointer
+    if (walk_arg->msl == msl) {
+      walk_arg->msl_idx = cur_idx;
+      return 1;
+    }
+  } else {
+    // Search pointer by index
+    if (walk_arg->msl_idx == cur_idx) {
+      walk_arg->msl = msl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+
+int fpga_shmem_export_token(
+  void *addr,
+  size_t length,
+  fpga_shmem_token_t *token
+) {
+  if (!addr || !length || !token) {
+    llf_err(INVALID_ARGUMENT, "%s(addr(%#llx), length(%#llx), token(%#llx))\n",
+      __func__, (uintptr_t)addr, length, (uintptr_t)token);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(addr(%#llx), length(%#llx), token(%#llx))\n",
+    __func__, (uintptr_t)addr, length, (uintptr_t)token);
+
+  if (!shmem_file_prefix[0]) {
+    llf_err(NOT_INITIALIZED, "Invalid operation: DPDK is not initialized yet.\n");
+    return -NOT_INITIALIZED;
+  }
+
+  // Get memseg list and memseg which the buffer belongs to
+  struct rte_memseg_list *msl = rte_mem_virt2memseg_list(addr);
+  if (!msl) {
+    llf_err(INVALID_ADDRESS, "  %#llx is not on Hugepage.\n", (uintptr_t)addr);
+    return -INVALID_ADDRESS;
+  }
+  struct rte_memseg *ms = rte_mem_virt2memseg(addr, msl);
+  if (!ms) {
+    llf_err(INVALID_ADDRESS, "  memseg is empty.\n");
+    return -INVALID_ADDRESS;
+  }
+
+  // The buffer should be in a hugepage to guarantee physical continuity
+  uint64_t offset = (uintptr_t)addr - (uintptr_t)ms->addr;
+  if (offset + length > ms->len) {
+    llf_err(INVALID_ADDRESS, "  The buffer(%#llx, %#llx) is over a hugepage(%#llx).\n",
+      (uintptr_t)addr, length, ms->len);
+    return -INVALID_ADDRESS;
+  }
+
+  // Get indexes of memseg list and memseg
+  shmem_msl_walk_arg_t walk_arg = { .msl = msl, .msl_idx = -1, .cur_idx = 0 };
+  rte_memseg_list_walk(__fpga_shmem_msl_walk, &walk_arg);
+  int ms_idx = rte_fbarray_find_idx(&msl->memseg_arr, ms);
+  if (walk_arg.msl_idx < 0 || ms_idx < 0) {
+    llf_err(INVALID_ADDRESS, "  Failed to get index of memseg(msl:%d, ms:%d).\n",
+      walk_arg.msl_idx, ms_idx);
+    return -INVALID_ADDRESS;
+  }
+
+  memset(token, 0, sizeof(*token));
+  token->magic = SHMEM_TOKEN_MAGIC;
+  snprintf(token->file_prefix, sizeof(token->file_prefix), "%s", shmem_file_prefix);
+  token->msl_idx = walk_arg.msl_idx;
+  token->ms_idx = ms_idx;
+  token->offset = offset;
+  token->length = length;
+
+  llf_dbg("  token(%s, msl:%d, ms:%d, offset:%#llx, length:%#llx)\n",
+    token->file_prefix, token->msl_idx, token->ms_idx, token->offset, token->length);
+
+  return 0;
+}
+
+
+int fpga_shmem_register_by_token(
+  const void *token,
+  size_t token_len,
+  size_t length,
+  void **addr
+) {
+  if (!token || token_len != sizeof(fpga_shmem_token_t) || !addr) {
+    llf_err(INVALID_ARGUMENT, "%s(token(%#llx), token_len(%#llx), length(%#llx), addr(%#llx))\n",
+      __func__, (uintptr_t)token, token_len, length, (uintptr_t)addr);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(token(%#llx), token_len(%#llx), length(%#llx), addr(%#llx))\n",
+    __func__, (uintptr_t)token, token_len, length, (uintptr_t)addr);
+
+  fpga_shmem_token_t tok;
+  memcpy(&tok, token, sizeof(tok));
+
+  // Check token
+  if (tok.magic != SHMEM_TOKEN_MAGIC) {
+    llf_err(INVALID_DATA, "  Invalid token magic(%#x).\n", tok.magic);
+    return -INVALID_DATA;
+  }
+  tok.file_prefix[sizeof(tok.file_prefix) - 1] = '\0';
+  if (!length)
+    length = tok.length;
+  if (length > tok.length) {
+    llf_err(INVALID_DATA, "  length(%#llx) is larger than the buffer(%#llx).\n", length, tok.length);
+    return -INVALID_DATA;
+  }
+  if (!shmem_file_prefix[0]) {
+    llf_err(NOT_INITIALIZED, "Invalid operation: DPDK is not initialized yet.\n");
+    return -NOT_INITIALIZED;
+  }
+  if (strcmp(tok.file_prefix, shmem_file_prefix)) {
+    llf_err(MISMATCH_FILE_PREFIX, "  file_prefix of token(%s) is not this process's(%s).\n",
+      tok.file_prefix, shmem_file_prefix);
+    return -MISMATCH_FILE_PREFIX;
+  }
+
+  // Get memseg list and memseg from indexes
+  shmem_msl_walk_arg_t walk_arg = { .msl = NULL, .msl_idx = tok.msl_idx, .cur_idx = 0 };
+  rte_memseg_list_walk(__fpga_shmem_msl_walk, &walk_arg);
+  if (!walk_arg.msl) {
+    llf_err(INVALID_ADDRESS, "  memseg list(%d) is not found.\n", tok.msl_idx);
+    return -INVALID_ADDRESS;
+  }
+  struct rte_fbarray *arr = (struct rte_fbarray*)&walk_arg.msl->memseg_arr;  // NOLINT
+  if (tok.ms_idx < 0 || rte_fbarray_is_used(arr, tok.ms_idx) != 1) {
+    llf_err(INVALID_ADDRESS, "  memseg(%d) is not used.\n", tok.ms_idx);
+    return -INVALID_ADDRESS;
+  }
+  struct rte_memseg *ms = (struct rte_memseg*)rte_fbarray_get(arr, tok.ms_idx);  // NOLINT
+  if (!ms || tok.offset + length > ms->len) {
+    llf_err(INVALID_ADDRESS, "  memseg(%d) does not contain the buffer.\n", tok.ms_idx);
+    return -INVALID_ADDRESS;
+  }
+  void *va = (void*)((uintptr_t)ms->addr + tok.offset);  // NOLINT
+
+  // Register into local v2p map
+  uint64_t chklen = length;
+  pthread_mutex_lock(&region_mutex);
+  if (__dma_pa_from_va(va, &chklen) == 0) {
+    if (fpga_shmem_register(va, rte_mem_virt2phy(va), length)) {
+      pthread_mutex_unlock(&region_mutex);
+      llf_err(FAILURE_MEMORY_ALLOC, "  Failed to register %#llx.\n", (uintptr_t)va);
+      return -FAILURE_MEMORY_ALLOC;
+    }
+  } else if (chklen != length) {
+    pthread_mutex_unlock(&region_mutex);
+    llf_err(FAILURE_MEMORY_ALLOC, "  %#llx overlaps with a registered region.\n", (uintptr_t)va);
+    return -FAILURE_MEMORY_ALLOC;
+  }
+  pthread_mutex_unlock(&region_mutex);
+
+  *addr = va;
+
+  return 0;
+}
+
+
 uint64_t __dma_pa_from_va(
   void *va,
   uint64_t *len
@@ -840,3 +1326,24 @@ int fpga_shmem_init_arg(
 
   return ret;
 }
+
+
+void __fpga_shmem_reap_child(
+  pid_t pid,
+  int timeout_ms
+) {
+  llf_dbg("%s(pid(%d), timeout_ms(%d))\n", __func__, pid, timeout_ms);
+
+  const struct timespec interval = { .tv_sec = 0, .tv_nsec = 10 * 1000 * 1000 };
+  for (int elapsed_ms = 0; elapsed_ms < timeout_ms; elapsed_ms += 10) {
+    pid_t ret = waitpid(pid, NULL, WNOHANG);
+    if (ret == pid || (ret < 0 && errno != EINTR))
+      return;
+    nanosleep(&interval, NULL);
+  }
+
+  llf_warn(FAILURE_INITIALIZE, "Child process(pid:%d) did not exit in %d ms, send SIGKILL.\n", pid, timeout_ms);
+  kill(pid, SIGKILL);
+  while (waitpid(pid, NULL, 0) < 0 && errno == EINTR)
+    continue;
+}
@@ -4,17 +4,25 @@
 * SPDX-License-Identifier: BSD-3-Clause
 *************************************************/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // pipe2()
+#endif
 #include <libshmem_controller.h>
 #include <libshmem_socket.h>
 #include <liblogging.h>
 
 #include <libfpga_internal/libdpdkutil.h>
+#include <libfpga_internal/libshmem_internal.h>
 
+#include <fcntl.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/file.h>
 #include <pthread.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/un.h>
 
 
 // LogLibFpga
@@ -23,7 +31,10 @@
 #define FPGA_LOGGER_LIBNAME LIBSHMEM LIBSHMEM_CONTROLLER
 
 
-#define SHMEM_MAX_CHKCNT 10  /**< Max num to check shmem controller established */
+#define SHMEM_MAX_CHKCNT 10  /**< Max num of seconds to wait for shmem controller established */
+
+#define SHMEM_CTRL_EXIT_TIMEOUT_MS 1000  /**< Max time(ms) to wait for shmem controller exiting by SIGTERM */
+#define SHMEM_CTRL_MAX_CLIENTS 16  /**< Max num of clients connecting to shmem controller at once */
 
 
 /**
@@ -47,6 +58,8 @@ typedef enum SHMEM_CTRL_CMD {
 /**
  * @struct fpga_shmem_ctrl_info_t
  * @brief Struct for shmem controller's command
+ * @var fpga_shmem_ctrl_info_t::seq
+ *      sequence number to match the response with the request
  * @var fpga_shmem_ctrl_info_t::cmd
  *      command for fpga's shmem controller
  * @var fpga_shmem_ctrl_info_t::file_prefix
@@ -59,6 +72,7 @@ typedef enum SHMEM_CTRL_CMD {
  *      [TBD]DPDK's log flag
  */
 typedef struct fpga_shmem_ctrl_info {
+  uint32_t seq;
   shmem_ctrl_cmd_t cmd;
   char file_prefix[SHMEM_MAX_HUGEPAGE_PREFIX];
   uint32_t socket_limit[SHMEM_MAX_NUMA_NODE];
@@ -66,6 +80,22 @@ typedef struct fpga_shmem_ctrl_info {
   int log_flag;
 }fpga_shmem_ctrl_info_t;
 
+/**
+ * @struct fpga_shmem_ctrl_res_t
+ * @brief Struct for shmem controller's response
+ * @var fpga_shmem_ctrl_res_t::seq
+ *      sequence number of the request
+ * @var fpga_shmem_ctrl_res_t::response
+ *      response(OK/NG/QUIT/INIT)
+ * @var fpga_shmem_ctrl_res_t::value
+ *      result of the command(e.g. pid of shmem manager, num of pages)
+ */
+typedef struct fpga_shmem_ctrl_res {
+  uint32_t seq;
+  shmem_socket_response_t response;
+  int32_t value;
+}fpga_shmem_ctrl_res_t;
+
 
 /**
  * static global variable: thread id to get prefix of secondary process falling out
@@ -103,6 +133,39 @@ static char shmem_ctrlr_listen_addr[32]
   = LOCALHOST;
 
 
+/**
+ * static global variable: Unix domain socket path for shmem controller(if empty, use TCP)
+ */
+static char shmem_ctrlr_unix_path[SHMEM_MAX_FILE_NAME_LEN]
+  = "";
+
+/**
+ * static global variable: Persistent connection with shmem controller
+ */
+static int shmem_ctrlr_fd_client
+  = -1;
+
+/**
+ * static global variable: Sequence number of request for shmem controller
+ */
+static uint32_t shmem_ctrlr_seq
+  = 0;
+
+/**
+ * static global variable: mutex for the persistent connection with shmem controller
+ */
+static pthread_mutex_t shmem_ctrlr_client_mutex
+  = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * static global variable: Pipe to notify the launcher that shmem controller is ready
+ *                         (set only in the process forked by fpga_shmem_controller_init())
+ */
+static int shmem_ctrlr_ready_fd
+  = -1;
+
+
 /**
  * static global variable: Listen port for shmem controller's notice thread
  */
@@ -116,6 +179,21 @@ static char shmem_ctrlr_notice_listen_addr[32]
   = LOCALHOST;
 
 
+/**
+ * @brief Connect with shmem controller by Unix domain socket or TCP
+ */
+static int __fpga_shmem_controller_connect(void) {
+  if (shmem_ctrlr_unix_path[0])
+    return fpga_shmem_get_fd_client_unix(shmem_ctrlr_unix_path);
+
+  struct sockaddr_in client;
+  return fpga_shmem_get_fd_client(
+    &client,
+    shmem_ctrlr_listen_port,
+    shmem_ctrlr_listen_addr);
+}
+
+
 static void __fpga_shmem_fallingout_notification_thread(void) {
   llf_dbg("[%s]\n", __func__);
 
@@ -183,56 +261,62 @@ int fpga_shmem_controller_init(
   llf_dbg("%s(port(%d), addr(%s))\n", __func__, port, addr ? addr : "<null>");
 
   int ret;
+  int ready_pipe[2];
+
+  // Pipe for readiness notification from shmem controller
+  //  (not to be inherited by the programs which the user process executes)
+  if (pipe2(ready_pipe, O_CLOEXEC)) {
+    int err = errno;
+    llf_err(FAILURE_ESTABLISH, "Failed to create pipe for shmem_controller(errno:%d)\n", err);
+    return -FAILURE_ESTABLISH;
+  }
 
   // Launch shmem controller in background(at child process)
   pid_t pid = fork();
   if (pid < 0) {
     int err = errno;
     llf_err(FAILURE_FORK, "Failed to fork for shmem_controller(error:%d)\n", err);
+    close(ready_pipe[0]);
+    close(ready_pipe[1]);
     return -FAILURE_FORK;
   } else if (pid == 0) {
     // Change logfile from parent process to avoid being overwritten
     libfpga_log_reset_output_file();
     llf_dbg("[CONTROLLER] %s(port(%d), addr(%s)\n", __func__, port, addr ? addr : "<null>");
 
+    // Notify through the pipe when ready
+    close(ready_pipe[0]);
+    shmem_ctrlr_ready_fd = ready_pipe[1];
+
     // Execute shmem_controller
     ret = fpga_shmem_controller_launch(port, addr ? addr : "<null>");
 
     // Should not return main process
     exit(abs(ret));
   }
+  close(ready_pipe[1]);
 
-  // Wait for shmem controller launching
-  struct sockaddr_in connector;
-  fpga_shmem_ctrl_info_t command;
-  command.cmd = SHMEM_CTRL_CMD_INITIALIZE;
-  shmem_socket_response_t *recv_response = NULL;
-  socklen_t recv_len;
-  for (int chkcnt = 0; chkcnt < SHMEM_MAX_CHKCNT; chkcnt++) {
-    sleep(1);
-    llf_dbg(" Check connection with shmem controller(%d/%d) start.\n", chkcnt + 1, SHMEM_MAX_CHKCNT);
-    int client_fd = fpga_shmem_get_fd_client(
-      &connector,
-      shmem_ctrlr_listen_port,
-      shmem_ctrlr_listen_addr);
-    if (client_fd < 0) {
-      continue;
-    }
-    recv_response = NULL;
-    (void)fpga_shmem_send(client_fd, (void*)&command, sizeof(command));  // NOLINT
-    (void)fpga_shmem_recv(client_fd, (void**)&recv_response, &recv_len);  // NOLINT
-    if (recv_response && (*recv_response && RES_INIT)) {
-      llf_dbg(" Check connection with shmem controller(%d/%d) OK.\n", chkcnt + 1, SHMEM_MAX_CHKCNT);
-      free(recv_response);
-      close(client_fd);
-      break;
-    }
-    llf_dbg(" Check connection with shmem controller(%d/%d) NG...\n", chkcnt + 1, SHMEM_MAX_CHKCNT);
-
-    if (recv_response)
-      free(recv_response);
-    close(client_fd);
+  // Wait for shmem controller launching:
+  //  shmem controller writes 1 byte when it starts listening, and
+  //  the pipe is closed without writing when it exits.
+  struct pollfd pfd = { .fd = ready_pipe[0], .events = POLLIN };
+  char ready = 0;
+  do {
+    ret = poll(&pfd, 1, SHMEM_MAX_CHKCNT * 1000);
+  } while (ret < 0 && errno == EINTR);
+  if (ret > 0 && read(ready_pipe[0], &ready, sizeof(ready)) == sizeof(ready) && ready) {
+    llf_dbg(" Check connection with shmem controller OK.\n");
+  } else {
+    llf_err(FAILURE_ESTABLISH, " Check connection with shmem controller NG(%s)...\n",
+      ret == 0 ? "timeout" : "not launched");
+    close(ready_pipe[0]);
+    // Do not leave the controller which is not ready behind
+    if (ret == 0)
+      kill(pid, SIGTERM);
+    __fpga_shmem_reap_child(pid, SHMEM_CTRL_EXIT_TIMEOUT_MS);
+    return -FAILURE_ESTABLISH;
   }
+  close(ready_pipe[0]);
 
   if (!fpga_shmem_recv_tid) {
     ret = pthread_create(
@@ -253,10 +337,8 @@ int fpga_shmem_controller_init(
 
 static int __fpga_shmem_controller_execute(
   int fd,
-  fpga_shmem_ctrl_info_t command,
-  shmem_socket_response_t *send_response,
-  void **send_data,
-  socklen_t *send_len
+  const fpga_shmem_ctrl_info_t *command,
+  fpga_shmem_ctrl_res_t *response
 ) {
   llf_dbg("%s(fd(%d))\n", __func__, fd);
 
@@ -265,62 +347,64 @@ static int __fpga_shmem_controller_execute(
 
   char lock_file[SHMEM_MAX_FILE_NAME_LEN];
 
-  *send_response = RES_OK;
+  response->seq = command->seq;
+  response->response = RES_OK;
+  response->value = 0;
 
-  switch (command.cmd) {
+  switch (command->cmd) {
   case SHMEM_CTRL_CMD_START:
     // Launch shmem manager with file_prefix/socket_limit
     llf_dbg(" SHMEM_CTRL_CMD_START\n");
-    sprintf(lock_file, SHMEM_FMT_FLOCK_FILE, command.file_prefix);  // NOLINT
+    sprintf(lock_file, SHMEM_FMT_FLOCK_FILE, command->file_prefix);  // NOLINT
     ret = fpga_shmem_manager_init(
-      command.file_prefix,
-      command.socket_limit,
+      command->file_prefix,
+      command->socket_limit,
       NULL,
       fpga_shmem_callback_function,
       (void*)lock_file);  // NOLINT
     if (ret) {
-      *send_response = RES_NG;
+      response->response = RES_NG;
     }
     break;
 
   case SHMEM_CTRL_CMD_START_DEFAULT_SIZE:
     // Launch shmem manager with file_prefix and WITHOUT socket_limit
     llf_dbg(" SHMEM_CTRL_CMD_START_DEFAULT_SIZE\n");
-    sprintf(lock_file, SHMEM_FMT_FLOCK_FILE, command.file_prefix);  // NOLINT
+    sprintf(lock_file, SHMEM_FMT_FLOCK_FILE, command->file_prefix);  // NOLINT
     ret = fpga_shmem_manager_init(
-      command.file_prefix,
+      command->file_prefix,
       NULL,
       NULL,
       fpga_shmem_callback_function,
       (void*)lock_file);  // NOLINT
     if (ret) {
-      *send_response = RES_NG;
+      response->response = RES_NG;
     }
     break;
 
   case SHMEM_CTRL_CMD_STOP:
     // Finish shmem manager which matches file_prefix
     llf_dbg(" SHMEM_CTRL_CMD_STOP\n");
-    ret = fpga_shmem_manager_finish(command.file_prefix);
+    ret = fpga_shmem_manager_finish(command->file_prefix);
 
     // Check if the same file_prefix manager is already dead or not
     if (ret && ret != -MISMATCH_FILE_PREFIX) {
-      *send_response = RES_NG;
+      response->response = RES_NG;
     }
     if (ret == -MISMATCH_FILE_PREFIX) {
-      llf_dbg(" No need to stop shmem manager(%s)\n", command.file_prefix);
+      llf_dbg(" No need to stop shmem manager(%s)\n", command->file_prefix);
     }
 
     /* Delete lock file(used for user pod's finish detect).
      *  The lock_file should have been deleted by fpga_shmem_menager_finish(),
      *  but, in case, try to delete lock_file by controller.*/
-    sprintf(lock_file, SHMEM_FMT_FLOCK_FILE, command.file_prefix);  // NOLINT
+    sprintf(lock_file, SHMEM_FMT_FLOCK_FILE, command->file_prefix);  // NOLINT
     do {
       ret = unlink(lock_file);
       err = errno;
     } while (ret && err == EBUSY);
     if (ret && err != ENOENT) {
-      *send_response = RES_NG;
+      response->response = RES_NG;
       llf_err(LIBFPGA_FATAL_ERROR, " Failed to delete %s(errno:%d)\n", lock_file, err);
     } else {
       llf_dbg(" Succeed to delete %s.\n", lock_file);
@@ -330,22 +414,22 @@ static int __fpga_shmem_controller_execute(
   case SHMEM_CTRL_CMD_GET_MANAGER_PID:
     // Get pid of shmem manager(alive > 0)
     llf_dbg(" SHMEM_CTRL_CMD_GET_MANAGER_PID\n");
-    *send_len = sizeof(pid_t);
-    *((pid_t**)send_data) = (pid_t*)malloc(*send_len);  // NOLINT
-    **((pid_t**)send_data) = fpga_shmem_get_pid_from_prefix(command.file_prefix); // NOLINT
-    llf_dbg("  file_prefix(%s) : PID(%d)\n", command.file_prefix, **((pid_t**)send_data));  // NOLINT
+    response->value = fpga_shmem_get_pid_from_prefix(command->file_prefix);
+    llf_dbg("  file_prefix(%s) : PID(%d)\n", command->file_prefix, response->value);
     break;
 
   case SHMEM_CTRL_CMD_GET_AVAIL:
     // Get num of available hugepages
     llf_dbg(" SHMEM_CTRL_CMD_GET_AVAIL\n");
-    llf_info("  fpga_shmem_get_available_pages() = %d\n", fpga_shmem_get_available_pages());
+    response->value = fpga_shmem_get_available_pages();
+    llf_info("  fpga_shmem_get_available_pages() = %d\n", response->value);
     break;
 
   case SHMEM_CTRL_CMD_GET_LIMIT:
     // Get max num of available hugepages
     llf_dbg(" SHMEM_CTRL_CMD_GET_LIMIT\n");
-    llf_info("  fpga_shmem_get_available_limit() = %d\n", fpga_shmem_get_available_limit());
+    response->value = fpga_shmem_get_available_limit();
+    llf_info("  fpga_shmem_get_available_limit() = %d\n", response->value);
     break;
 
   case SHMEM_CTRL_CMD_GET_INFO:
@@ -357,7 +441,7 @@ static int __fpga_shmem_controller_execute(
   case SHMEM_CTRL_CMD_INITIALIZE:
     // Return Initialize Success
     llf_dbg(" SHMEM_CTRL_CMD_INITIALIZE\n");
-    *send_response = RES_INIT;
+    response->response = RES_INIT;
     break;
 
   case SHMEM_CTRL_CMD_FINISH_MANAGERS_ALL:
@@ -368,10 +452,11 @@ static int __fpga_shmem_controller_execute(
       llf_err(-ret, " Failed to finish all shmem managers\n");
     else
       llf_dbg(" Succeed to finish all shmem managers.\n");
-    *send_response = RES_QUIT;
+    response->response = RES_QUIT;
     break;
 
   default:
+    response->response = RES_NG;
     break;
   }
   return ret;
@@ -399,15 +484,11 @@ int fpga_shmem_controller_launch(
 
   int ret;
 
-  int fd;
-  struct sockaddr_in server;
-
-  fpga_shmem_ctrl_info_t *recv_command = NULL;
-  socklen_t recv_len;
-
-  shmem_socket_response_t send_response;
-  void *send_data = NULL;
-  socklen_t send_len = 0;
+  // fds[0] : listen, fds[1...] : clients(-1 means empty)
+  struct pollfd fds[1 + SHMEM_CTRL_MAX_CLIENTS];
+  fpga_shmem_ctrl_info_t recv_command;
+  fpga_shmem_ctrl_res_t send_response;
+  bool is_quit = false;
 
   // Set sigaction to finish shmem_manager safely
   ret = fpga_shmem_set_signal();
@@ -416,164 +497,138 @@ int fpga_shmem_controller_launch(
     return ret;
   }
 
-  // Establish connection with shmem launcher
-reconnect:
-  fd = fpga_shmem_get_fd_server(
-    &server,
-    shmem_ctrlr_listen_port,
-    shmem_ctrlr_listen_addr);
-  if (fd < 0) {
-    llf_err(-fd, "Failed to establish connection...\n");
-    sleep(1);
-    goto reconnect;
-  }
-
+  // Listen for shmem launcher and requesters
   do {
-    // Receive command
-    ret = fpga_shmem_recv(fd, (void**)&recv_command, &recv_len);  // NOLINT
-    if (ret == 1) {
-      /* *** connection lost *** */
-      close(fd);
-      fd = -1;
-      goto reconnect;
-    } else if (ret < 0) {
-      send_response = RES_NG;
-      ret = fpga_shmem_send(fd, &send_response, sizeof(send_response));
-      if (ret)
-        llf_err(-ret, "Failed to send reponse of getting command...\n");
-      continue;
+    if (shmem_ctrlr_unix_path[0])
+      fds[0].fd = fpga_shmem_get_fd_listen_unix(shmem_ctrlr_unix_path);
+    else
+      fds[0].fd = fpga_shmem_get_fd_listen(shmem_ctrlr_listen_port, shmem_ctrlr_listen_addr);
+    if (fds[0].fd < 0) {
+      llf_err(-fds[0].fd, "Failed to establish connection...\n");
+      sleep(1);
     }
-    if (!recv_command)
-      continue;
-
-    // Execute shmem controller task
-    (void)__fpga_shmem_controller_execute(fd, *recv_command, &send_response, &send_data, &send_len);  // NOLINT
-    free(recv_command);
-    recv_command = NULL;
+  } while (fds[0].fd < 0);
+  fds[0].events = POLLIN;
+  for (int i = 1; i <= SHMEM_CTRL_MAX_CLIENTS; i++) {
+    fds[i].fd = -1;
+    fds[i].events = POLLIN;
+  }
 
-    // send response
-    ret = fpga_shmem_send(fd, &send_response, sizeof(send_response));
-    if (ret)
-      llf_err(-ret, "Failed to send reponse of executing command...\n");
-    if (send_response == RES_OK) {
-      ret = fpga_shmem_send(fd, send_data, send_len);
-      if (ret)
-        llf_err(-ret, "Failed to send data of executing command...\n");
-      if (send_data)
-        free(send_data);
-      send_data = NULL;
-      send_len = 0;
+  // Notify the launcher that shmem controller is ready to accept requests
+  if (shmem_ctrlr_ready_fd >= 0) {
+    char ready = 1;
+    if (write(shmem_ctrlr_ready_fd, &ready, sizeof(ready)) != sizeof(ready)) {
+      int err = errno;
+      llf_err(FAILURE_WRITE, "Failed to notify readiness(errno:%d)\n", err);
     }
+    close(shmem_ctrlr_ready_fd);
+    shmem_ctrlr_ready_fd = -1;
+  }
 
-    // Check finish
-    if (send_response == RES_QUIT) {
-      // Get command to finish all managers and controller self
+  // Serve requests from all the connections until finish command.
+  //  Each connection is kept by the requester, and requests on it are
+  //  pipelined : they are handled and responded in the order of arrival.
+  while (!is_quit) {
+    ret = poll(fds, 1 + SHMEM_CTRL_MAX_CLIENTS, -1);
+    if (ret < 0) {
+      int err = errno;
+      if (err == EINTR)
+        continue;
+      llf_err(FAILURE_ESTABLISH, "Failed to poll(errno:%d)\n", err);
       sleep(1);
-      break;
+      continue;
     }
-  }while(1);
 
-  close(fd);
-  llf_dbg("%s() finish by right operation\n", __func__);
-  return 0;
-}
+    // Accept a new connection
+    if (fds[0].revents & POLLIN) {
+      int fd = accept(fds[0].fd, NULL, NULL);
+      if (fd >= 0) {
+        int index;
+        for (index = 1; index <= SHMEM_CTRL_MAX_CLIENTS; index++) {
+          if (fds[index].fd < 0)
+            break;
+        }
+        if (index > SHMEM_CTRL_MAX_CLIENTS) {
+          llf_err(FULL_ELEMENT, "Too many connections(max:%d)\n", SHMEM_CTRL_MAX_CLIENTS);
+          close(fd);
+        } else {
+          llf_dbg(" accept success[%d:%d]\n", fds[0].fd, fd);
+          fds[index].fd = fd;
+        }
+      }
+    }
 
+    // Handle requests
+    for (int index = 1; index <= SHMEM_CTRL_MAX_CLIENTS && !is_quit; index++) {
+      if (fds[index].fd < 0 || !fds[index].revents)
+        continue;
+
+      // Receive command
+      ret = fpga_shmem_recv_frame(fds[index].fd, &recv_command, sizeof(recv_command));
+      if (ret) {
+        /* *** connection lost *** */
+        close(fds[index].fd);
+        fds[index].fd = -1;
+        continue;
+      }
 
-static int __fpga_shmem_controller_request(
-  fpga_shmem_ctrl_info_t command,
-  void *data
-) {
-  // Check validity of command
-  switch (command.cmd) {
-  case SHMEM_CTRL_CMD_START:
-  case SHMEM_CTRL_CMD_START_DEFAULT_SIZE:
-  case SHMEM_CTRL_CMD_STOP:
-  case SHMEM_CTRL_CMD_GET_LIMIT:
-  case SHMEM_CTRL_CMD_GET_AVAIL:
-  case SHMEM_CTRL_CMD_GET_INFO:
-  case SHMEM_CTRL_CMD_GET_MANAGER_PID:
-  case SHMEM_CTRL_CMD_FINISH_MANAGERS_ALL:
-    break;
-  default:
-    llf_err(INVALID_ARGUMENT, "Invalid operation: %d is not supported...\n", command.cmd);
-    return -INVALID_ARGUMENT;
-  }
+      // Execute shmem controller task
+      (void)__fpga_shmem_controller_execute(fds[index].fd, &recv_command, &send_response);  // NOLINT
 
-  llf_dbg("%s(command(%d), data(%#llx))\n", __func__, command.cmd, (uintptr_t)data);
-  int ret;
+      // send response
+      ret = fpga_shmem_send_frame(fds[index].fd, &send_response, sizeof(send_response));
+      if (ret)
+        llf_err(-ret, "Failed to send reponse of executing command...\n");
 
-  // Establish connection with shmem controller
-  struct sockaddr_in client;
-  static int fd_client = -1;
-  if (fd_client < 0) {
-    fd_client = fpga_shmem_get_fd_client(
-      &client,
-      shmem_ctrlr_listen_port,
-      shmem_ctrlr_listen_addr);
-    if (fd_client < 0) {
-      llf_err(FAILURE_ESTABLISH, "Failed to connect with shmem controller(%d)\n", fd_client);
-      return -FAILURE_ESTABLISH;
+      // Check finish
+      if (send_response.response == RES_QUIT)
+        is_quit = true;
     }
   }
 
-  // Send command
-  ret = fpga_shmem_send(fd_client, (void*)&command, sizeof(command));  // NOLINT
-  if (ret < 0) {
-    llf_err(FAILURE_TRANSFER, "Failed to send data to shmem controller(%d)\n", ret);
-    return -FAILURE_TRANSFER;
+  for (int index = 1; index <= SHMEM_CTRL_MAX_CLIENTS; index++) {
+    if (fds[index].fd >= 0)
+      close(fds[index].fd);
   }
+  close(fds[0].fd);
+  if (shmem_ctrlr_unix_path[0])
+    unlink(shmem_ctrlr_unix_path);
+  llf_dbg("%s() finish by right operation\n", __func__);
+  return 0;
+}
 
-  // Receive response(OK/NG/quit)
-  shmem_socket_response_t *recv_response = NULL;
-  socklen_t recv_len;
-  ret = fpga_shmem_recv(fd_client, (void**)&recv_response, &recv_len);  // NOLINT
-  if (ret < 0 || !recv_response) {
-    llf_err(FAILURE_TRANSFER, "Failed to recv response from shmem controller(%d)\n", ret);
-    return -FAILURE_TRANSFER;
-  }
 
-  // Receive response(data)
-  void *recv_data = NULL;
-  if (*recv_response == RES_OK) {
-    ret = fpga_shmem_recv(fd_client, &recv_data, &recv_len);
-    if (ret < 0) {
-      free(recv_response);
-      llf_err(FAILURE_TRANSFER, "Failed to recv data from shmem controller(%d)\n", ret);
-      return -FAILURE_TRANSFER;
-    }
-  }
+/**
+ * @brief Check the response from shmem controller
+ */
+static int __fpga_shmem_controller_check_response(
+  const fpga_shmem_ctrl_info_t *command,
+  const fpga_shmem_ctrl_res_t *response,
+  void *data
+) {
+  int ret;
 
   // Switch(response)
-  switch (*recv_response) {
+  switch (response->response) {
   case RES_QUIT:
     ret = RES_QUIT;
     llf_dbg(" Accept for finishing shmem controller\n");
-    close(fd_client);
-    fd_client = -1;
     break;
 
   case RES_OK:
     ret = 0;
     // Switch(command)
-    switch (command.cmd) {
+    switch (command->cmd) {
     case SHMEM_CTRL_CMD_GET_MANAGER_PID:
-      *((pid_t*)data) = *((pid_t*)recv_data);  // NOLINT
-      llf_dbg(" (prefix,PID) = (%s,%d)\n", command.file_prefix, *((pid_t*)data));  // NOLINT
+      if (data)
+        *((pid_t*)data) = (pid_t)response->value;  // NOLINT
+      llf_dbg(" (prefix,PID) = (%s,%d)\n", command->file_prefix, response->value);
       break;
     case SHMEM_CTRL_CMD_GET_AVAIL:
     case SHMEM_CTRL_CMD_GET_LIMIT:
-      llf_dbg(" recv_data = %d\n", (*(int*)recv_data));  // NOLINT
-      break;
-    case SHMEM_CTRL_CMD_GET_INFO:
-      llf_dbg("file_prefix     hugepage_limit  pid             is_initialized  \n");
-      fpga_shmem_manager_info_t *shmem_dumped_data = (fpga_shmem_manager_info_t*)recv_data; // NOLINT
-      for (int index = 0; index < SHMEM_MAX_HUGEPAGES; index++) {
-        llf_dbg("%-16s%-16d%-16d%-8d\n",
-          shmem_dumped_data[index].file_prefix,
-          shmem_dumped_data[index].hp_limit,
-          shmem_dumped_data[index].pid,
-          shmem_dumped_data[index].is_initialized);
-      }
+      if (data)
+        *((int*)data) = response->value;  // NOLINT
+      llf_dbg(" recv_data = %d\n", response->value);
       break;
     default:
       break;
@@ -583,32 +638,149 @@ static int __fpga_shmem_controller_request(
   default:
     ret = -FAILURE_CONTROLLER;
     // Switch(command)
-    switch (command.cmd) {
+    switch (command->cmd) {
     case SHMEM_CTRL_CMD_START:
     case SHMEM_CTRL_CMD_START_DEFAULT_SIZE:
-      llf_err(-ret, "Failed to establish Manager(%s)\n", command.file_prefix);
+      llf_err(-ret, "Failed to establish Manager(%s)\n", command->file_prefix);
       break;
     case SHMEM_CTRL_CMD_STOP:
-      llf_err(-ret, "Failed to finish Manager(%s)\n", command.file_prefix);
+      llf_err(-ret, "Failed to finish Manager(%s)\n", command->file_prefix);
       break;
     case SHMEM_CTRL_CMD_GET_MANAGER_PID:
-      llf_err(-ret, "Failed to get Manager PID of %s\n", command.file_prefix);
+      llf_err(-ret, "Failed to get Manager PID of %s\n", command->file_prefix);
       break;
     default:
-      llf_err(-ret, "Failed to execute command: %d\n", command.cmd);
+      llf_err(-ret, "Failed to execute command: %d\n", command->cmd);
       break;
     }  // Switch(command)
     break;
   }  // Switch(response)
 
-  free(recv_response);
-  if (recv_data)
-    free(recv_data);
+  return ret;
+}
+
+
+/**
+ * @brief Send commands to shmem controller in pipeline and receive all the responses
+ * @details
+ *   All the commands are sent before receiving any response through the persistent connection,
+ *    so `num` requests cost one round trip.@n
+ *   When the connection is found lost before any response is received
+ *    (e.g. shmem controller has been relaunched), reconnect and send the commands again once.
+ */
+static int __fpga_shmem_controller_request_multi(
+  fpga_shmem_ctrl_info_t command[],
+  int num,
+  fpga_shmem_ctrl_res_t response[]
+) {
+  // Check validity of command
+  for (int i = 0; i < num; i++) {
+    switch (command[i].cmd) {
+    case SHMEM_CTRL_CMD_START:
+    case SHMEM_CTRL_CMD_START_DEFAULT_SIZE:
+    case SHMEM_CTRL_CMD_STOP:
+    case SHMEM_CTRL_CMD_GET_LIMIT:
+    case SHMEM_CTRL_CMD_GET_AVAIL:
+    case SHMEM_CTRL_CMD_GET_INFO:
+    case SHMEM_CTRL_CMD_GET_MANAGER_PID:
+    case SHMEM_CTRL_CMD_FINISH_MANAGERS_ALL:
+      break;
+    default:
+      llf_err(INVALID_ARGUMENT, "Invalid operation: %d is not supported...\n", command[i].cmd);
+      return -INVALID_ARGUMENT;
+    }
+  }
+
+  llf_dbg("%s(command(%#llx), num(%d), response(%#llx))\n",
+    __func__, (uintptr_t)command, num, (uintptr_t)response);
+  int ret = 0;
+
+  pthread_mutex_lock(&shmem_ctrlr_client_mutex);
+
+  for (int retry = 0; retry < 2; retry++) {
+    // Establish connection with shmem controller
+    if (shmem_ctrlr_fd_client < 0) {
+      shmem_ctrlr_fd_client = __fpga_shmem_controller_connect();
+      if (shmem_ctrlr_fd_client < 0) {
+        llf_err(FAILURE_ESTABLISH, "Failed to connect with shmem controller(%d)\n", shmem_ctrlr_fd_client);
+        ret = -FAILURE_ESTABLISH;
+        break;
+      }
+    }
+
+    // Send commands
+    ret = 0;
+    bool resendable = false;
+    for (int i = 0; i < num; i++) {
+      command[i].seq = ++shmem_ctrlr_seq;
+      int send_ret = fpga_shmem_send_frame(shmem_ctrlr_fd_client, &command[i], sizeof(command[i]));
+      if (send_ret) {
+        // Resend only when nothing is written, i.e. the controller executed none of them
+        resendable = i == 0 && send_ret < 0;
+        ret = -FAILURE_TRANSFER;
+        break;
+      }
+    }
+
+    // Receive responses
+    int received = 0;
+    if (!ret) {
+      for (; received < num; received++) {
+        int recv_ret = fpga_shmem_recv_frame(
+          shmem_ctrlr_fd_client, &response[received], sizeof(response[received]));
+        if (recv_ret || response[received].seq != command[received].seq) {
+          ret = -FAILURE_TRANSFER;
+          break;
+        }
+      }
+    }
+    if (!ret)
+      break;
+
+    // Connection is broken, so close it
+    close(shmem_ctrlr_fd_client);
+    shmem_ctrlr_fd_client = -1;
+    if (!resendable) {
+      // Some commands may be already executed, so do not send them again
+      break;
+    }
+    llf_dbg(" Connection with shmem controller is lost, reconnect(%d)\n", retry);
+  }
+  if (ret == -FAILURE_TRANSFER)
+    llf_err(FAILURE_TRANSFER, "Failed to transfer data with shmem controller\n");
+
+  // Close connection when shmem controller accepted to finish
+  if (!ret) {
+    for (int i = 0; i < num; i++) {
+      if (response[i].response == RES_QUIT) {
+        close(shmem_ctrlr_fd_client);
+        shmem_ctrlr_fd_client = -1;
+        break;
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&shmem_ctrlr_client_mutex);
 
   return ret;
 }
 
 
+static int __fpga_shmem_controller_request(
+  fpga_shmem_ctrl_info_t command,
+  void *data
+) {
+  llf_dbg("%s(command(%d), data(%#llx))\n", __func__, command.cmd, (uintptr_t)data);
+
+  fpga_shmem_ctrl_res_t response;
+  int ret = __fpga_shmem_controller_request_multi(&command, 1, &response);
+  if (ret)
+    return ret;
+
+  return __fpga_shmem_controller_check_response(&command, &response, data);
+}
+
+
 int fpga_shmem_enable(
   const char *file_prefix,
   const uint32_t socket_limit[]
@@ -826,6 +998,96 @@ int fpga_shmem_check_inuse(
 }
 
 
+// cppcheck-suppress unusedFunction
+int fpga_shmem_get_manager_pid_multi(
+  const char *file_prefix[],
+  int num,
+  pid_t pid[]
+) {
+  if (!file_prefix || num <= 0 || !pid) {
+    llf_err(INVALID_ARGUMENT, "%s(file_prefix(%#llx), num(%d), pid(%#llx))\n",
+      __func__, (uintptr_t)file_prefix, num, (uintptr_t)pid);
+    return -INVALID_ARGUMENT;
+  }
+  for (int i = 0; i < num; i++) {
+    if (!file_prefix[i]) {
+      llf_err(INVALID_ARGUMENT, "%s(file_prefix[%d](<null>))\n", __func__, i);
+      return -INVALID_ARGUMENT;
+    }
+  }
+  llf_dbg("%s(file_prefix(%#llx), num(%d), pid(%#llx))\n",
+    __func__, (uintptr_t)file_prefix, num, (uintptr_t)pid);
+
+  int ret = 0;
+  fpga_shmem_ctrl_info_t *command = NULL;
+  fpga_shmem_ctrl_res_t *response = NULL;
+
+  command = (fpga_shmem_ctrl_info_t*)calloc(num, sizeof(*command));  // NOLINT
+  response = (fpga_shmem_ctrl_res_t*)calloc(num, sizeof(*response));  // NOLINT
+  if (!command || !response) {
+    llf_err(FAILURE_MEMORY_ALLOC, "Failed to allocate memory for requests.\n");
+    ret = -FAILURE_MEMORY_ALLOC;
+    goto finish;
+  }
+
+  for (int i = 0; i < num; i++) {
+    strncpy(command[i].file_prefix, file_prefix[i], sizeof(command[i].file_prefix) - 1);
+    command[i].cmd = SHMEM_CTRL_CMD_GET_MANAGER_PID;
+  }
+
+  // Send all requests at once and receive all responses
+  ret = __fpga_shmem_controller_request_multi(command, num, response);
+  if (ret)
+    goto finish;
+
+  for (int i = 0; i < num; i++) {
+    int res = __fpga_shmem_controller_check_response(&command[i], &response[i], &pid[i]);
+    if (res && !ret)
+      ret = res;
+  }
+
+finish:
+  if (command)
+    free(command);
+  if (response)
+    free(response);
+
+  return ret;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_shmem_check_inuse_multi(
+  const char *file_prefix[],
+  int num,
+  uint32_t is_inuse[]
+) {
+  if (!file_prefix || num <= 0 || !is_inuse) {
+    llf_err(INVALID_ARGUMENT, "%s(file_prefix(%#llx), num(%d), is_inuse(%#llx))\n",
+      __func__, (uintptr_t)file_prefix, num, (uintptr_t)is_inuse);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(file_prefix(%#llx), num(%d), is_inuse(%#llx))\n",
+    __func__, (uintptr_t)file_prefix, num, (uintptr_t)is_inuse);
+
+  pid_t *pid = (pid_t*)calloc(num, sizeof(pid_t));  // NOLINT
+  if (!pid) {
+    llf_err(FAILURE_MEMORY_ALLOC, "Failed to allocate memory for pid.\n");
+    return -FAILURE_MEMORY_ALLOC;
+  }
+
+  int ret = fpga_shmem_get_manager_pid_multi(file_prefix, num, pid);
+  if (!ret) {
+    for (int i = 0; i < num; i++)
+      is_inuse[i] = pid[i] > 0 ? true : false;
+  }
+
+  free(pid);
+
+  return ret;
+}
+
+
 // cppcheck-suppress unusedFunction
 int fpga_shmem_controller_finish(void) {
   llf_dbg("%s()\n", __func__);
@@ -1062,6 +1324,61 @@ int fpga_shmem_controller_get_ip(
 }
 
 
+// cppcheck-suppress unusedFunction
+int fpga_shmem_controller_set_unix_path(
+  const char *path
+) {
+  llf_dbg("%s(path(%s))\n", __func__, path ? path : "<null>");
+
+  pthread_mutex_lock(&shmem_ctrlr_client_mutex);
+
+  if (path && strlen(path) >= sizeof(((struct sockaddr_un*)0)->sun_path)) {  // NOLINT
+    pthread_mutex_unlock(&shmem_ctrlr_client_mutex);
+    llf_err(INVALID_ARGUMENT, "%s(path(%s)) is too long\n", __func__, path);
+    return -INVALID_ARGUMENT;
+  }
+
+  memset(shmem_ctrlr_unix_path, 0, sizeof(shmem_ctrlr_unix_path));
+  if (path)
+    strncpy(shmem_ctrlr_unix_path, path, sizeof(shmem_ctrlr_unix_path) - 1);
+
+  // Transport is changed, so drop the persistent connection
+  if (shmem_ctrlr_fd_client >= 0) {
+    close(shmem_ctrlr_fd_client);
+    shmem_ctrlr_fd_client = -1;
+  }
+
+  pthread_mutex_unlock(&shmem_ctrlr_client_mutex);
+
+  return 0;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_shmem_controller_get_unix_path(
+  char **path
+) {
+  if (!path) {
+    llf_err(INVALID_ARGUMENT, "%s(path(<null>))\n", __func__);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(path(%#llx))\n", __func__, (uintptr_t)path);
+
+  if (!shmem_ctrlr_unix_path[0]) {
+    *path = NULL;
+    return 0;
+  }
+
+  *path = strdup(shmem_ctrlr_unix_path);
+  if (!*path) {
+    llf_err(FAILURE_MEMORY_ALLOC, "Failed to allocate memory for Unix domain socket path of shmem_controller.\n");
+    return -FAILURE_MEMORY_ALLOC;
+  }
+
+  return 0;
+}
+
+
 // cppcheck-suppress unusedFunction
 int fpga_shmem_controller_set_ip_notice(
   unsigned short port,
@@ -4,17 +4,26 @@
 * SPDX-License-Identifier: BSD-3-Clause
 *************************************************/
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // pipe2()
+#endif
 #include <libshmem_manager.h>
 #include <liblogging.h>
 
 #include <libfpga_internal/libdpdkutil.h>
 #include <libfpga_internal/libshmem_internal.h>
 
+#include <poll.h>
+#include <time.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/file.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
 
 
 // LogLibFpga
@@ -24,9 +33,23 @@
 
 
 /**
- * Definition of format for file which transfer data with shmem manager and caller
+ * Max time(ms) to wait for shmem manager's DPDK initialization
  */
-#define SHMEM_PARENT_CHILD_TSF          "/var/run/dpdk/%s/tsf"
+#define SHMEM_CHILD_INIT_TIMEOUT_MS     (60 * 1000)
+
+/**
+ * Interval(ms) of shmem manager to call the callback function
+ */
+#define SHMEM_CHILD_LOOP_INTERVAL_MS    500
+
+/**
+ * Max time(ms) to wait for shmem manager exiting after it failed to initialize
+ */
+#define SHMEM_CHILD_EXIT_TIMEOUT_MS     (5 * 1000)
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open                  434  /**< pidfd_open(2) for old libc headers */
+#endif
 
 
 /**
@@ -46,6 +69,22 @@ enum SHMEM_IS_INITIALIZED{
  */
 static fpga_shmem_manager_info_t manager_infos[SHMEM_MAX_HUGEPAGES];
 
+/**
+ * static global variable: pidfd of each ShmemManager(-1 : not supervised by pidfd)
+ */
+static int manager_pidfds[SHMEM_MAX_HUGEPAGES] = { [0 ... SHMEM_MAX_HUGEPAGES - 1] = -1 };
+
+/**
+ * static global variable: epoll fd to wait for the exit of ShmemManagers through pidfds
+ */
+static int manager_epoll_fd = -1;
+
+/**
+ * static global variable: Num of ShmemManagers which are not supervised by pidfd
+ *                         (pidfd_open() is not supported), these are checked by waitpid()
+ */
+static int manager_num_unsupervised = 0;
+
 /**
  * static global variable: Flag to check ShmemController's signal for finish
  */
@@ -174,63 +213,183 @@ static int __remove_hugedir(
 }
 
 
+/**
+ * @brief Start supervising the ShmemManager of specified index by pidfd
+ */
+static void __fpga_shmem_supervise_manager(
+  int index
+) {
+  if (manager_epoll_fd < 0) {
+    manager_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (manager_epoll_fd < 0) {
+      int err = errno;
+      llf_warn(FAILURE_INITIALIZE, "Failed to create epoll(errno:%d), use waitpid() instead.\n", err);
+    }
+  }
+
+  int pidfd = -1;
+  if (manager_epoll_fd >= 0)
+    pidfd = syscall(SYS_pidfd_open, manager_infos[index].pid, 0);
+  if (pidfd >= 0) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = index;
+    if (epoll_ctl(manager_epoll_fd, EPOLL_CTL_ADD, pidfd, &event)) {
+      close(pidfd);
+      pidfd = -1;
+    }
+  }
+  if (pidfd < 0) {
+    llf_dbg("Child process[%d] is supervised by waitpid().\n", manager_infos[index].pid);
+    manager_num_unsupervised++;
+  }
+  manager_pidfds[index] = pidfd;
+}
+
+
 /**
  * @brief clear data of specified index without checking if process finished or not
  */
 static void __fpga_shmem_reset_manager_info(
   int index
 ) {
+  if (manager_pidfds[index] >= 0) {
+    epoll_ctl(manager_epoll_fd, EPOLL_CTL_DEL, manager_pidfds[index], NULL);
+    close(manager_pidfds[index]);
+    manager_pidfds[index] = -1;
+  } else if (manager_infos[index].pid > 0) {
+    manager_num_unsupervised--;
+  }
   memset(&manager_infos[index], 0, sizeof(manager_infos[index]));
 }
 
 
 /**
- * @brief update managers_info
+ * @brief Reap the ShmemManager of specified index if it is dead
  */
-static void __fpga_shmem_check_health(void) {
+static void __fpga_shmem_reap_manager(
+  int index
+) {
   int pid;                // process id
   int status;             // status from waitpid
   int exit_stat;          // exit status of child process
-  int num_dead_proc = 0;  // the num of Dead process
-  for (int i = 0; i < fpga_shmem_get_available_limit(); i++) {
-    // Check all index
-    if (manager_infos[i].pid <= 0) {
-      // data is not set if pid is lesser than 0
-      // data is not controled by this process if pid is 0
-      continue;
+
+  pid = waitpid(manager_infos[index].pid, &status, WNOHANG);
+  if (pid == 0) {
+    // Child process is still alive, so skip
+    return;
+  }
+  if (pid < 0) {
+    // Child process is already reaped by someone
+    int err = errno;
+    llf_err(LIBFPGA_FATAL_ERROR, "Failed to wait Child process[%d](errno:%d).\n", manager_infos[index].pid, err);
+    __fpga_shmem_reset_manager_info(index);
+    return;
+  }
+  // Child process is dead
+  if (WIFEXITED(status)) {
+    // Child process normaly died
+    exit_stat = WEXITSTATUS(status);
+    if (exit_stat) {
+      // Child process finish in failure
+      llf_err(exit_stat, "Primary process detect Child process[%d] died in %d.\n", manager_infos[index].pid, exit_stat);
+      __fpga_shmem_reset_manager_info(index);
+    } else {
+      // Child process finish safely
+      llf_dbg("Primary process detect Child process[%d] finished safely.\n", manager_infos[index].pid);
+      char dirname[SHMEM_MAX_FILE_NAME_LEN];
+      memset(dirname, 0, sizeof(dirname));
+      snprintf(dirname, SHMEM_MAX_FILE_NAME_LEN, "/dev/hugepages/%s", manager_infos[index].file_prefix);
+      __remove_hugedir(dirname);
+      char rundir[SHMEM_MAX_FILE_NAME_LEN];
+      memset(rundir, 0, sizeof(rundir));
+      snprintf(rundir, SHMEM_MAX_FILE_NAME_LEN, "/var/run/dpdk/%s", manager_infos[index].file_prefix);
+      __remove_hugedir(rundir);
+      __fpga_shmem_reset_manager_info(index);
     }
-    pid = waitpid(manager_infos[i].pid, &status, WNOHANG);
-    if (pid == 0) {
-      // Child process is still alive, so skip
-      continue;
+  } else if (WIFSIGNALED(status)) {
+    // Child process is killed
+    llf_err(LIBFPGA_FATAL_ERROR, "Primary process detect Child process[%d] killed by signal %d.\n",
+      manager_infos[index].pid, WTERMSIG(status));
+    __fpga_shmem_reset_manager_info(index);
+  }
+}
+
+
+/**
+ * @brief update managers_info, waiting for the exit of managers up to `timeout_ms`
+ * @details
+ *   Only managers whose pidfd became readable are reaped,
+ *    so the cost does not depend on the num of alive managers.
+ */
+static void __fpga_shmem_check_health_wait(
+  int timeout_ms
+) {
+  // Managers which are not supervised by pidfd
+  if (manager_num_unsupervised > 0) {
+    for (int i = 0; i < SHMEM_MAX_HUGEPAGES; i++) {
+      if (manager_infos[i].pid > 0 && manager_pidfds[i] < 0)
+        __fpga_shmem_reap_manager(i);
     }
-    // Child process is dead
-    if (WIFEXITED(status)) {
-      // Child process normaly died
-      exit_stat = WEXITSTATUS(status);
-      if (exit_stat) {
-        // Child process finish in failure
-        llf_err(exit_stat, "Primary process detect Child process[%d] died in %d.\n", manager_infos[i].pid, exit_stat);
-        __fpga_shmem_reset_manager_info(i);
-        num_dead_proc++;
-      } else {
-        // Child process finish safely
-        llf_dbg("Primary process detect Child process[%d] finished safely.\n", manager_infos[i].pid);
-        char dirname[SHMEM_MAX_FILE_NAME_LEN];
-        memset(dirname, 0, sizeof(dirname));
-        snprintf(dirname, SHMEM_MAX_FILE_NAME_LEN, "/dev/hugepages/%s", manager_infos[i].file_prefix);
-        __remove_hugedir(dirname);
-        char rundir[SHMEM_MAX_FILE_NAME_LEN];
-        memset(rundir, 0, sizeof(rundir));
-        snprintf(rundir, SHMEM_MAX_FILE_NAME_LEN, "/var/run/dpdk/%s", manager_infos[i].file_prefix);
-        __remove_hugedir(rundir);
-        __fpga_shmem_reset_manager_info(i);
-      }
+  }
+
+  if (manager_epoll_fd < 0) {
+    if (timeout_ms > 0)
+      usleep(timeout_ms * 1000);
+    return;
+  }
+
+  // Managers which are supervised by pidfd
+  struct epoll_event events[SHMEM_MAX_HUGEPAGES];
+  int num;
+  do {
+    num = epoll_wait(manager_epoll_fd, events, SHMEM_MAX_HUGEPAGES, timeout_ms);
+  } while (num < 0 && errno == EINTR);
+  for (int i = 0; i < num; i++) {
+    int index = events[i].data.u32;
+    if (manager_infos[index].pid > 0)
+      __fpga_shmem_reap_manager(index);
+  }
+}
+
+
+/**
+ * @brief update managers_info
+ */
+static void __fpga_shmem_check_health(void) {
+  __fpga_shmem_check_health_wait(0);
+}
+
+
+/**
+ * @brief Close pidfds and epoll fd inherited by shmem manager process
+ */
+static void __fpga_shmem_close_supervisor(void) {
+  for (int i = 0; i < SHMEM_MAX_HUGEPAGES; i++) {
+    if (manager_pidfds[i] >= 0) {
+      close(manager_pidfds[i]);
+      manager_pidfds[i] = -1;
     }
   }
+  if (manager_epoll_fd >= 0) {
+    close(manager_epoll_fd);
+    manager_epoll_fd = -1;
+  }
+}
 
-  // the number of Child process which finish in failure(includes Callback function)
-  // return num_dead_proc;
+
+// cppcheck-suppress unusedFunction
+int fpga_shmem_manager_get_event_fd(void) {
+  if (manager_epoll_fd < 0) {
+    manager_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (manager_epoll_fd < 0) {
+      int err = errno;
+      llf_err(FAILURE_INITIALIZE, "%s(): Failed to create epoll(errno:%d)\n", __func__, err);
+      return -FAILURE_INITIALIZE;
+    }
+  }
+  return manager_epoll_fd;
 }
 
 
@@ -271,45 +430,86 @@ static int __fpga_shmem_set_manager_info(
 
 
 /**
- * @brief User process
+ * @brief Wait for the initializing status of shmem managers from the pipes all together
+ * @details
+ *   status[i] is set to SHMEM_NOT_INITIALIZED when the status is not notified in time,
+ *    and notify_fds are closed in this function.
+ */
+static void __fpga_shmem_parent_wait_status(
+  const pid_t pids[],
+  const int notify_fds[],
+  int status[],
+  int num
+) {
+  struct pollfd pfds[SHMEM_MAX_HUGEPAGES];
+  int num_waiting = num;
+
+  for (int i = 0; i < num; i++) {
+    status[i] = SHMEM_NOT_INITIALIZED;
+    pfds[i].fd = notify_fds[i];
+    pfds[i].events = POLLIN;
+    pfds[i].revents = 0;
+  }
+
+  // The pipe becomes readable when the status is written or the child died(EOF)
+  struct timespec now, deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += SHMEM_CHILD_INIT_TIMEOUT_MS / 1000;
+  while (num_waiting > 0) {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t timeout_ms = (deadline.tv_sec - now.tv_sec) * 1000
+      + (deadline.tv_nsec - now.tv_nsec) / 1000000;
+    if (timeout_ms < 0)
+      timeout_ms = 0;
+    int ret = poll(pfds, num, (int)timeout_ms);
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret <= 0)
+      break;
+    for (int i = 0; i < num; i++) {
+      if (pfds[i].fd < 0 || !pfds[i].revents)
+        continue;
+      ssize_t len;
+      do {
+        len = read(pfds[i].fd, &status[i], sizeof(status[i]));
+      } while (len < 0 && errno == EINTR);
+      if (len != sizeof(status[i]))
+        status[i] = SHMEM_NOT_INITIALIZED;
+      close(pfds[i].fd);
+      pfds[i].fd = -1;  // poll() ignores negative fd
+      num_waiting--;
+    }
+  }
+
+  // Managers which did not notify the status in time
+  for (int i = 0; i < num; i++) {
+    if (pfds[i].fd < 0)
+      continue;
+    llf_err(FAILURE_INITIALIZE, "Timeout: ShmemManager(pid:%d) did not notify its status.\n", pids[i]);
+    kill(pids[i], SIGKILL);
+    close(pfds[i].fd);
+  }
+}
+
+
+/**
+ * @brief User process: register the shmem manager according to its initializing status
  */
 static int __fpga_shmem_parent_process(
+  int index,
   pid_t pid,
+  int status,
   const char *file_prefix,
   const uint32_t socket_limit[]
 ) {
-  llf_dbg("%s(pid(%d), file_prefix(%s), limit(%#llx))\n", __func__, pid, file_prefix, (uint64_t)socket_limit);
-
-  // Get the smallest and free index
-  int index = __fpga_shmem_get_index();
-  if (index < 0) {
-    llf_err(FULL_ELEMENT, "Invalid operation: List for management is full.\n");
-    return -FULL_ELEMENT;
-  }
-  llf_dbg(" Got index : %d\n", index);
-
-  // Data transfer file between parent and child process
-  // File will be made by child process
-  char filename[SHMEM_MAX_FILE_NAME_LEN];
-  sprintf(filename, SHMEM_PARENT_CHILD_TSF, file_prefix);  // NOLINT
-  FILE *fp;
-  unsigned int count = 0;
-  do {
-    usleep(50 * 1000);
-    count++;
-    if (count > 1200)
-      goto CHILD_INIT;
-  }while(!(fp = fopen(filename, "r")));
-  while (!fscanf(fp, "%d", &manager_infos[index].is_initialized))
-      continue;
-  fclose(fp);
-  unlink(filename);
+  llf_dbg("%s(index(%d), pid(%d), status(%d), file_prefix(%s), limit(%#llx))\n",
+    __func__, index, pid, status, file_prefix, (uint64_t)socket_limit);
 
-CHILD_INIT:
-  if (manager_infos[index].is_initialized == SHMEM_INITIALIZED) {
+  if (status == SHMEM_INITIALIZED) {
     // Success to make Child process
     // Set the data for controller
     int ret = __fpga_shmem_set_manager_info(index, file_prefix, pid, socket_limit);
+    manager_infos[index].is_initialized = status;
     if (ret) {
       llf_err(FAILURE_MEMORY_ALLOC, "Failed to alloc memory for ShmemManager information.\n");
       ret = kill(pid, SIGUSR1);
@@ -318,23 +518,75 @@ CHILD_INIT:
         llf_err(FAILURE_SEND_SIGNAL, " Failed to kill process(errno:%d)\n", err);
         return -FAILURE_SEND_SIGNAL;
       }
+      __fpga_shmem_reset_manager_info(index);
       return -FAILURE_MEMORY_ALLOC;
     }
+    // Detect the exit of Child process through pidfd
+    __fpga_shmem_supervise_manager(index);
   } else {
     // failed to make Child process
-    llf_err(FAILURE_INITIALIZE, "Maybe Failed to initialize DPDK(stat:%d)\n",
-      manager_infos[index].is_initialized);
-    manager_infos[index].is_initialized = 0;
+    llf_err(FAILURE_INITIALIZE, "Maybe Failed to initialize DPDK(stat:%d)\n", status);
+    // Release the slot reserved for this manager
+    __fpga_shmem_reset_manager_info(index);
+    // Child process exits right after notifying the failure(or is killed by timeout), so reap it here
+    __fpga_shmem_reap_child(pid, SHMEM_CHILD_EXIT_TIMEOUT_MS);
     return -FAILURE_INITIALIZE;
   }
   return 0;
 }
 
 
+/**
+ * @brief Create signalfd to receive SIGUSR1 in shmem manager
+ * @return signalfd, or -1 when SIGUSR1 is handled by the signal handler
+ */
+static int __fpga_shmem_child_get_signalfd(void) {
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGUSR1);
+  if (sigprocmask(SIG_BLOCK, &mask, NULL)) {
+    int err = errno;
+    llf_warn(FAILURE_INITIALIZE, "Failed to block SIGUSR1(errno:%d)\n", err);
+    return -1;
+  }
+  int sfd = signalfd(-1, &mask, SFD_CLOEXEC);
+  if (sfd < 0) {
+    int err = errno;
+    llf_warn(FAILURE_INITIALIZE, "Failed to create signalfd(errno:%d)\n", err);
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+    return -1;
+  }
+  return sfd;
+}
+
+
+/**
+ * @brief Wait for SIGUSR1 up to `timeout_ms`(-1 : infinite) in shmem manager
+ */
+static void __fpga_shmem_child_wait_signal(
+  int sfd,
+  int timeout_ms
+) {
+  if (sfd < 0) {
+    // signal_flg is set by the signal handler
+    usleep(SHMEM_CHILD_LOOP_INTERVAL_MS * 1000);
+    return;
+  }
+
+  struct pollfd pfd = { .fd = sfd, .events = POLLIN };
+  if (poll(&pfd, 1, timeout_ms) > 0) {
+    struct signalfd_siginfo info;
+    if (read(sfd, &info, sizeof(info)) == sizeof(info) && info.ssi_signo == SIGUSR1)
+      signal_flg = true;
+  }
+}
+
+
 /**
  * @brief shmem manager process
  */
 static void __fpga_shmem_child_process(
+  int notify_fd,
   const char *file_prefix,
   const uint32_t hp_socket[],
   const bool lcore_mask[],
@@ -342,14 +594,11 @@ static void __fpga_shmem_child_process(
   void *arg
 ) {
   int exit_val = 0;
-  llf_dbg("%s(file_prefix(%s), limit(%#lx), clb(%#lx), arg(%#lx)\n",
-    __func__, file_prefix, (uint64_t)hp_socket, (uint64_t)clb, (uint64_t)arg);
+  llf_dbg("%s(notify_fd(%d), file_prefix(%s), limit(%#lx), clb(%#lx), arg(%#lx)\n",
+    __func__, notify_fd, file_prefix, (uint64_t)hp_socket, (uint64_t)clb, (uint64_t)arg);
 
-  // transfer file names
-  char filename[SHMEM_MAX_FILE_NAME_LEN];
-  sprintf(filename, SHMEM_PARENT_CHILD_TSF, file_prefix);  // NOLINT
-  unlink(filename);
-  FILE *fp;
+  // Receive SIGUSR1 through signalfd, so that the signal wakes up the loop immediately
+  int sfd = __fpga_shmem_child_get_signalfd();
 
   // DPDK initialize as primary
   // init DPDK as primary
@@ -360,12 +609,13 @@ static void __fpga_shmem_child_process(
     llf_err(FAILURE_INITIALIZE, "Failed to initialize DPDK as Primary\n");
     exit_val = FAILURE_INITIALIZE;
   }
-  // Create transfer file with parent process
-  fp = fopen(filename, "w");
-  if (fp == NULL) {
-    // Finish launched ShmemManager if failed to finish
-    llf_err(FAILURE_OPEN, "Failed to create transfer file(%s)\n", filename);
-    exit_val = FAILURE_OPEN;
+  // send to parent that initializing status
+  int status = exit_val ? SHMEM_INITIALIZE_FAILED : SHMEM_INITIALIZED;
+  if (write(notify_fd, &status, sizeof(status)) != sizeof(status)) {
+    // Finish launched ShmemManager if failed to notify
+    int err = errno;
+    llf_err(FAILURE_WRITE, "Failed to notify status to parent process(errno:%d)\n", err);
+    exit_val = FAILURE_WRITE;
     if (childret == 0) {
       fpga_shmem_finish();
       char rundir[SHMEM_MAX_FILE_NAME_LEN];
@@ -373,11 +623,8 @@ static void __fpga_shmem_child_process(
       __remove_hugedir(rundir);
     }
     __remove_hugedir(huge_dir);
-  } else {
-    // send to parent that initializing status
-    fprintf(fp, "%d", exit_val ? SHMEM_INITIALIZE_FAILED : SHMEM_INITIALIZED);
-    fclose(fp);
   }
+  close(notify_fd);
   // exit process if something error happened
   if (exit_val) {
     llf_err(exit_val, "Exit(%d): Failed to Launch ShmemManager\n", exit_val);
@@ -388,7 +635,7 @@ static void __fpga_shmem_child_process(
 
   // loop before call back function detect something wrong(ret!=0)
   // loop before receive signal SIGUSR1
-  do {
+  while (!signal_flg) {
     // CALLBACK_FUNCTION
     // check call back function is NULL
     if (clb) {
@@ -404,8 +651,11 @@ static void __fpga_shmem_child_process(
         exit(CALLBACK_FUNCTION);
       }
     }
-    usleep(500 * 1000);
-  }while(!signal_flg);
+    // Sleep until the next callback, or until SIGUSR1 arrives
+    __fpga_shmem_child_wait_signal(sfd, clb ? SHMEM_CHILD_LOOP_INTERVAL_MS : -1);
+  }
+  if (sfd >= 0)
+    close(sfd);
 
   // finish in success
   fpga_shmem_finish();
@@ -475,31 +725,22 @@ static int __fpga_shmem_check_memory(
 }
 
 
-int fpga_shmem_manager_init(
+/**
+ * @brief Fork shmem manager
+ * @param[in] close_fds
+ *   fds which should not be inherited by the shmem manager(e.g. pipes for the other managers)
+ * @return fd to receive the initializing status of the shmem manager, or negative error value
+ */
+static int __fpga_shmem_manager_launch(
   const char *file_prefix,
   const uint32_t socket_limit[],
   const bool lcore_mask[],
   const shmem_func clb,
-  void *arg
+  void *arg,
+  const int close_fds[],
+  int num_close_fds,
+  pid_t *pid
 ) {
-  int ret = 0;
-
-  // Check input
-  if (__fpga_shmem_check_file_prefix(file_prefix)) {
-    goto invalid_arg;
-  }
-  if (__fpga_shmem_check_memory(socket_limit)) {
-    goto invalid_arg;
-  }
-  llf_dbg("%s(file_prefix(%s), limit(%#llx), lcore_mask(%#llx), clb(%#llx), arg(%#llx)\n",
-    __func__, file_prefix, (uint64_t)socket_limit, (uint64_t)lcore_mask, (uint64_t)clb, (uint64_t)arg);
-
-  // Need to set signal to finish Child process safely, before manager initialize
-  if (!signal_set) {
-    llf_err(NOT_REGISTERED_SIGNAL, "Invalid operation: Signal has NOT been registerd yet.\n");
-    return -NOT_REGISTERED_SIGNAL;
-  }
-
   // Make directory for protectecting invalid user looking the other users' hugepage
   char huge_dir[SHMEM_MAX_FILE_NAME_LEN];
   sprintf(huge_dir, "/dev/hugepages/%s", file_prefix);  // NOLINT
@@ -511,36 +752,174 @@ int fpga_shmem_manager_init(
     }
   }
 
+  // Pipe to notify the initializing status from shmem manager
+  //  (not to be inherited by the programs which the user process executes)
+  int notify_fds[2];
+  if (pipe2(notify_fds, O_CLOEXEC)) {
+    int err = errno;
+    llf_err(FAILURE_OPEN, "Failed to create pipe for ShmemManager(errno:%d)\n", err);
+    return -FAILURE_OPEN;
+  }
+
   // fork
-  pid_t pid;
-  pid = fork();
-  if (pid < 0) {
+  *pid = fork();
+  if (*pid < 0) {
     // fork error
     int err = errno;
     llf_err(FAILURE_FORK, "Failed to fork process for ShmemManager(errno:%d)\n", err);
+    close(notify_fds[0]);
+    close(notify_fds[1]);
     return -FAILURE_FORK;
   }
 
-  if (pid == 0) {
+  if (*pid == 0) {
     // Child process
+    close(notify_fds[0]);
+    for (int i = 0; i < num_close_fds; i++)
+      close(close_fds[i]);
+    __fpga_shmem_close_supervisor();
     libfpga_log_reset_output_file();
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBSHMEM "[MANAGER:pid(%d)] "
-      "%s(file_prefix(%s), limit(%#llx), lcore_mask(%#llx), clb(%#llx), arg(%#llx)\n",
-      getpid(), __func__, file_prefix, (uint64_t)socket_limit, (uint64_t)lcore_mask, (uint64_t)clb, (uint64_t)arg);
-    __fpga_shmem_child_process(file_prefix, socket_limit, lcore_mask, clb, arg);
+      "fpga_shmem_manager_init(file_prefix(%s), limit(%#llx), lcore_mask(%#llx), clb(%#llx), arg(%#llx)\n",
+      getpid(), file_prefix, (uint64_t)socket_limit, (uint64_t)lcore_mask, (uint64_t)clb, (uint64_t)arg);
+    __fpga_shmem_child_process(notify_fds[1], file_prefix, socket_limit, lcore_mask, clb, arg);
     // call exit() in __fpga_shmem_child_process function's all route
   }
 
   // Parent process
-  ret = __fpga_shmem_parent_process(pid, file_prefix, socket_limit);
+  close(notify_fds[1]);
+  return notify_fds[0];
+}
 
-  return ret;
 
-invalid_arg:
-  llf_err(INVALID_ARGUMENT, "%s(file_prefix(%s), limit(%#llx), lcore_mask(%#llx), clb(%#llx), arg(%#llx)\n",
-    __func__, file_prefix ? file_prefix : "<null>",
-    (uint64_t)socket_limit, (uint64_t)lcore_mask, (uint64_t)clb, (uint64_t)arg);
-  return -INVALID_ARGUMENT;
+/**
+ * @brief Launch shmem managers concurrently and wait for all of them together
+ * @details
+ *   Each request reserves its slot of manager_infos(pid is 0 until launched) in order,
+ *    so that the later requests are checked against file_prefix and socket_limit
+ *    of the earlier ones.
+ */
+static void __fpga_shmem_manager_init_multi(
+  fpga_shmem_manager_param_t params[],
+  int num
+) {
+  int indexes[SHMEM_MAX_HUGEPAGES];
+  int launched[SHMEM_MAX_HUGEPAGES];
+  pid_t pids[SHMEM_MAX_HUGEPAGES];
+  int notify_fds[SHMEM_MAX_HUGEPAGES];
+  int status[SHMEM_MAX_HUGEPAGES];
+  int num_launched = 0;
+
+  // Check input and reserve the slots
+  for (int i = 0; i < num; i++) {
+    fpga_shmem_manager_param_t *param = &params[i];
+    indexes[i] = -1;
+    if (__fpga_shmem_check_file_prefix(param->file_prefix)
+      || __fpga_shmem_check_memory(param->socket_limit)) {
+      llf_err(INVALID_ARGUMENT, "%s(file_prefix(%s), limit(%#llx), lcore_mask(%#llx), clb(%#llx), arg(%#llx)\n",
+        __func__, param->file_prefix ? param->file_prefix : "<null>",
+        (uint64_t)param->socket_limit, (uint64_t)param->lcore_mask, (uint64_t)param->clb, (uint64_t)param->arg);
+      param->result = -INVALID_ARGUMENT;
+      continue;
+    }
+    llf_dbg("%s(file_prefix(%s), limit(%#llx), lcore_mask(%#llx), clb(%#llx), arg(%#llx)\n",
+      __func__, param->file_prefix, (uint64_t)param->socket_limit, (uint64_t)param->lcore_mask,
+      (uint64_t)param->clb, (uint64_t)param->arg);
+
+    // Need to set signal to finish Child process safely, before manager initialize
+    if (!signal_set) {
+      llf_err(NOT_REGISTERED_SIGNAL, "Invalid operation: Signal has NOT been registerd yet.\n");
+      param->result = -NOT_REGISTERED_SIGNAL;
+      continue;
+    }
+
+    // Get the smallest and free index
+    int index = __fpga_shmem_get_index();
+    if (index < 0) {
+      llf_err(FULL_ELEMENT, "Invalid operation: List for management is full.\n");
+      param->result = -FULL_ELEMENT;
+      continue;
+    }
+    llf_dbg(" Got index : %d\n", index);
+    __fpga_shmem_set_manager_info(index, param->file_prefix, 0, param->socket_limit);
+    indexes[i] = index;
+    param->result = 0;
+  }
+
+  // Fork all shmem managers before waiting for any of them
+  for (int i = 0; i < num; i++) {
+    fpga_shmem_manager_param_t *param = &params[i];
+    if (indexes[i] < 0)
+      continue;
+    int fd = __fpga_shmem_manager_launch(param->file_prefix, param->socket_limit, param->lcore_mask,
+      param->clb, param->arg, notify_fds, num_launched, &pids[num_launched]);
+    if (fd < 0) {
+      param->result = fd;
+      __fpga_shmem_reset_manager_info(indexes[i]);
+      continue;
+    }
+    notify_fds[num_launched] = fd;
+    launched[num_launched] = i;
+    num_launched++;
+  }
+
+  // Wait for DPDK initialization of all shmem managers together
+  __fpga_shmem_parent_wait_status(pids, notify_fds, status, num_launched);
+
+  for (int n = 0; n < num_launched; n++) {
+    int i = launched[n];
+    params[i].result = __fpga_shmem_parent_process(indexes[i], pids[n], status[n],
+      params[i].file_prefix, params[i].socket_limit);
+  }
+}
+
+
+int fpga_shmem_manager_init(
+  const char *file_prefix,
+  const uint32_t socket_limit[],
+  const bool lcore_mask[],
+  const shmem_func clb,
+  void *arg
+) {
+  fpga_shmem_manager_param_t param = {
+    .file_prefix = file_prefix,
+    .socket_limit = socket_limit,
+    .lcore_mask = lcore_mask,
+    .clb = clb,
+    .arg = arg,
+    .result = 0,
+  };
+
+  __fpga_shmem_manager_init_multi(&param, 1);
+
+  return param.result;
+}
+
+
+// cppcheck-suppress unusedFunction
+int fpga_shmem_manager_init_batch(
+  fpga_shmem_manager_param_t params[],
+  int num
+) {
+  // Check input
+  if (!params || num <= 0 || num > SHMEM_MAX_HUGEPAGES) {
+    llf_err(INVALID_ARGUMENT, "%s(params(%#llx), num(%d))\n", __func__, (uint64_t)params, num);
+    return -INVALID_ARGUMENT;
+  }
+  llf_dbg("%s(params(%#llx), num(%d))\n", __func__, (uint64_t)params, num);
+
+  __fpga_shmem_manager_init_multi(params, num);
+
+  int ret = 0;
+  for (int i = 0; i < num; i++) {
+    if (params[i].result) {
+      llf_err(FAILURE_INITIALIZE, " Failed to launch ShmemManager(file_prefix(%s)):%d\n",
+        params[i].file_prefix ? params[i].file_prefix : "<null>", params[i].result);
+      ret = -FAILURE_INITIALIZE;
+    }
+  }
+
+  return ret;
 }
 
 
@@ -610,7 +989,8 @@ int fpga_shmem_manager_finish_all(void) {
   int cnt = 0;
   const int max_cnt = 20;
   while (cnt < max_cnt) {
-    usleep(500 * 1000);
+    // Wake up as soon as any Child process exits
+    __fpga_shmem_check_health_wait(500);
     // Check all Child process finish in success
     if (fpga_shmem_get_available_pages() == fpga_shmem_get_available_limit()) {
       break;
@@ -7,6 +7,8 @@
 #include <libshmem.h>
 #include <liblogging.h>
 
+#include <libfpga_internal/libshmem_internal.h>
+
 #include <stdio.h>
 
 #include <map>
@@ -72,20 +74,6 @@ int fpga_shmem_register(
 }
 
 
-// cppcheck-suppress unusedFunction
-int fpga_shmem_register_by_token(
-  void* token,
-  size_t token_len,
-  size_t length
-) {
-  llf_dbg("%s(token(%#lx), token_len(%lx), length(%#lx))\n",
-    __func__, (uintptr_t)token, token_len, length);
-
-  // not implemented (using mem_manage)
-  return -LIBFPGA_FATAL_ERROR;
-}
-
-
 int fpga_shmem_register_update(
   void *addr,
   uint64_t paddr,
@@ -268,3 +256,9 @@ void *__fpga_shmem_mmap_p2v(
   uint64_t vaddr = reinterpret_cast<uint64_t>(it->second.first) + offset;
   return reinterpret_cast<void*>(vaddr);
 }
+
+
+size_t __fpga_shmem_register_count(void) {
+  std::lock_guard<std::mutex> lock(mmap_mutex);
+  return v2p_map.size();
+}
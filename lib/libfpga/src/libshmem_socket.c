@@ -7,6 +7,7 @@
 #include <libshmem_socket.h>
 #include <liblogging.h>
 
+#include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -149,6 +150,194 @@ failed:
 }
 
 
+int fpga_shmem_get_fd_listen(
+  unsigned short port,
+  const char *addr
+) {
+  llf_dbg("%s(port(%d), addr(%s)\n", __func__, port, addr);
+
+  int ret;
+  struct sockaddr_in server;
+
+  // socket
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    int err = errno;
+    llf_err(err, "socket() error\n");
+    return -FAILURE_INITIALIZE;
+  }
+
+  // set reuse port setting
+  int flag = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+
+  // bind
+  memset(&server, 0, sizeof(server));
+  server.sin_family = AF_INET;
+  server.sin_port = htons(port);
+  server.sin_addr.s_addr = inet_addr(addr);
+  ret = bind(fd, (struct sockaddr*)&server, sizeof(server));
+  if (ret < 0) {
+    int err = errno;
+    llf_err(err, " bind  (%s:%hu) failure[%d]\n", addr, port, fd);
+    close(fd);
+    return -FAILURE_BIND;
+  }
+
+  // listen
+  ret = listen(fd, 16);
+  if (ret < 0) {
+    int err = errno;
+    llf_err(err, " listen(%s:%hu) error[%d]\n", addr, port, fd);
+    close(fd);
+    return -FAILURE_ESTABLISH;
+  }
+  llf_dbg(" listen(%s:%hu) success[%d]\n", addr, port, fd);
+
+  return fd;
+}
+
+
+int fpga_shmem_get_fd_listen_unix(
+  const char *path
+) {
+  llf_dbg("%s(path(%s)\n", __func__, path);
+
+  int ret;
+  struct sockaddr_un server;
+
+  if (strlen(path) >= sizeof(server.sun_path)) {
+    llf_err(INVALID_ARGUMENT, " path(%s) is too long\n", path);
+    return -INVALID_ARGUMENT;
+  }
+
+  // socket
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    int err = errno;
+    llf_err(err, "socket() error\n");
+    return -FAILURE_INITIALIZE;
+  }
+
+  // bind(remove the socket file left by the previous controller)
+  memset(&server, 0, sizeof(server));
+  server.sun_family = AF_UNIX;
+  strncpy(server.sun_path, path, sizeof(server.sun_path) - 1);
+  unlink(path);
+  ret = bind(fd, (struct sockaddr*)&server, sizeof(server));
+  if (ret < 0) {
+    int err = errno;
+    llf_err(err, " bind  (%s) failure[%d]\n", path, fd);
+    close(fd);
+    return -FAILURE_BIND;
+  }
+
+  // listen
+  ret = listen(fd, 16);
+  if (ret < 0) {
+    int err = errno;
+    llf_err(err, " listen(%s) error[%d]\n", path, fd);
+    close(fd);
+    unlink(path);
+    return -FAILURE_ESTABLISH;
+  }
+  llf_dbg(" listen(%s) success[%d]\n", path, fd);
+
+  return fd;
+}
+
+
+int fpga_shmem_get_fd_client_unix(
+  const char *path
+) {
+  llf_dbg("%s(path(%s)\n", __func__, path);
+
+  int ret;
+  struct sockaddr_un data;
+
+  if (strlen(path) >= sizeof(data.sun_path)) {
+    llf_err(INVALID_ARGUMENT, " path(%s) is too long\n", path);
+    return -1;
+  }
+
+  // socket
+  int fd_connect = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_connect < 0) {
+    int err = errno;
+    llf_err(err, "socket() error\n");
+    return -FAILURE_INITIALIZE;
+  }
+
+  // connect
+  memset(&data, 0, sizeof(data));
+  data.sun_family = AF_UNIX;
+  strncpy(data.sun_path, path, sizeof(data.sun_path) - 1);
+  ret = connect(fd_connect, (struct sockaddr*)&data, sizeof(data));
+  if (ret < 0) {
+    int err = errno;
+    llf_dbg(" connect(%s) error[%d](errno:%d)\n", path, fd_connect, err);
+    close(fd_connect);
+    return -1;
+  }
+  llf_dbg(" connect(%s) success[%d]\n", path, fd_connect);
+
+  return fd_connect;
+}
+
+
+int fpga_shmem_send_frame(
+  int fd,
+  const void *frame,
+  size_t len
+) {
+  const char *ptr = (const char*)frame;  // NOLINT
+  size_t sent = 0;
+
+  // Send whole frame without header(the size is fixed between both sides)
+  while (sent < len) {
+    ssize_t ret = send(fd, ptr + sent, len - sent, MSG_NOSIGNAL);
+    if (ret < 0) {
+      int err = errno;
+      if (err == EINTR)
+        continue;
+      llf_err(err, "  send frame error[%d]\n", fd);
+      return sent ? 1 : -1;
+    }
+    sent += ret;
+  }
+
+  return 0;
+}
+
+
+int fpga_shmem_recv_frame(
+  int fd,
+  void *frame,
+  size_t len
+) {
+  char *ptr = (char*)frame;  // NOLINT
+  size_t received = 0;
+
+  // Receive whole frame into the caller's buffer
+  while (received < len) {
+    ssize_t ret = recv(fd, ptr + received, len - received, 0);
+    if (ret == 0) {
+      llf_dbg("  recv frame failed...(connection lost)[%d]\n", fd);
+      return 1;
+    } else if (ret < 0) {
+      int err = errno;
+      if (err == EINTR)
+        continue;
+      llf_err(err, "  recv frame failed[%d]\n", fd);
+      return -1;
+    }
+    received += ret;
+  }
+
+  return 0;
+}
+
+
 static int __fpga_shmem_send(
   int fd,
   void *data,
@@ -12,6 +12,7 @@
 
 #include <netinet/in.h>
 #include <sys/time.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -58,6 +59,43 @@ typedef struct fpga_ptu_stat {
   uint8_t tcp_cmd_cnt_avail;
 } fpga_ptu_stat_t;
 
+typedef struct fpga_ptu_tcb_rate {
+  uint32_t cid;
+  struct timespec timestamp;  // CLOCK_MONOTONIC time of the sample
+  uint64_t snd_rate;          // acknowledged bytes per second(delta of snd_una)
+  uint64_t rcv_rate;          // received bytes per second(delta of rcv_nxt)
+  uint32_t inflight;          // unacknowledged bytes(snd_nxt - snd_una)
+  uint32_t unsent;            // written but not sent bytes(usr_wrt - snd_nxt)
+  uint32_t snd_wnd;           // send window
+  uint64_t elapsed_us;        // monitored time of this connection
+  uint64_t wnd_limited_us;    // time when inflight reached snd_wnd
+  uint64_t snd_limited_us;    // time when data was unsent although snd_wnd had room
+  uint64_t dump_fail_cnt;     // num of samples skipped because the TCB dump failed
+} fpga_ptu_tcb_rate_t;
+
+/**
+ * Result of fpga_ptu_conn_req_t which is not completed yet
+ */
+#define FPGA_PTU_CONN_IN_PROGRESS 1
+
+typedef struct fpga_ptu_conn_req {
+  in_port_t lport;  // [in] local port(listen port for accept)
+  in_addr_t raddr;  // [in] remote IP address
+  in_port_t rport;  // [in] remote port
+  uint32_t cid;     // [out] TCP connection ID, valid when result is 0
+  int result;       // [out] same as the retval of fpga_ptu_connect()/fpga_ptu_accept()
+} fpga_ptu_conn_req_t;
+
+/**
+ * @brief Callback called for each request of a batch when it is completed
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in] req Completed request(`result` and `cid` are set)
+ * @param[in] arg User argument passed to the batch API
+ */
+typedef void (*fpga_ptu_conn_cb_t)(uint32_t dev_id, uint32_t lane,
+                                   const fpga_ptu_conn_req_t *req, void *arg);
+
 typedef struct fpga_dump_tcb {
   uint32_t tcb_usr_read;
   uint32_t tcb_usr_wrt;
@@ -86,6 +124,9 @@ int fpga_ptu_init(uint32_t dev_id, uint32_t lane, in_addr_t addr,
  * @param[in] dev_id Device ID
  * @param[in] lane PTU ID
  * @return 0->success, -1->fail
+ * @details Listen ports are closed here. Handles still open do not access the
+ *  PTU registers any more, so fpga_dev_finish() may be called before
+ *  fpga_ptu_close().
  */
 int fpga_ptu_exit(uint32_t dev_id, uint32_t lane);
 
@@ -137,11 +178,31 @@ int fpga_ptu_listen_close(uint32_t dev_id, uint32_t lane, in_port_t port);
  * @param[out] cid TCP connection ID
  * @return 0->success, -1->timeout, -2->connected from unexpected IP or port,
  * -3->not listen
+ * @details The wait ends at the first connection on `lport`. Use
+ *  fpga_ptu_accept_exact() to keep waiting for the expected IP and port.
  */
 int fpga_ptu_accept(uint32_t dev_id, uint32_t lane, in_port_t lport,
                     in_addr_t raddr, in_port_t rport,
                     const struct timeval *timeout, uint32_t *cid);
 
+/**
+ * @brief Wait for TCP connection establishment from the expected remote host
+ * (thread safe)
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in] lport Listen port
+ * @param[in] raddr Expected remote IP address
+ * @param[in] rport Expected remote port
+ * @param[in] timeout Timeout to wait for connection. NULL means no timeout.
+ * @param[out] cid TCP connection ID
+ * @return 0->success, -1->timeout, -3->not listen
+ * @details Unlike fpga_ptu_accept(), connections from other IP or port do not
+ *  end the wait. They stay established and can be waited for by other calls.
+ */
+int fpga_ptu_accept_exact(uint32_t dev_id, uint32_t lane, in_port_t lport,
+                          in_addr_t raddr, in_port_t rport,
+                          const struct timeval *timeout, uint32_t *cid);
+
 /**
  * @brief Connect to remote host (thread safe)
  * @param[in] dev_id Device ID
@@ -158,6 +219,44 @@ int fpga_ptu_connect(uint32_t dev_id, uint32_t lane, in_port_t lport,
                      in_addr_t raddr, in_port_t rport,
                      const struct timeval *timeout, uint32_t *cid);
 
+/**
+ * @brief Connect to many remote hosts at once (thread safe)
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in,out] reqs Connection requests
+ * @param[in] num Number of `reqs`
+ * @param[in] timeout Timeout to wait for all connections. NULL means no timeout.
+ * @param[in] callback Called in the caller's thread for each request as soon as
+ * it is completed(nullable)
+ * @param[in] arg User argument for `callback`
+ * @return 0->all established, -1->some failed(see `result` of each request),
+ * -INVALID_ARGUMENT->bad argument, -FAILURE_DEVICE_OPEN->ptu not initialized
+ * @details The connect commands are issued back to back without waiting for
+ *  each establishment, and then all connections are waited for together.
+ */
+int fpga_ptu_connect_batch(uint32_t dev_id, uint32_t lane,
+                           fpga_ptu_conn_req_t *reqs, uint32_t num,
+                           const struct timeval *timeout,
+                           fpga_ptu_conn_cb_t callback, void *arg);
+
+/**
+ * @brief Wait for many TCP connection establishments at once (thread safe)
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in,out] reqs Expected connections(`lport` is the listen port)
+ * @param[in] num Number of `reqs`
+ * @param[in] timeout Timeout to wait for all connections. NULL means no timeout.
+ * @param[in] callback Called in the caller's thread for each request as soon as
+ * it is completed(nullable)
+ * @param[in] arg User argument for `callback`
+ * @return 0->all established, -1->some failed(see `result` of each request),
+ * -INVALID_ARGUMENT->bad argument, -FAILURE_DEVICE_OPEN->ptu not initialized
+ */
+int fpga_ptu_accept_batch(uint32_t dev_id, uint32_t lane,
+                          fpga_ptu_conn_req_t *reqs, uint32_t num,
+                          const struct timeval *timeout,
+                          fpga_ptu_conn_cb_t callback, void *arg);
+
 /**
  * @brief Close connection (thread safe)
  * @param[in] dev_id Device ID
@@ -259,11 +358,53 @@ int fpga_ptu_clear_arp_status(uint32_t dev_id, uint32_t lane, fpga_arp_status_t
  * @brief Get ARP entry
  * @param[in] dev_id Device ID
  * @param[in] lane PTU ID
+ * @param[in] index ARP table index
  * @param[out] arp_entry ARP entry
- * @return 0->success, -1->fail
+ * @return 0->success, -INVALID_ARGUMENT->bad argument,
+ * -FAILURE_DEVICE_OPEN->ptu not initialized, -FAILURE_IOCTL->register access failure
+ * @details The index is selected and the entry is read by one system call.
  */
 int fpga_ptu_get_arp_entry(uint32_t dev_id, uint32_t lane, uint8_t index, fpga_arp_entry_t *arp_entry);
 
+/**
+ * @brief Dump all valid ARP entries
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[out] arp_entries ARP entries which are used or permanent
+ * @param[in] max Number of elements of `arp_entries`
+ * @param[out] num Number of valid entries(may be larger than `max`)
+ * @return 0->success, -INVALID_ARGUMENT->bad argument,
+ * -FAILURE_DEVICE_OPEN->ptu not initialized, -FAILURE_IOCTL->register access failure
+ * @details All indexes are dumped by a few system calls instead of
+ *  fpga_ptu_get_arp_entry() per index.
+ */
+int fpga_ptu_dump_arp_table(uint32_t dev_id, uint32_t lane, fpga_arp_entry_t *arp_entries,
+                            uint32_t max, uint32_t *num);
+
+/**
+ * @brief Get all valid ARP entries from the mirror in the library
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[out] arp_entries ARP entries which are used or permanent
+ * @param[in] max Number of elements of `arp_entries`
+ * @param[out] num Number of valid entries(may be larger than `max`)
+ * @param[in] max_age Re-read the table when the mirror is older than this.
+ * NULL means no limit.
+ * @param[out] refreshed true when the table was re-read by this call(nullable)
+ * @return same as fpga_ptu_dump_arp_table()
+ * @details The table is re-read only when `sts_entry_evicted` or
+ *  `sts_ipv4_conflicted` of ARP status is set, when the entries were changed
+ *  by fpga_ptu_set_arp_entry()/fpga_ptu_del_arp_entry(), or when `max_age`
+ *  passed. Otherwise only ARP status is read.@n
+ *  This API clears `sts_entry_evicted` and `sts_ipv4_conflicted`,
+ *  so do not use fpga_ptu_get_arp_status() to detect them at the same time.@n
+ *  Entries resolved by the PTU itself and `dump_life` are not signalled
+ *  by ARP status, use `max_age` to follow them.
+ */
+int fpga_ptu_dump_arp_table_cached(uint32_t dev_id, uint32_t lane, fpga_arp_entry_t *arp_entries,
+                                   uint32_t max, uint32_t *num,
+                                   const struct timeval *max_age, uint8_t *refreshed);
+
 /**
  * @brief Get ARP entry
  * @param[in] dev_id Device ID
@@ -273,6 +414,19 @@ int fpga_ptu_get_arp_entry(uint32_t dev_id, uint32_t lane, uint8_t index, fpga_a
  */
 int fpga_ptu_get_stat(uint32_t dev_id, uint32_t lane, fpga_ptu_stat_t *ptu_stat);
 
+/**
+ * @brief Get PTU stat as a snapshot
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[out] ptu_stat PTU stat
+ * @param[out] timestamp CLOCK_MONOTONIC time when the counters were read(nullable)
+ * @return 0->success, -1->fail
+ * @details All counters are read by one register access under one lock,
+ *  so they are sampled at the same instant.
+ */
+int fpga_ptu_get_stat_snapshot(uint32_t dev_id, uint32_t lane, fpga_ptu_stat_t *ptu_stat,
+                               struct timespec *timestamp);
+
 /**
  * @brief Dump TCB
  * @param[in] dev_id Device ID
@@ -297,6 +451,210 @@ int fpga_ptu_wait_tcb_buffer_empty(uint32_t dev_id, uint32_t lane, uint32_t cid,
                                    const struct timeval *timeout, const struct timeval *interval,
                                    uint32_t *is_success);
 
+/**
+ * @brief Start monitoring TCBs of all established connections
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in] interval Sampling interval
+ * @param[in] history Max number of samples kept per connection
+ * @return 0->success, -INVALID_ARGUMENT->bad argument or already started,
+ * -FAILURE_DEVICE_OPEN->ptu not initialized
+ * @details A thread dumps TCBs of all established connections every `interval`,
+ *  batching as many connections as possible into one system call,
+ *  and computes rates from the deltas between two samples.
+ *  A connection whose dump failed is kept and its dump_fail_cnt is incremented.
+ *  The monitor is stopped by fpga_ptu_tcb_monitor_stop() or fpga_ptu_exit().
+ */
+int fpga_ptu_tcb_monitor_start(uint32_t dev_id, uint32_t lane,
+                               const struct timeval *interval, uint32_t history);
+
+/**
+ * @brief Stop monitoring TCBs
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @return 0->success, -1->not started
+ */
+int fpga_ptu_tcb_monitor_stop(uint32_t dev_id, uint32_t lane);
+
+/**
+ * @brief Get the latest sample of each monitored connection
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[out] table Samples sorted by cid
+ * @param[in] max Number of elements of `table`
+ * @param[out] num Number of connections(may be larger than `max`)
+ * @return 0->success, -INVALID_ARGUMENT->bad argument or not started
+ */
+int fpga_ptu_tcb_monitor_get_table(uint32_t dev_id, uint32_t lane,
+                                   fpga_ptu_tcb_rate_t *table, uint32_t max,
+                                   uint32_t *num);
+
+/**
+ * @brief Get the samples of a connection as a time series
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in] cid TCP connection ID
+ * @param[out] series Samples, oldest first
+ * @param[in] max Number of elements of `series`
+ * @param[out] num Number of samples(may be larger than `max`,
+ * then the latest `max` samples are stored)
+ * @return 0->success, -1->`cid` is not monitored,
+ * -INVALID_ARGUMENT->bad argument or not started
+ */
+int fpga_ptu_tcb_monitor_get_series(uint32_t dev_id, uint32_t lane,
+                                    uint32_t cid, fpga_ptu_tcb_rate_t *series,
+                                    uint32_t max, uint32_t *num);
+
+/**
+ * @brief Poll TCBs of many connections until TCP buffers empty
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[in] cids TCP connection IDs
+ * @param[in] num Number of `cids`
+ * @param[in] wait_any false->wait until all of `cids` are drained,
+ * true->wait until any of `cids` is drained
+ * @param[in] timeout Timeout to wait for connection. NULL means no timeout.
+ * @param[in] interval Interval to wait for connection. NULL means busy wait.
+ * @param[out] drained Result of each cid, array of `num` elements(nullable)
+ * @param[out] is_success Result of polling(if polling success set true, otherwise set false)
+ * @return 0->success, -1->fail(`is_success` is not defined)
+ * @details Each sweep dumps TCBs of all not-drained cids by a few system calls.
+ *  A cid once found drained is not dumped again.
+ */
+int fpga_ptu_wait_tcb_buffer_empty_multi(uint32_t dev_id, uint32_t lane,
+                                         const uint32_t *cids, uint32_t num,
+                                         uint8_t wait_any,
+                                         const struct timeval *timeout,
+                                         const struct timeval *interval,
+                                         uint8_t *drained, uint32_t *is_success);
+
+/**
+ * @brief Handle of an initialized PTU for fpga_ptu_hdl_*()
+ */
+typedef struct fpga_ptu_handle *fpga_ptu_handle_t;
+
+/**
+ * @brief Open a handle of PTU initialized by fpga_ptu_init() (thread safe)
+ * @param[in] dev_id Device ID
+ * @param[in] lane PTU ID
+ * @param[out] handle Handle of the PTU
+ * @return 0->success, -INVALID_ARGUMENT->bad argument,
+ * -FAILURE_DEVICE_OPEN->ptu not initialized
+ * @details fpga_ptu_hdl_*() with the handle skip looking up the PTU by
+ *  `dev_id` and `lane`. After fpga_ptu_exit(), they fail with
+ *  -FAILURE_DEVICE_OPEN until the handle is closed by fpga_ptu_close(),
+ *  and accept/connect waiting at fpga_ptu_exit() return -FAILURE_DEVICE_OPEN.
+ */
+int fpga_ptu_open(uint32_t dev_id, uint32_t lane, fpga_ptu_handle_t *handle);
+
+/**
+ * @brief Close a handle opened by fpga_ptu_open()
+ * @param[in] handle Handle of the PTU
+ * @return 0->success, -INVALID_ARGUMENT->bad argument
+ * @details Do not use the handle in other threads at the same time.
+ */
+int fpga_ptu_close(fpga_ptu_handle_t handle);
+
+/**
+ * @brief fpga_ptu_get_stat_snapshot() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[out] ptu_stat PTU stat
+ * @param[out] timestamp CLOCK_MONOTONIC time when the counters were read(nullable)
+ * @return 0->success, -1->fail
+ */
+int fpga_ptu_hdl_get_stat(fpga_ptu_handle_t handle, fpga_ptu_stat_t *ptu_stat,
+                          struct timespec *timestamp);
+
+/**
+ * @brief fpga_ptu_dump_tcb() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in] cid TCP connection ID
+ * @param[out] dump_tcb TCB dump
+ * @return 0->success, -1->fail
+ */
+int fpga_ptu_hdl_dump_tcb(fpga_ptu_handle_t handle, uint32_t cid,
+                          fpga_dump_tcb_t *dump_tcb);
+
+/**
+ * @brief fpga_ptu_accept() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in] lport Listen port
+ * @param[in] raddr Expected remote IP address
+ * @param[in] rport Expected remote port
+ * @param[in] timeout Timeout to wait for connection. NULL means no timeout.
+ * @param[out] cid TCP connection ID
+ * @return same as fpga_ptu_accept()
+ */
+int fpga_ptu_hdl_accept(fpga_ptu_handle_t handle, in_port_t lport,
+                        in_addr_t raddr, in_port_t rport,
+                        const struct timeval *timeout, uint32_t *cid);
+
+/**
+ * @brief fpga_ptu_accept_exact() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in] lport Listen port
+ * @param[in] raddr Expected remote IP address
+ * @param[in] rport Expected remote port
+ * @param[in] timeout Timeout to wait for connection. NULL means no timeout.
+ * @param[out] cid TCP connection ID
+ * @return same as fpga_ptu_accept_exact()
+ */
+int fpga_ptu_hdl_accept_exact(fpga_ptu_handle_t handle, in_port_t lport,
+                              in_addr_t raddr, in_port_t rport,
+                              const struct timeval *timeout, uint32_t *cid);
+
+/**
+ * @brief fpga_ptu_connect() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in] lport local port
+ * @param[in] raddr remote IP address
+ * @param[in] rport remote port
+ * @param[in] timeout Timeout to wait for connection. NULL means no timeout.
+ * @param[out] cid TCP connection ID
+ * @return same as fpga_ptu_connect()
+ */
+int fpga_ptu_hdl_connect(fpga_ptu_handle_t handle, in_port_t lport,
+                         in_addr_t raddr, in_port_t rport,
+                         const struct timeval *timeout, uint32_t *cid);
+
+/**
+ * @brief fpga_ptu_connect_batch() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in,out] reqs Connections to establish
+ * @param[in] num Number of `reqs`
+ * @param[in] timeout Timeout to wait for all connections. NULL means no timeout.
+ * @param[in] callback Called for each completed request(nullable)
+ * @param[in] arg User argument for `callback`
+ * @return same as fpga_ptu_connect_batch()
+ */
+int fpga_ptu_hdl_connect_batch(fpga_ptu_handle_t handle,
+                               fpga_ptu_conn_req_t *reqs, uint32_t num,
+                               const struct timeval *timeout,
+                               fpga_ptu_conn_cb_t callback, void *arg);
+
+/**
+ * @brief fpga_ptu_accept_batch() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in,out] reqs Expected connections(`lport` is the listen port)
+ * @param[in] num Number of `reqs`
+ * @param[in] timeout Timeout to wait for all connections. NULL means no timeout.
+ * @param[in] callback Called for each completed request(nullable)
+ * @param[in] arg User argument for `callback`
+ * @return same as fpga_ptu_accept_batch()
+ */
+int fpga_ptu_hdl_accept_batch(fpga_ptu_handle_t handle,
+                              fpga_ptu_conn_req_t *reqs, uint32_t num,
+                              const struct timeval *timeout,
+                              fpga_ptu_conn_cb_t callback, void *arg);
+
+/**
+ * @brief fpga_ptu_disconnect() by handle (thread safe)
+ * @param[in] handle Handle of the PTU
+ * @param[in] cid TCP connection ID
+ * @return 0->success, -1->connection does not exist
+ */
+int fpga_ptu_hdl_disconnect(fpga_ptu_handle_t handle, uint32_t cid);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,10 +13,13 @@
 #include <cstdlib>
 #include <map>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <ptu_dev.hpp>
+#include <ptu_tcb_mon.hpp>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,10 +32,41 @@ extern "C" {
 
 constexpr uint32_t PTU_BASE = 0x00020000;
 
-// (dev_id, lane) -> ptu_dev
-static std::map<std::tuple<uint32_t, uint32_t>, std::unique_ptr<ptu_dev>>
+// (dev_id, lane) -> ptu_dev, shared with fpga_ptu_handle_t
+static std::map<std::tuple<uint32_t, uint32_t>, std::shared_ptr<ptu_dev>>
     ptu_devices;
 
+// (dev_id, lane) -> ptu_tcb_mon, destructed before ptu_devices
+static std::map<std::tuple<uint32_t, uint32_t>, std::unique_ptr<ptu_tcb_mon>>
+    ptu_tcb_monitors;
+
+// for ptu_devices and ptu_tcb_monitors
+static std::shared_mutex mtx_ptu_devices;
+
+struct fpga_ptu_handle {
+  uint32_t dev_id;
+  uint32_t lane;
+  std::shared_ptr<ptu_dev> dev;
+};
+
+// look up ptu_dev, which stays valid while the returned pointer is held
+static std::shared_ptr<ptu_dev> ptu_get(uint32_t dev_id, uint32_t lane) {
+  std::shared_lock<std::shared_mutex> lk(mtx_ptu_devices);
+  auto it = ptu_devices.find(std::make_tuple(dev_id, lane));
+  if (it == ptu_devices.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+// ptu_dev of a handle, nullptr after fpga_ptu_exit()
+static ptu_dev *ptu_get(fpga_ptu_handle_t handle) {
+  if (!handle || handle->dev->exited()) {
+    return nullptr;
+  }
+  return handle->dev.get();
+}
+
 int fpga_ptu_init(uint32_t dev_id, uint32_t lane, in_addr_t addr,
                   in_addr_t subnet, in_addr_t gateway, const uint8_t *mac) {
   /* input check */
@@ -46,6 +80,7 @@ int fpga_ptu_init(uint32_t dev_id, uint32_t lane, in_addr_t addr,
   /* device */
   int dev_fd = dev->fd;
 
+  std::unique_lock<std::shared_mutex> lk(mtx_ptu_devices);
   bool inited =
       ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end();
   if (inited) {
@@ -56,28 +91,34 @@ int fpga_ptu_init(uint32_t dev_id, uint32_t lane, in_addr_t addr,
   }
 
   uint32_t base = PTU_BASE + 0x1000 * lane;
-  ptu_devices[std::make_tuple(dev_id, lane)] =
-      std::unique_ptr<ptu_dev>(new ptu_dev(dev_fd, lane, dev_id, base));
+  std::shared_ptr<ptu_dev> ptu =
+      std::make_shared<ptu_dev>(dev_fd, lane, dev_id, base);
+  ptu_devices[std::make_tuple(dev_id, lane)] = ptu;
 
-  int ret = ptu_devices[std::make_tuple(dev_id, lane)]->init(addr, subnet,
-                                                               gateway, mac);
+  int ret = ptu->init(addr, subnet, gateway, mac);
   if (ret != 0) {
     return -1;
   }
 
   // retransmission timer is 200ms
-  ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
+  ptu->reg_write(
       PtuRegMap::TCP_RET_TIMER, (20 << 20) | (6000 << 4) | (1 << 3) | 5);
 
-  ptu_devices[std::make_tuple(dev_id, lane)]->start_event();
+  ptu->start_event();
 
   return 0;
 }
 
 int fpga_ptu_exit(uint32_t dev_id, uint32_t lane) {
+  std::unique_lock<std::shared_mutex> lk(mtx_ptu_devices);
   auto it = ptu_devices.find(std::make_tuple(dev_id, lane));
   if (it != ptu_devices.end()) {
+    ptu_tcb_monitors.erase(std::make_tuple(dev_id, lane));
     it->second->stop_event();
+    // ptu_dev is destructed when the last handle is closed, maybe after
+    // fpga_dev_finish(), so registers are accessed no more after set_exited()
+    it->second->listen_close_all();
+    it->second->set_exited();
     ptu_devices.erase(it);
     return 0;
   } else {
@@ -90,21 +131,18 @@ int fpga_ptu_exit(uint32_t dev_id, uint32_t lane) {
 
 int fpga_ptu_rtp(uint32_t dev_id, uint32_t lane, in_port_t rtp_sport,
                  in_port_t rtp_eport) {
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     // enable RTP
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::RTPRX_ENA0, 0xffffffff);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::RTPRX_ENA1, 0xffffffff);
+    ptu->reg_write(PtuRegMap::RTPRX_ENA0, 0xffffffff);
+    ptu->reg_write(PtuRegMap::RTPRX_ENA1, 0xffffffff);
 
     // set buffer address
     constexpr uint32_t RTP_BUF_OFFSET = 32UL * 2UL * 32UL * 1024UL * 1024UL;
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::RTPRX_BASE, RTP_BUF_OFFSET);
+    ptu->reg_write(PtuRegMap::RTPRX_BASE, RTP_BUF_OFFSET);
 
     // set RTP port
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::RTPRX_PORT, (rtp_sport << 16) | rtp_eport);
+    ptu->reg_write(PtuRegMap::RTPRX_PORT, (rtp_sport << 16) | rtp_eport);
 
     return 0;
   } else {
@@ -116,12 +154,11 @@ int fpga_ptu_rtp(uint32_t dev_id, uint32_t lane, in_port_t rtp_sport,
 }
 
 int fpga_ptu_rtp_reset(uint32_t dev_id, uint32_t lane) {
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     // reset RTP
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::RTPRX_RST0, 0xffffffff);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::RTPRX_RST1, 0xffffffff);
+    ptu->reg_write(PtuRegMap::RTPRX_RST0, 0xffffffff);
+    ptu->reg_write(PtuRegMap::RTPRX_RST1, 0xffffffff);
 
     return 0;
   } else {
@@ -133,7 +170,14 @@ int fpga_ptu_rtp_reset(uint32_t dev_id, uint32_t lane) {
 }
 
 int fpga_ptu_listen(uint32_t dev_id, uint32_t lane, in_port_t port) {
-  int ret = ptu_devices[std::make_tuple(dev_id, lane)]->listen(port);
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  int ret = ptu->listen(port);
   if (ret != 0) {
     return -1;
   }
@@ -141,35 +185,133 @@ int fpga_ptu_listen(uint32_t dev_id, uint32_t lane, in_port_t port) {
 }
 
 int fpga_ptu_listen_close(uint32_t dev_id, uint32_t lane, in_port_t port) {
-  return ptu_devices[std::make_tuple(dev_id, lane)]->listen_close(port);
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  return ptu->listen_close(port);
 }
 
-int fpga_ptu_accept(uint32_t dev_id, uint32_t lane, in_port_t lport,
-                    in_addr_t raddr, in_port_t rport,
-                    const struct timeval *timeout, uint32_t *cid) {
+// common part of fpga_ptu_accept(), fpga_ptu_accept_exact(), fpga_ptu_connect()
+// and their handle variants, `ptu` is nullptr when ptu is not initialized
+static int ptu_conn(ptu_dev *ptu, uint32_t dev_id, uint32_t lane,
+                    in_port_t lport, in_addr_t raddr, in_port_t rport,
+                    const struct timeval *timeout, uint32_t *cid,
+                    bool is_accept, bool exact, const char *func) {
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, func);
+    return -FAILURE_DEVICE_OPEN;
+  }
   uint64_t timeout_us = 0;
   if (timeout != NULL) {
     timeout_us = timeout->tv_sec * 1000000 + timeout->tv_usec;
   }
 
-  return ptu_devices[std::make_tuple(dev_id, lane)]->accept(
-      lport, raddr, rport, timeout_us, cid);
+  if (is_accept) {
+    return ptu->accept(lport, raddr, rport, timeout_us, cid, exact);
+  } else {
+    return ptu->connect(lport, raddr, rport, timeout_us, cid);
+  }
+}
+
+int fpga_ptu_accept(uint32_t dev_id, uint32_t lane, in_port_t lport,
+                    in_addr_t raddr, in_port_t rport,
+                    const struct timeval *timeout, uint32_t *cid) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_conn(ptu.get(), dev_id, lane, lport, raddr, rport, timeout, cid,
+                  true, false, __func__);
+}
+
+int fpga_ptu_accept_exact(uint32_t dev_id, uint32_t lane, in_port_t lport,
+                          in_addr_t raddr, in_port_t rport,
+                          const struct timeval *timeout, uint32_t *cid) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_conn(ptu.get(), dev_id, lane, lport, raddr, rport, timeout, cid,
+                  true, true, __func__);
 }
 
 int fpga_ptu_connect(uint32_t dev_id, uint32_t lane, in_port_t lport,
                      in_addr_t raddr, in_port_t rport,
                      const struct timeval *timeout, uint32_t *cid) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_conn(ptu.get(), dev_id, lane, lport, raddr, rport, timeout, cid,
+                  false, false, __func__);
+}
+
+// common part of fpga_ptu_connect_batch(), fpga_ptu_accept_batch() and their
+// handle variants, `ptu` is nullptr when ptu is not initialized
+static int ptu_conn_batch(ptu_dev *ptu, uint32_t dev_id, uint32_t lane,
+                          fpga_ptu_conn_req_t *reqs, uint32_t num,
+                          const struct timeval *timeout,
+                          fpga_ptu_conn_cb_t callback, void *arg,
+                          bool is_accept, const char *func) {
+  /* input check */
+  if (!reqs || num == 0) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(reqs %#lx, num %u) %s: Invalid argument\n",
+                (uintptr_t)reqs, num, func);
+    return -INVALID_ARGUMENT;
+  }
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, func);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), num(%u)\n",
+              func, dev_id, lane, num);
+
   uint64_t timeout_us = 0;
   if (timeout != NULL) {
     timeout_us = timeout->tv_sec * 1000000 + timeout->tv_usec;
   }
 
-  return ptu_devices[std::make_tuple(dev_id, lane)]->connect(
-      lport, raddr, rport, timeout_us, cid);
+  ptu_dev::conn_cb cb;
+  if (callback) {
+    cb = [=](const fpga_ptu_conn_req_t &req) {
+      callback(dev_id, lane, &req, arg);
+    };
+  }
+
+  if (is_accept) {
+    return ptu->accept_batch(reqs, num, timeout_us, cb);
+  } else {
+    return ptu->connect_batch(reqs, num, timeout_us, cb);
+  }
+}
+
+int fpga_ptu_connect_batch(uint32_t dev_id, uint32_t lane,
+                           fpga_ptu_conn_req_t *reqs, uint32_t num,
+                           const struct timeval *timeout,
+                           fpga_ptu_conn_cb_t callback, void *arg) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_conn_batch(ptu.get(), dev_id, lane, reqs, num, timeout, callback,
+                        arg, false, __func__);
+}
+
+int fpga_ptu_accept_batch(uint32_t dev_id, uint32_t lane,
+                          fpga_ptu_conn_req_t *reqs, uint32_t num,
+                          const struct timeval *timeout,
+                          fpga_ptu_conn_cb_t callback, void *arg) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_conn_batch(ptu.get(), dev_id, lane, reqs, num, timeout, callback,
+                        arg, true, __func__);
 }
 
 int fpga_ptu_disconnect(uint32_t dev_id, uint32_t lane, uint32_t cid) {
-  return ptu_devices[std::make_tuple(dev_id, lane)]->abort(cid);
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  return ptu->abort(cid);
 }
 
 int fpga_ptu_mod_setting(
@@ -179,10 +321,11 @@ int fpga_ptu_mod_setting(
   in_addr_t gateway,
   uint8_t mac[6]
 ) {
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), addr(0x%x), gateway(0x%x), mac(%02x:%02x:%02x:%02x:%02x:%02x)\n",
                 __func__, dev_id, lane, addr, gateway, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    ptu_devices[std::make_tuple(dev_id, lane)]->modify(addr, gateway, mac);
+    ptu->modify(addr, gateway, mac);
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -208,23 +351,19 @@ int fpga_ptu_get_setting(
     return -INVALID_ARGUMENT;
   }
 
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", __func__, dev_id, lane);
-    *addr = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::MY_IPV4_ADDR);
-    *subnet = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::MY_IPV4_SUBNET);
-    *gateway = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::MY_IPV4_GATEWAY);
-
-    uint32_t data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::MY_MAC_HI);
+    *addr = ptu->reg_read(PtuRegMap::MY_IPV4_ADDR);
+    *subnet = ptu->reg_read(PtuRegMap::MY_IPV4_SUBNET);
+    *gateway = ptu->reg_read(PtuRegMap::MY_IPV4_GATEWAY);
+
+    uint32_t data = ptu->reg_read(PtuRegMap::MY_MAC_HI);
     mac[0] = static_cast<uint8_t>((data & 0x0000FF00) >> 8);
     mac[1] = static_cast<uint8_t>(data  & 0x000000FF);
 
     data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::MY_MAC_LO);
+    data = ptu->reg_read(PtuRegMap::MY_MAC_LO);
     mac[2] = static_cast<uint8_t>((data & 0xFF000000) >> 24);
     mac[3] = static_cast<uint8_t>((data & 0x00FF0000) >> 16);
     mac[4] = static_cast<uint8_t>((data & 0x0000FF00) >>  8);
@@ -245,26 +384,23 @@ int fpga_ptu_set_arp_entry(
   in_addr_t addr,
   uint8_t mac[6]
 ) {
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), addr(0x%x), mac(%02x:%02x:%02x:%02x:%02x:%02x)\n",
                 __func__, dev_id, lane, addr, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_ARG0, addr);
-
     uint32_t mac_hi =
         static_cast<uint32_t>(mac[0]) << 8 | static_cast<uint32_t>(mac[1]);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_ARG1, mac_hi);
-
     uint32_t mac_lo = static_cast<uint32_t>(mac[2]) << 24 |
                       static_cast<uint32_t>(mac[3]) << 16 |
                       static_cast<uint32_t>(mac[4]) << 8 |
                       static_cast<uint32_t>(mac[5]);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_ARG2, mac_lo);
 
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_COMMAND, ARP_SET_ENTRY);
+    // arguments and command at once not to be mixed with other ARP commands
+    ptu->reg_write_seq({{PtuRegMap::ARP_ARG0, addr},
+                        {PtuRegMap::ARP_ARG1, mac_hi},
+                        {PtuRegMap::ARP_ARG2, mac_lo},
+                        {PtuRegMap::ARP_COMMAND, ARP_SET_ENTRY}});
+    ptu->arp_invalidate();
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -279,13 +415,12 @@ int fpga_ptu_del_arp_entry(
   uint32_t lane,
   in_addr_t addr
 ) {
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), addr(0x%x)\n", __func__, dev_id, lane, addr);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_ARG0, addr);
-
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_COMMAND, ARP_DEL_ENTRY);
+    ptu->reg_write_seq({{PtuRegMap::ARP_ARG0, addr},
+                        {PtuRegMap::ARP_COMMAND, ARP_DEL_ENTRY}});
+    ptu->arp_invalidate();
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -309,16 +444,15 @@ int fpga_ptu_set_arp_retry(
     return -INVALID_ARGUMENT;
   }
 
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), timeout(%u), retry_num(%u)\n", __func__, dev_id, lane, timeout, retry_num);
     uint32_t data = 0;
     data |= static_cast<uint32_t>(timeout   & 0x000001FF) << 16;
     data |= static_cast<uint32_t>(retry_num & 0x0000000F);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_ARG0, data);
+    ptu->reg_write(PtuRegMap::ARP_ARG0, data);
 
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_COMMAND, ARP_SET_RETRY);
+    ptu->reg_write(PtuRegMap::ARP_COMMAND, ARP_SET_RETRY);
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -341,16 +475,15 @@ int fpga_ptu_set_arp_aging_en(
     return -INVALID_ARGUMENT;
   }
 
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), enable_flag(%u)\n", __func__, dev_id, lane, enable_flag);
     if (enable_flag == 1) {
       // enable
-      ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-          PtuRegMap::ARP_COMMAND, ARP_ENA_AGE);
+      ptu->reg_write(PtuRegMap::ARP_COMMAND, ARP_ENA_AGE);
     } else {
       // disable
-      ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-          PtuRegMap::ARP_COMMAND, ARP_DIS_AGE);
+      ptu->reg_write(PtuRegMap::ARP_COMMAND, ARP_DIS_AGE);
     }
     return 0;
   } else {
@@ -374,10 +507,10 @@ int fpga_ptu_get_arp_status(
     return -INVALID_ARGUMENT;
   }
 
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", __func__, dev_id, lane);
-    uint32_t data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::ARP_STATUS);
+    uint32_t data = ptu->reg_read(PtuRegMap::ARP_STATUS);
     arp_status->sts_pmnt_rest       = static_cast<uint16_t>(data & 0x0000FFFF);
     arp_status->sts_entry_evicted   = static_cast<uint8_t>((data & 0x80000000) >> 31);
     arp_status->sts_aging_enabled   = static_cast<uint8_t>((data & 0x40000000) >> 30);
@@ -397,14 +530,14 @@ int fpga_ptu_clear_arp_status(
   uint32_t lane,
   fpga_arp_status_t arp_status
 ) {
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", __func__, dev_id, lane);
     uint32_t data = 0;
     // Only sts_entry_evicted & sts_ipv4_conflicted
     data |= static_cast<uint32_t>(arp_status.sts_entry_evicted   & 0x01) << 31;
     data |= static_cast<uint32_t>(arp_status.sts_ipv4_conflicted & 0x01) << 29;
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_STATUS, data);
+    ptu->reg_write(PtuRegMap::ARP_STATUS, data);
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -423,42 +556,19 @@ int fpga_ptu_get_arp_entry(
   /* input check */
   if (!arp_entry) {
     log_libfpga(LIBFPGA_LOG_ERROR,
-                LIBPTU "(arp_entry %lf) %s: Invalid argument\n", (uintptr_t)arp_entry,
+                LIBPTU "(arp_entry %#lx) %s: Invalid argument\n", (uintptr_t)arp_entry,
                 __func__);
     return -INVALID_ARGUMENT;
   }
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), index(%u)\n", __func__, dev_id, lane, index);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_ARG0, index);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(
-        PtuRegMap::ARP_COMMAND, ARP_DUMP_ENTRY);
-
-    uint32_t datav = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::PTU_VERSION);
-    log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] VERSION 0x%x\n", __func__, datav);
-    uint32_t data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::ARP_ENTRY);
-    log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] data 0x%x\n", __func__, data);
-    arp_entry->dump_permanent = static_cast<uint8_t>((data  & 0x80000000) >> 31);
-    arp_entry->dump_incmp     = static_cast<uint8_t>((data  & 0x40000000) >> 30);
-    arp_entry->dump_used      = static_cast<uint8_t>((data  & 0x20000000) >> 29);
-    arp_entry->dump_life      = static_cast<uint16_t>((data & 0x01FF0000) >> 16);
-    arp_entry->dump_retry     = static_cast<uint8_t>((data  & 0x00000F00) >> 8);
-    arp_entry->dump_arp_index = static_cast<uint8_t>(data   & 0x000000FF);
-
-    uint32_t ipaddr = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::ARP_IPV4);
-    arp_entry->dump_ipddr = ipaddr;
-
-    uint32_t mac_hi = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::ARP_MAC_HI);
-    arp_entry->dump_mac = static_cast<uint64_t>(mac_hi) << 32;
-
-    uint32_t mac_lo = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::ARP_MAC_LO);
-    arp_entry->dump_mac |= static_cast<uint64_t>(mac_lo);
-
+    if (ptu->get_arp_entry(index, arp_entry) != 0) {
+      log_libfpga(LIBFPGA_LOG_ERROR,
+                  LIBPTU "(dev %u, ptu %u) %s: failed to read arp entry %u\n",
+                  dev_id, lane, __func__, index);
+      return -FAILURE_IOCTL;
+    }
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -468,173 +578,215 @@ int fpga_ptu_get_arp_entry(
   }
 }
 
-int fpga_ptu_get_stat(
-  uint32_t dev_id,
-  uint32_t lane,
-  fpga_ptu_stat_t *ptu_stat
-) {
+// common part of fpga_ptu_dump_arp_table() and fpga_ptu_dump_arp_table_cached()
+static int ptu_dump_arp_table(uint32_t dev_id, uint32_t lane,
+                              fpga_arp_entry_t *arp_entries, uint32_t max,
+                              uint32_t *num, bool is_cached,
+                              const struct timeval *max_age, uint8_t *refreshed,
+                              const char *func) {
   /* input check */
-  if (!ptu_stat) {
+  if ((!arp_entries && max > 0) || !num) {
     log_libfpga(LIBFPGA_LOG_ERROR,
-                LIBPTU "(ptu_stat %lf) %s: Invalid argument\n", (uintptr_t)ptu_stat,
-                __func__);
+                LIBPTU "(arp_entries %#lx, num %#lx) %s: Invalid argument\n",
+                (uintptr_t)arp_entries, (uintptr_t)num, func);
     return -INVALID_ARGUMENT;
   }
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
-    log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", __func__, dev_id, lane);
-    uint32_t data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RECV_FRAME_CNT);
-    ptu_stat->recv_frame_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RECV_RAWETH_CNT);
-    ptu_stat->recv_raweth_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::DROP_RAWETH_CNT);
-    ptu_stat->drop_raweth_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RECV_RAWIP_CNT);
-    ptu_stat->recv_rawip_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::DROP_RAWIP_CNT);
-    ptu_stat->drop_rawip_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RECV_UDP_CNT);
-    ptu_stat->recv_tcp_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::DROP_UDP_CNT);
-    ptu_stat->drop_tcp_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RECV_TCP_CNT);
-    ptu_stat->recv_tcp_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::DROP_TCP_CNT);
-    ptu_stat->drop_tcp_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::DROP_TCP_CNT);
-    ptu_stat->drop_tcp_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::SEND_FRAME_CNT);
-    ptu_stat->send_frame_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::SEND_RAWETH_CNT);
-    ptu_stat->send_raweth_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::SEND_RAWIP_CNT);
-    ptu_stat->send_rawip_cnt = data;
-
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::SEND_TCP_CNT);
-    ptu_stat->send_tcp_cnt = data;
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, func);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", func, dev_id, lane);
+
+  std::vector<fpga_arp_entry_t> entries;
+  int ret;
+  if (is_cached) {
+    uint64_t max_age_us = 0;
+    if (max_age != NULL) {
+      max_age_us = max_age->tv_sec * 1000000 + max_age->tv_usec;
+    }
+    bool is_refreshed = false;
+    ret = ptu->dump_arp_table_cached(max_age_us, entries, &is_refreshed);
+    if (refreshed) {
+      *refreshed = is_refreshed;
+    }
+  } else {
+    ret = ptu->dump_arp_table(entries);
+  }
+  if (ret != 0) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: failed to dump arp table\n", dev_id,
+                lane, func);
+    return -FAILURE_IOCTL;
+  }
 
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::TCP_CTL_STATUS);
-    ptu_stat->tcp_ctl_status = data;
+  for (uint32_t i = 0; i < max && i < entries.size(); i++) {
+    arp_entries[i] = entries[i];
+  }
+  *num = entries.size();
 
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RAWETH_RX_CMD_CNT);
-    ptu_stat->raweth_rx_cmd_cnt = data;
+  return 0;
+}
 
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::RAWETH_RX_LEN);
-    ptu_stat->raweth_rx_len = data;
+int fpga_ptu_dump_arp_table(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_arp_entry_t *arp_entries,
+  uint32_t max,
+  uint32_t *num
+) {
+  return ptu_dump_arp_table(dev_id, lane, arp_entries, max, num, false,
+                            NULL, NULL, __func__);
+}
 
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::TCP_EVENT_MISS);
-    ptu_stat->tcp_event_miss       = static_cast<uint16_t>((data & 0xFFFF0000) >> 16);
-    ptu_stat->tcp_event_miss_queue = static_cast<uint16_t>(data  & 0x0000FFFF);
+int fpga_ptu_dump_arp_table_cached(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_arp_entry_t *arp_entries,
+  uint32_t max,
+  uint32_t *num,
+  const struct timeval *max_age,
+  uint8_t *refreshed
+) {
+  return ptu_dump_arp_table(dev_id, lane, arp_entries, max, num, true,
+                            max_age, refreshed, __func__);
+}
 
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::TCP_EVENT_CNT);
-    ptu_stat->tcp_event_cnt   = static_cast<uint16_t>((data & 0xFFFF0000) >> 16);
-    ptu_stat->tcp_event_merge = static_cast<uint16_t>(data  & 0x0000FFFF);
+// Status registers read by fpga_ptu_get_stat_snapshot()
+constexpr uint32_t PTU_STAT_REG_HEAD = PtuRegMap::TCP_EVENT_MISS;
+constexpr uint32_t PTU_STAT_REG_NUM =
+    PtuRegMap::RAWETH_RX_LEN - PTU_STAT_REG_HEAD + 1;
 
-    data = 0;
-    data = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(
-        PtuRegMap::TCP_CMD_CNT);
-    ptu_stat->tcp_cmd_cnt       = static_cast<uint16_t>((data & 0xFFFF0000) >> 16);
-    ptu_stat->tcp_cmd_cnt_avail = static_cast<uint8_t>(data   & 0x000000FF);
+int fpga_ptu_get_stat(
+  uint32_t dev_id,
+  uint32_t lane,
+  fpga_ptu_stat_t *ptu_stat
+) {
+  return fpga_ptu_get_stat_snapshot(dev_id, lane, ptu_stat, NULL);
+}
 
-    return 0;
-  } else {
+// common part of fpga_ptu_get_stat_snapshot() and fpga_ptu_hdl_get_stat(),
+// `ptu` is nullptr when ptu is not initialized
+static int ptu_get_stat(ptu_dev *ptu, uint32_t dev_id, uint32_t lane,
+                        fpga_ptu_stat_t *ptu_stat, struct timespec *timestamp,
+                        const char *func) {
+  /* input check */
+  if (!ptu_stat) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(ptu_stat %#lx) %s: Invalid argument\n", (uintptr_t)ptu_stat,
+                func);
+    return -INVALID_ARGUMENT;
+  }
+  if (!ptu) {
     log_libfpga(LIBFPGA_LOG_ERROR,
                 LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
-                lane, __func__);
+                lane, func);
     return -FAILURE_DEVICE_OPEN;
   }
-}
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", func, dev_id, lane);
 
+  uint32_t regs[PTU_STAT_REG_NUM];
+  int ret = ptu->reg_read_block(PTU_STAT_REG_HEAD, PTU_STAT_REG_NUM, regs);
+  if (ret) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: failed to read registers(%d)\n", dev_id,
+                lane, func, ret);
+    return ret;
+  }
+  if (timestamp)
+    clock_gettime(CLOCK_MONOTONIC, timestamp);
+
+  auto reg = [&regs](uint32_t reg_idx) { return regs[reg_idx - PTU_STAT_REG_HEAD]; };
+  uint32_t data;
+
+  ptu_stat->recv_frame_cnt    = reg(PtuRegMap::RECV_FRAME_CNT);
+  ptu_stat->recv_raweth_cnt   = reg(PtuRegMap::RECV_RAWETH_CNT);
+  ptu_stat->drop_raweth_cnt   = reg(PtuRegMap::DROP_RAWETH_CNT);
+  ptu_stat->recv_rawip_cnt    = reg(PtuRegMap::RECV_RAWIP_CNT);
+  ptu_stat->drop_rawip_cnt    = reg(PtuRegMap::DROP_RAWIP_CNT);
+  ptu_stat->recv_tcp_cnt      = reg(PtuRegMap::RECV_TCP_CNT);
+  ptu_stat->drop_tcp_cnt      = reg(PtuRegMap::DROP_TCP_CNT);
+  ptu_stat->send_frame_cnt    = reg(PtuRegMap::SEND_FRAME_CNT);
+  ptu_stat->send_raweth_cnt   = reg(PtuRegMap::SEND_RAWETH_CNT);
+  ptu_stat->send_rawip_cnt    = reg(PtuRegMap::SEND_RAWIP_CNT);
+  ptu_stat->send_tcp_cnt      = reg(PtuRegMap::SEND_TCP_CNT);
+  ptu_stat->tcp_ctl_status    = reg(PtuRegMap::TCP_CTL_STATUS);
+  ptu_stat->raweth_rx_cmd_cnt = reg(PtuRegMap::RAWETH_RX_CMD_CNT);
+  ptu_stat->raweth_rx_len     = reg(PtuRegMap::RAWETH_RX_LEN);
+
+  data = reg(PtuRegMap::TCP_EVENT_MISS);
+  ptu_stat->tcp_event_miss       = static_cast<uint16_t>((data & 0xFFFF0000) >> 16);
+  ptu_stat->tcp_event_miss_queue = static_cast<uint16_t>(data  & 0x0000FFFF);
+
+  data = reg(PtuRegMap::TCP_EVENT_CNT);
+  ptu_stat->tcp_event_cnt   = static_cast<uint16_t>((data & 0xFFFF0000) >> 16);
+  ptu_stat->tcp_event_merge = static_cast<uint16_t>(data  & 0x0000FFFF);
+
+  data = reg(PtuRegMap::TCP_CMD_CNT);
+  ptu_stat->tcp_cmd_cnt       = static_cast<uint16_t>((data & 0xFFFF0000) >> 16);
+  ptu_stat->tcp_cmd_cnt_avail = static_cast<uint8_t>(data   & 0x000000FF);
 
-int fpga_ptu_dump_tcb(
+  return 0;
+}
+
+int fpga_ptu_get_stat_snapshot(
   uint32_t dev_id,
   uint32_t lane,
-  uint32_t cid,
-  fpga_dump_tcb_t *dump_tcb
+  fpga_ptu_stat_t *ptu_stat,
+  struct timespec *timestamp
 ) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_get_stat(ptu.get(), dev_id, lane, ptu_stat, timestamp, __func__);
+}
+
+// common part of fpga_ptu_dump_tcb() and fpga_ptu_hdl_dump_tcb(),
+// `ptu` is nullptr when ptu is not initialized
+static int ptu_dump_tcb(ptu_dev *ptu, uint32_t dev_id, uint32_t lane,
+                        uint32_t cid, fpga_dump_tcb_t *dump_tcb,
+                        const char *func) {
   /* input check */
   if (!dump_tcb) {
     log_libfpga(LIBFPGA_LOG_ERROR,
                 LIBPTU "(dump_tcb 0x%llx) %s: Invalid argument\n", (uintptr_t)dump_tcb,
-                __func__);
+                func);
     return -INVALID_ARGUMENT;
   }
   if (cid < 1 || cid > 511) {
     log_libfpga(LIBFPGA_LOG_ERROR,
                 LIBPTU "(cid %u) %s: Invalid argument\n", cid,
-                __func__);
+                func);
     return -INVALID_ARGUMENT;
   }
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
-    log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), cid(%u)\n", __func__, dev_id, lane, cid);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(PtuRegMap::TCP_CID, cid);
-    ptu_devices[std::make_tuple(dev_id, lane)]->reg_write(PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_DUMP_TCB);
-
-    dump_tcb->tcb_usr_read = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_USR_READ);
-    dump_tcb->tcb_usr_wrt  = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_USR_WRT);
-    dump_tcb->tcb_snd_una  = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_SND_UNA);
-    dump_tcb->tcb_snd_nxt  = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_SND_NXT);
-    dump_tcb->tcb_rcv_nxt  = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_RCV_NXT);
-    dump_tcb->tcb_rcv_up   = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_RCV_UP);
-    dump_tcb->tcb_snd_wnd  = ptu_devices[std::make_tuple(dev_id, lane)]->reg_read(PtuRegMap::TCB_SND_WND);
+  if (ptu) {
+    log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), cid(%u)\n", func, dev_id, lane, cid);
+    if (ptu->dump_tcb(cid, dump_tcb) != 0) {
+      log_libfpga(LIBFPGA_LOG_ERROR,
+                  LIBPTU "(dev %u, ptu %u, cid %u) %s: failed to dump tcb\n", dev_id,
+                  lane, cid, func);
+      return -FAILURE_IOCTL;
+    }
 
     return 0;
   } else {
     log_libfpga(LIBFPGA_LOG_ERROR,
                 LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
-                lane, __func__);
+                lane, func);
     return -FAILURE_DEVICE_OPEN;
   }
 }
 
+int fpga_ptu_dump_tcb(
+  uint32_t dev_id,
+  uint32_t lane,
+  uint32_t cid,
+  fpga_dump_tcb_t *dump_tcb
+) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  return ptu_dump_tcb(ptu.get(), dev_id, lane, cid, dump_tcb, __func__);
+}
+
 struct fpga_ptu_wait_tcb_buffer_empty_struct {
   uint32_t dev_id;  /**< Argument for fpga_ptu_dump_tcb */
   uint32_t lane;    /**< Argument for fpga_ptu_dump_tcb */
@@ -684,7 +836,8 @@ int fpga_ptu_wait_tcb_buffer_empty(
                 __func__);
     return -INVALID_ARGUMENT;
   }
-  if (ptu_devices.find(std::make_tuple(dev_id, lane)) != ptu_devices.end()) {
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (ptu) {
     log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), cid(%u)\n", __func__, dev_id, lane, cid);
 
     struct fpga_ptu_wait_tcb_buffer_empty_struct clb_argument = {
@@ -716,3 +869,329 @@ int fpga_ptu_wait_tcb_buffer_empty(
 
   return 0;
 }
+
+int fpga_ptu_tcb_monitor_start(uint32_t dev_id, uint32_t lane,
+                               const struct timeval *interval,
+                               uint32_t history) {
+  /* input check */
+  if (!interval || (interval->tv_sec == 0 && interval->tv_usec == 0) ||
+      history == 0) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(interval %#lx, history %u) %s: Invalid argument\n",
+                (uintptr_t)interval, history, __func__);
+    return -INVALID_ARGUMENT;
+  }
+  std::unique_lock<std::shared_mutex> lk(mtx_ptu_devices);
+  auto it = ptu_devices.find(std::make_tuple(dev_id, lane));
+  if (it == ptu_devices.end()) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  if (ptu_tcb_monitors.find(std::make_tuple(dev_id, lane)) !=
+      ptu_tcb_monitors.end()) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: already started\n", dev_id,
+                lane, __func__);
+    return -INVALID_ARGUMENT;
+  }
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), history(%u)\n",
+              __func__, dev_id, lane, history);
+
+  uint64_t interval_us = interval->tv_sec * 1000000 + interval->tv_usec;
+  ptu_tcb_monitors[std::make_tuple(dev_id, lane)] =
+      std::unique_ptr<ptu_tcb_mon>(
+          new ptu_tcb_mon(it->second.get(), interval_us, history));
+
+  return 0;
+}
+
+int fpga_ptu_tcb_monitor_stop(uint32_t dev_id, uint32_t lane) {
+  std::unique_lock<std::shared_mutex> lk(mtx_ptu_devices);
+  if (ptu_tcb_monitors.erase(std::make_tuple(dev_id, lane)) == 0) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: monitor not started\n", dev_id,
+                lane, __func__);
+    return -1;
+  }
+  return 0;
+}
+
+int fpga_ptu_tcb_monitor_get_table(uint32_t dev_id, uint32_t lane,
+                                   fpga_ptu_tcb_rate_t *table, uint32_t max,
+                                   uint32_t *num) {
+  // the monitor is not destructed while the lock is held
+  std::shared_lock<std::shared_mutex> lk(mtx_ptu_devices);
+  auto it = ptu_tcb_monitors.find(std::make_tuple(dev_id, lane));
+  if ((!table && max > 0) || !num || it == ptu_tcb_monitors.end()) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u, table %#lx, num %#lx) %s: Invalid argument\n",
+                dev_id, lane, (uintptr_t)table, (uintptr_t)num, __func__);
+    return -INVALID_ARGUMENT;
+  }
+
+  std::vector<fpga_ptu_tcb_rate_t> rates;
+  it->second->get_table(rates);
+  for (uint32_t i = 0; i < max && i < rates.size(); i++) {
+    table[i] = rates[i];
+  }
+  *num = rates.size();
+
+  return 0;
+}
+
+int fpga_ptu_tcb_monitor_get_series(uint32_t dev_id, uint32_t lane,
+                                    uint32_t cid, fpga_ptu_tcb_rate_t *series,
+                                    uint32_t max, uint32_t *num) {
+  // the monitor is not destructed while the lock is held
+  std::shared_lock<std::shared_mutex> lk(mtx_ptu_devices);
+  auto it = ptu_tcb_monitors.find(std::make_tuple(dev_id, lane));
+  if ((!series && max > 0) || !num || it == ptu_tcb_monitors.end()) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u, series %#lx, num %#lx) %s: Invalid argument\n",
+                dev_id, lane, (uintptr_t)series, (uintptr_t)num, __func__);
+    return -INVALID_ARGUMENT;
+  }
+
+  std::vector<fpga_ptu_tcb_rate_t> rates;
+  if (!it->second->get_series(cid, rates)) {
+    return -1;
+  }
+  // keep the latest samples when `series` is short
+  uint32_t skip = rates.size() > max ? rates.size() - max : 0;
+  for (uint32_t i = skip; i < rates.size(); i++) {
+    series[i - skip] = rates[i];
+  }
+  *num = rates.size();
+
+  return 0;
+}
+
+struct fpga_ptu_wait_tcb_buffer_empty_multi_struct {
+  ptu_dev *dev;          /**< Target PTU */
+  const uint32_t *cids;  /**< Target cids */
+  uint32_t num;          /**< Num of cids */
+  bool wait_any;         /**< Complete when any of cids is drained */
+  uint8_t *drained;      /**< Result of each cid */
+};
+
+/**
+ * @brief Function which check TCBs of all cids once to enable __fpga_common_polling()
+ * @retval 0 Success
+ * @retval (>0) Error(continue polling)
+ * @retval (<0) Error(stop polling)
+ */
+static int __fpga_ptu_wait_tcb_buffer_empty_multi_clb(
+  void *arg
+) {
+  struct fpga_ptu_wait_tcb_buffer_empty_multi_struct *argument =
+    (struct fpga_ptu_wait_tcb_buffer_empty_multi_struct*)arg;  // NOLINT
+
+  if (argument->dev->check_tcb_drained(argument->cids, argument->num, argument->drained))
+    return -FAILURE_IOCTL;
+
+  uint32_t drained_num = 0;
+  for (uint32_t i = 0; i < argument->num; i++)
+    drained_num += argument->drained[i] ? 1 : 0;
+
+  if (argument->wait_any)
+    return drained_num > 0 ? 0 : 1;
+  else
+    return drained_num == argument->num ? 0 : 1;
+}
+
+int fpga_ptu_wait_tcb_buffer_empty_multi(
+  uint32_t dev_id,
+  uint32_t lane,
+  const uint32_t *cids,
+  uint32_t num,
+  uint8_t wait_any,
+  const struct timeval *timeout,
+  const struct timeval *interval,
+  uint8_t *drained,
+  uint32_t *is_success
+) {
+  if (!is_success || !cids || num == 0) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(cids %#lx, num %u, is_success %#lx) %s: Invalid argument\n",
+                (uintptr_t)cids, num, (uintptr_t)is_success, __func__);
+    return -INVALID_ARGUMENT;
+  }
+  for (uint32_t i = 0; i < num; i++) {
+    if (cids[i] < 1 || cids[i] > 511) {
+      log_libfpga(LIBFPGA_LOG_ERROR,
+                  LIBPTU "(cids[%u] %u) %s: Invalid argument\n", i, cids[i],
+                  __func__);
+      return -INVALID_ARGUMENT;
+    }
+  }
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u), num(%u), wait_any(%u)\n",
+              __func__, dev_id, lane, num, wait_any);
+
+  std::vector<uint8_t> result(num, 0);
+  struct fpga_ptu_wait_tcb_buffer_empty_multi_struct clb_argument = {
+    .dev = ptu.get(),
+    .cids = cids,
+    .num = num,
+    .wait_any = wait_any != 0,
+    .drained = result.data()};
+
+  int ret = __fpga_common_polling(
+    timeout,
+    interval,
+    __fpga_ptu_wait_tcb_buffer_empty_multi_clb,
+    (void*)&clb_argument);  // NOLINT
+
+  if (ret < 0)
+    return ret;
+
+  if (drained) {
+    for (uint32_t i = 0; i < num; i++)
+      drained[i] = result[i];
+  }
+  *is_success = !ret ? true : false;
+
+  return 0;
+}
+
+int fpga_ptu_open(uint32_t dev_id, uint32_t lane, fpga_ptu_handle_t *handle) {
+  /* input check */
+  if (!handle) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(handle %#lx) %s: Invalid argument\n",
+                (uintptr_t)handle, __func__);
+    return -INVALID_ARGUMENT;
+  }
+  std::shared_ptr<ptu_dev> ptu = ptu_get(dev_id, lane);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n", dev_id,
+                lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n", __func__, dev_id, lane);
+
+  *handle = new fpga_ptu_handle{dev_id, lane, ptu};
+
+  return 0;
+}
+
+int fpga_ptu_close(fpga_ptu_handle_t handle) {
+  /* input check */
+  if (!handle) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(handle %#lx) %s: Invalid argument\n",
+                (uintptr_t)handle, __func__);
+    return -INVALID_ARGUMENT;
+  }
+  log_libfpga(LIBFPGA_LOG_DEBUG, LIBPTU "[%s] dev_id(%u), lane(%u)\n",
+              __func__, handle->dev_id, handle->lane);
+
+  // ptu_dev is destructed here if fpga_ptu_exit() was already called
+  delete handle;
+
+  return 0;
+}
+
+// input check common to fpga_ptu_hdl_*()
+static bool ptu_hdl_check(fpga_ptu_handle_t handle, const char *func) {
+  if (!handle) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(handle %#lx) %s: Invalid argument\n",
+                (uintptr_t)handle, func);
+    return false;
+  }
+  return true;
+}
+
+int fpga_ptu_hdl_get_stat(fpga_ptu_handle_t handle, fpga_ptu_stat_t *ptu_stat,
+                          struct timespec *timestamp) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_get_stat(ptu_get(handle), handle->dev_id, handle->lane, ptu_stat,
+                      timestamp, __func__);
+}
+
+int fpga_ptu_hdl_dump_tcb(fpga_ptu_handle_t handle, uint32_t cid,
+                          fpga_dump_tcb_t *dump_tcb) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_dump_tcb(ptu_get(handle), handle->dev_id, handle->lane, cid,
+                      dump_tcb, __func__);
+}
+
+int fpga_ptu_hdl_accept(fpga_ptu_handle_t handle, in_port_t lport,
+                        in_addr_t raddr, in_port_t rport,
+                        const struct timeval *timeout, uint32_t *cid) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_conn(ptu_get(handle), handle->dev_id, handle->lane, lport, raddr,
+                  rport, timeout, cid, true, false, __func__);
+}
+
+int fpga_ptu_hdl_accept_exact(fpga_ptu_handle_t handle, in_port_t lport,
+                              in_addr_t raddr, in_port_t rport,
+                              const struct timeval *timeout, uint32_t *cid) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_conn(ptu_get(handle), handle->dev_id, handle->lane, lport, raddr,
+                  rport, timeout, cid, true, true, __func__);
+}
+
+int fpga_ptu_hdl_connect(fpga_ptu_handle_t handle, in_port_t lport,
+                         in_addr_t raddr, in_port_t rport,
+                         const struct timeval *timeout, uint32_t *cid) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_conn(ptu_get(handle), handle->dev_id, handle->lane, lport, raddr,
+                  rport, timeout, cid, false, false, __func__);
+}
+
+int fpga_ptu_hdl_connect_batch(fpga_ptu_handle_t handle,
+                               fpga_ptu_conn_req_t *reqs, uint32_t num,
+                               const struct timeval *timeout,
+                               fpga_ptu_conn_cb_t callback, void *arg) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_conn_batch(ptu_get(handle), handle->dev_id, handle->lane, reqs,
+                        num, timeout, callback, arg, false, __func__);
+}
+
+int fpga_ptu_hdl_accept_batch(fpga_ptu_handle_t handle,
+                              fpga_ptu_conn_req_t *reqs, uint32_t num,
+                              const struct timeval *timeout,
+                              fpga_ptu_conn_cb_t callback, void *arg) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  return ptu_conn_batch(ptu_get(handle), handle->dev_id, handle->lane, reqs,
+                        num, timeout, callback, arg, true, __func__);
+}
+
+int fpga_ptu_hdl_disconnect(fpga_ptu_handle_t handle, uint32_t cid) {
+  if (!ptu_hdl_check(handle, __func__)) {
+    return -INVALID_ARGUMENT;
+  }
+  ptu_dev *ptu = ptu_get(handle);
+  if (!ptu) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu not initialized\n",
+                handle->dev_id, handle->lane, __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  return ptu->abort(cid);
+}
@@ -11,55 +11,70 @@
 #include <algorithm>
 #include <chrono>
 
+#include <ptu_evt_loop.hpp>
 #include <ptu_reg_func.hpp>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
+#include <libfpgactl.h>
 #include <liblogging.h>
 #ifdef __cplusplus
 }
 #endif
 
-constexpr int POLL_EVT_MS = 100;  // 100ms
+constexpr int DRAIN_EVT_MAX = 64;  // max num of events handled per a pass
+constexpr uint32_t ARP_ENTRY_NUM = 256;  // num of ARP table indexes
+constexpr uint32_t CONNECT_REG_NUM = 4;  // num of registers written per a connect
+constexpr uint32_t CONNECT_BATCH_MAX = 16;  // max num of connects per a system call
+// give up issuing commands when none becomes issueable for this time
+constexpr auto CMD_AVAIL_WAIT = std::chrono::milliseconds(100);
+// re-read TCP_CMD_CNT at least this often while waiting for TCP events
+constexpr auto CMD_AVAIL_POLL = std::chrono::milliseconds(1);
 
 ptu_dev::ptu_dev(int fd, uint32_t id, uint32_t dev_id, uint32_t base)
     : fd_(fd),
       id_(id),
       dev_id_(dev_id),
       base_(base),
-      ip_addr_(0),
-      stop_evt_(false) {}
+      ip_addr_(0) {}
 
 ptu_dev::~ptu_dev(void) {
   stop_event();
-  std::unordered_set<uint16_t> socks;
-  {
-      std::lock_guard<std::mutex> lk(mtx_listen_socks_);
-      socks = listen_socks_;
+  // after fpga_ptu_exit(), fd_ may be already closed by fpga_dev_finish()
+  if (exited_) {
+    return;
   }
-  for (auto& it : socks) {
+  listen_close_all();
+}
+
+void ptu_dev::listen_close_all() {
+  std::lock_guard<std::mutex> lk(mtx_listen_socks_);
+  for (auto& it : listen_socks_) {
       tcp_listen_close(it);
   }
+  listen_socks_.clear();
+  listen_closed_ = true;
 }
 
 int ptu_dev::init(uint32_t ip_addr, uint32_t netmask, uint32_t gateway,
                   const uint8_t *mac) {
-  reg_write(PtuRegMap::MY_IPV4_ADDR, ip_addr);
-  reg_write(PtuRegMap::MY_IPV4_GATEWAY, gateway);
-
   uint32_t mac_hi =
       static_cast<uint32_t>(mac[0]) << 8 | static_cast<uint32_t>(mac[1]);
-  reg_write(PtuRegMap::MY_MAC_HI, mac_hi);
-
   uint32_t mac_lo = static_cast<uint32_t>(mac[2]) << 24 |
                     static_cast<uint32_t>(mac[3]) << 16 |
                     static_cast<uint32_t>(mac[4]) << 8 |
                     static_cast<uint32_t>(mac[5]);
-  reg_write(PtuRegMap::MY_MAC_LO, mac_lo);
-
   const uint32_t tcprxtx_base_val = 0x200000;
-  reg_write(PtuRegMap::TCPRXTX_BASE, tcprxtx_base_val);
+
+  {
+    std::lock_guard<std::mutex> lk(mtx_dev_);
+    reg_write_seq_priv({{PtuRegMap::MY_IPV4_ADDR, ip_addr},
+                        {PtuRegMap::MY_IPV4_GATEWAY, gateway},
+                        {PtuRegMap::MY_MAC_HI, mac_hi},
+                        {PtuRegMap::MY_MAC_LO, mac_lo},
+                        {PtuRegMap::TCPRXTX_BASE, tcprxtx_base_val}});
+  }
 
   ip_addr_ = ip_addr;
 
@@ -67,18 +82,20 @@ int ptu_dev::init(uint32_t ip_addr, uint32_t netmask, uint32_t gateway,
 }
 
 int ptu_dev::modify(uint32_t ip_addr, uint32_t gateway, const uint8_t *mac) {
-  reg_write(PtuRegMap::MY_IPV4_ADDR, ip_addr);
-  reg_write(PtuRegMap::MY_IPV4_GATEWAY, gateway);
-
   uint32_t mac_hi =
       static_cast<uint32_t>(mac[0]) << 8 | static_cast<uint32_t>(mac[1]);
-  reg_write(PtuRegMap::MY_MAC_HI, mac_hi);
-
   uint32_t mac_lo = static_cast<uint32_t>(mac[2]) << 24 |
                     static_cast<uint32_t>(mac[3]) << 16 |
                     static_cast<uint32_t>(mac[4]) << 8 |
                     static_cast<uint32_t>(mac[5]);
-  reg_write(PtuRegMap::MY_MAC_LO, mac_lo);
+
+  {
+    std::lock_guard<std::mutex> lk(mtx_dev_);
+    reg_write_seq_priv({{PtuRegMap::MY_IPV4_ADDR, ip_addr},
+                        {PtuRegMap::MY_IPV4_GATEWAY, gateway},
+                        {PtuRegMap::MY_MAC_HI, mac_hi},
+                        {PtuRegMap::MY_MAC_LO, mac_lo}});
+  }
 
   ip_addr_ = ip_addr;
 
@@ -87,6 +104,13 @@ int ptu_dev::modify(uint32_t ip_addr, uint32_t gateway, const uint8_t *mac) {
 
 int ptu_dev::listen(uint16_t lport) {
   std::lock_guard<std::mutex> lk(mtx_listen_socks_);
+  if (listen_closed_) {
+    // listen ports are closed by fpga_ptu_exit() just before exited_ is set
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu exited\n", dev_id_, id_,
+                __func__);
+    return -1;
+  }
   if (listen_socks_.find(lport) != listen_socks_.end()) {
     // already listen
     log_libfpga(LIBFPGA_LOG_ERROR,
@@ -97,6 +121,7 @@ int ptu_dev::listen(uint16_t lport) {
   listen_socks_.insert(lport);
 
   tcp_listen(lport);
+  ptu_evt_loop::instance().kick();
 
   return 0;
 }
@@ -118,7 +143,7 @@ int ptu_dev::listen_close(uint16_t lport) {
 }
 
 int ptu_dev::accept(uint16_t lport, uint32_t raddr, uint16_t rport,
-                    uint64_t timeout_us, uint32_t *cid) {
+                    uint64_t timeout_us, uint32_t *cid, bool exact) {
   sock_info info;
   info.laddr = ip_addr_;
   info.lport = lport;
@@ -128,11 +153,10 @@ int ptu_dev::accept(uint16_t lport, uint32_t raddr, uint16_t rport,
   // already established
   {
     std::lock_guard<std::mutex> lk(mtx_socks_);
-    if (socks_.find(info) != socks_.end()) {
-      if (socks_[info].state == tcp_st::ESTABLISHED) {
-        *cid = socks_[info].cid;
-        return 0;
-      }
+    auto it = socks_.find(info);
+    if (it != socks_.end() && it->second.state == tcp_st::ESTABLISHED) {
+      *cid = it->second.cid;
+      return 0;
     }
   }
 
@@ -147,60 +171,57 @@ int ptu_dev::accept(uint16_t lport, uint32_t raddr, uint16_t rport,
     }
   }
 
-  // wait establish
-  {
-    std::unique_lock<std::mutex> lk(mtx_socks_);
-    bool result;
-    if (timeout_us == 0) {
-      cv_socks_.wait(lk, [&] {
-        return std::any_of(socks_.begin(), socks_.end(), [&](const auto &sock) {
-          return sock.first.lport == lport;
-        });
-      });
-      result = true;
-    } else {
-      result =
-          cv_socks_.wait_for(lk, std::chrono::microseconds(timeout_us), [&] {
-            return std::any_of(
-                socks_.begin(), socks_.end(),
-                [&](const auto &sock) { return sock.first.lport == lport; });
-          });
-    }
+  // SYN may already be arriving, do not wait for the idle backoff
+  ptu_evt_loop::instance().kick();
 
-    if (!result) {
-      // timeout
-      log_libfpga(LIBFPGA_LOG_ERROR,
-                  LIBPTU "(dev %u, ptu %u) %s: timeout %llu us\n", dev_id_, id_,
-                  __func__, timeout_us);
-      return -1;
+  std::unique_lock<std::mutex> lk(mtx_socks_);
+  if (exact) {
+    // wait establish of the 4-tuple, connections from others do not wake us
+    int ret = wait_one(lk, info, timeout_us, true);
+    if (ret == 0) {
+      *cid = socks_.find(info)->second.cid;
     }
+    return ret;
+  }
 
-    if (socks_.find(info) == socks_.end()) {
-      // connected from unexpected IP or port
-      log_libfpga(LIBFPGA_LOG_ERROR,
-                  LIBPTU
-                  "(dev %u, ptu %u) %s: socket not found laddr=0x%08x lport=%u "
-                  "raddr=0x%08x rport=%u\n",
-                  dev_id_, id_, __func__, info.laddr, info.lport, info.raddr,
-                  info.rport);
-      return -2;
-    } else {
-      auto sock = socks_[info];
-      if (sock.state == tcp_st::ESTABLISHED) {
-        *cid = socks_[info].cid;
-        return 0;
-      } else {
-        // unexpected state
-        log_libfpga(LIBFPGA_LOG_ERROR,
-                    LIBPTU
-                    "(dev %u, ptu %u) %s: unexpected connection state cid=%u "
-                    "state=%d\n",
-                    dev_id_, id_, __func__, socks_[info].cid,
-                    socks_[info].state);
-        return -2;
-      }
-    }
+  // wait any connection on the port
+  bool result = wait_port(lk, lport, timeout_us);
+  if (exited_) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu exited\n", dev_id_, id_,
+                __func__);
+    return -FAILURE_DEVICE_OPEN;
   }
+  if (!result) {
+    // timeout
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: timeout %llu us\n", dev_id_, id_,
+                __func__, timeout_us);
+    return -1;
+  }
+
+  auto it = socks_.find(info);
+  if (it == socks_.end()) {
+    // connected from unexpected IP or port
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU
+                "(dev %u, ptu %u) %s: socket not found laddr=0x%08x lport=%u "
+                "raddr=0x%08x rport=%u\n",
+                dev_id_, id_, __func__, info.laddr, info.lport, info.raddr,
+                info.rport);
+    return -2;
+  }
+  if (it->second.state != tcp_st::ESTABLISHED) {
+    // unexpected state
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU
+                "(dev %u, ptu %u) %s: unexpected connection state cid=%u "
+                "state=%d\n",
+                dev_id_, id_, __func__, it->second.cid, it->second.state);
+    return -2;
+  }
+  *cid = it->second.cid;
+  return 0;
 }
 
 int ptu_dev::connect(uint16_t lport, uint32_t raddr, uint16_t rport,
@@ -228,38 +249,25 @@ int ptu_dev::connect(uint16_t lport, uint32_t raddr, uint16_t rport,
   conn.cid = 0;
   conn.state = tcp_st::SYN_SENT;
   conn.info = info;
-  socks_[info] = conn;
+  sock_insert_locked(conn);
 
+  // the event loop takes mtx_socks_, kick it without holding mtx_socks_
+  lk.unlock();
   tcp_connect(lport, raddr, rport);
+  ptu_evt_loop::instance().kick();
+  lk.lock();
 
-  bool result;
-  if (timeout_us == 0) {
-    cv_socks_.wait(lk, [&] {
-      return socks_.find(info) == socks_.end() ||
-             socks_[info].state != tcp_st::SYN_SENT;
-    });
-    result = true;
-  } else {
-    result = cv_socks_.wait_for(lk, std::chrono::microseconds(timeout_us), [&] {
-      return socks_.find(info) == socks_.end() ||
-             socks_[info].state != tcp_st::SYN_SENT;
-    });
-  }
-
-  if (!result) {
-    // timeout
-    log_libfpga(LIBFPGA_LOG_ERROR,
-                LIBPTU "(dev %u, ptu %u) %s: timeout %llu us\n", dev_id_, id_,
-                __func__, timeout_us);
-    return -1;
+  int ret = wait_one(lk, info, timeout_us, false);
+  if (ret != 0) {
+    return ret;
   }
 
-  if (socks_.find(info) != socks_.end() &&
-      socks_[info].state == tcp_st::ESTABLISHED) {
-    *cid = socks_[info].cid;
+  auto it = socks_.find(info);
+  if (it != socks_.end() && it->second.state == tcp_st::ESTABLISHED) {
+    *cid = it->second.cid;
     return 0;
   } else {
-    if (socks_.find(info) == socks_.end()) {
+    if (it == socks_.end()) {
       // socket is already removed
       log_libfpga(LIBFPGA_LOG_ERROR,
                   LIBPTU
@@ -273,7 +281,7 @@ int ptu_dev::connect(uint16_t lport, uint32_t raddr, uint16_t rport,
           LIBFPGA_LOG_ERROR,
           LIBPTU
           "(dev %u, ptu %u) %s: unexpected connection state cid=%u state=%d\n",
-          dev_id_, id_, __func__, socks_[info].cid, socks_[info].state);
+          dev_id_, id_, __func__, it->second.cid, it->second.state);
     }
     return -2;
   }
@@ -283,10 +291,7 @@ int ptu_dev::abort(uint32_t cid) {
   // unestablished cid
   {
     std::lock_guard<std::mutex> lk(mtx_socks_);
-    bool found_cid =
-        std::any_of(socks_.begin(), socks_.end(),
-                    [&](const auto &sock) { return sock.second.cid == cid; });
-    if (!found_cid) {
+    if (cid_socks_.find(cid) == cid_socks_.end()) {
       return -1;
     }
   }
@@ -296,125 +301,460 @@ int ptu_dev::abort(uint32_t cid) {
   return 0;
 }
 
-void ptu_dev::start_event() {
-  th_evt_ = std::thread([&] {
-    while (!stop_evt_) {
-      ptu_tcp_evt evt;
-      if (get_tcp_event(evt)) {
-        ptu_tcp_conn conn;
-        conn.cid = evt.cid;
-        conn.info.laddr = evt.laddr;
-        conn.info.lport = evt.lport;
-        conn.info.raddr = evt.raddr;
-        conn.info.rport = evt.rport;
-
-        if (evt.factor & TCP_EVE_ESTABLISHED) {
-          std::lock_guard<std::mutex> lk(mtx_socks_);
-          conn.state = tcp_st::ESTABLISHED;
-          socks_[conn.info] = conn;
-          cv_socks_.notify_all();
-        }
-        if (evt.factor & TCP_EVE_CLOSE_WAIT) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU
-                      "(dev %u, ptu %u) %s: tcp_event close wait cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-        }
-        if (evt.factor & TCP_EVE_DISCONNECT) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU
-                      "(dev %u, ptu %u) %s: tcp_event disconnect cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-          std::lock_guard<std::mutex> lk(mtx_socks_);
-          if (socks_.find(conn.info) != socks_.end()) {
-            socks_.erase(conn.info);
-            cv_socks_.notify_all();
-          }
-          tcp_release(evt.cid);
-        }
-        if (evt.factor & TCP_EVE_SYN_TIMEOUT) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU
-                      "(dev %u, ptu %u) %s: tcp_event syn timeout cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-          std::lock_guard<std::mutex> lk(mtx_socks_);
-          if (socks_.find(conn.info) != socks_.end()) {
-            socks_.erase(conn.info);
-            cv_socks_.notify_all();
-          }
-          tcp_release(evt.cid);
-        }
-        if (evt.factor & TCP_EVE_SYN_ACK_TIMEOUT) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU
-                      "(dev %u, ptu %u) %s: tcp_event syn ack timeout cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-          std::lock_guard<std::mutex> lk(mtx_socks_);
-          if (socks_.find(conn.info) != socks_.end()) {
-            socks_.erase(conn.info);
-            cv_socks_.notify_all();
-          }
-          tcp_release(evt.cid);
-        }
-        if (evt.factor & TCP_EVE_TIMEOUT) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU "(dev %u, ptu %u) %s: tcp_event timeout cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-          std::lock_guard<std::mutex> lk(mtx_socks_);
-          if (socks_.find(conn.info) != socks_.end()) {
-            socks_.erase(conn.info);
-            cv_socks_.notify_all();
-          }
-          tcp_release(evt.cid);
-        }
-        if (evt.factor & TCP_EVE_RECV_DATA) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU
-                      "(dev %u, ptu %u) %s: tcp_event recv data cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-        }
-        if (evt.factor & TCP_EVE_SEND_DATA) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU
-                      "(dev %u, ptu %u) %s: tcp_event send data cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-        }
-        if (evt.factor & TCP_EVE_RECV_URGENT_DATA) {
-          log_libfpga(
-              LIBFPGA_LOG_DEBUG,
-              LIBPTU "(dev %u, ptu %u) %s: tcp_event recv urgent data cid=%u\n",
-              dev_id_, id_, __func__, evt.cid);
-        }
-        if (evt.factor & TCP_EVE_RECV_RST) {
-          log_libfpga(LIBFPGA_LOG_DEBUG,
-                      LIBPTU "(dev %u, ptu %u) %s: tcp_event recv rst cid=%u\n",
-                      dev_id_, id_, __func__, evt.cid);
-          std::lock_guard<std::mutex> lk(mtx_socks_);
-          if (socks_.find(conn.info) != socks_.end()) {
-            socks_.erase(conn.info);
-            cv_socks_.notify_all();
+int ptu_dev::connect_batch(fpga_ptu_conn_req_t *reqs, uint32_t num,
+                           uint64_t timeout_us, const conn_cb &cb) {
+  std::vector<uint32_t> pending;
+  std::vector<uint32_t> failed;
+  std::vector<sock_info> infos;
+
+  {
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    for (uint32_t i = 0; i < num; i++) {
+      sock_info info;
+      info.laddr = ip_addr_;
+      info.lport = reqs[i].lport;
+      info.raddr = reqs[i].raddr;
+      info.rport = reqs[i].rport;
+      reqs[i].cid = 0;
+
+      if (socks_.find(info) != socks_.end()) {
+        // already connect requested
+        log_libfpga(LIBFPGA_LOG_ERROR,
+                    LIBPTU
+                    "(dev %u, ptu %u) %s: already connect requested "
+                    "laddr=0x%08x lport=%u raddr=0x%08x rport=%u\n",
+                    dev_id_, id_, __func__, info.laddr, info.lport,
+                    info.raddr, info.rport);
+        reqs[i].result = -3;
+        failed.push_back(i);
+        continue;
+      }
+
+      ptu_tcp_conn conn = {};
+      conn.cid = 0;
+      conn.state = tcp_st::SYN_SENT;
+      conn.info = info;
+      sock_insert_locked(conn);
+      reqs[i].result = FPGA_PTU_CONN_IN_PROGRESS;
+      pending.push_back(i);
+      infos.push_back(info);
+    }
+  }
+
+  if (cb) {
+    for (auto i : failed) {
+      cb(reqs[i]);
+    }
+  }
+
+  // issue all connect commands back to back
+  size_t issued = tcp_connect_batch(infos);
+  ptu_evt_loop::instance().kick();
+  if (issued < infos.size()) {
+    // the rest are failed by wait_batch() as removed sockets
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    for (size_t i = issued; i < infos.size(); i++) {
+      sock_erase_locked(infos[i]);
+    }
+  }
+
+  int ret = wait_batch(reqs, pending, timeout_us, false, cb);
+  return (failed.empty() || ret == -FAILURE_DEVICE_OPEN) ? ret : -1;
+}
+
+int ptu_dev::accept_batch(fpga_ptu_conn_req_t *reqs, uint32_t num,
+                          uint64_t timeout_us, const conn_cb &cb) {
+  std::vector<uint32_t> pending;
+  std::vector<uint32_t> failed;
+
+  {
+    std::lock_guard<std::mutex> lk_listen(mtx_listen_socks_);
+    for (uint32_t i = 0; i < num; i++) {
+      reqs[i].cid = 0;
+      if (listen_socks_.find(reqs[i].lport) == listen_socks_.end()) {
+        log_libfpga(LIBFPGA_LOG_ERROR,
+                    LIBPTU "(dev %u, ptu %u) %s: not listen port %u\n",
+                    dev_id_, id_, __func__, reqs[i].lport);
+        reqs[i].result = -3;
+        failed.push_back(i);
+      } else {
+        reqs[i].result = FPGA_PTU_CONN_IN_PROGRESS;
+        pending.push_back(i);
+      }
+    }
+  }
+
+  if (cb) {
+    for (auto i : failed) {
+      cb(reqs[i]);
+    }
+  }
+
+  ptu_evt_loop::instance().kick();
+
+  int ret = wait_batch(reqs, pending, timeout_us, true, cb);
+  return (failed.empty() || ret == -FAILURE_DEVICE_OPEN) ? ret : -1;
+}
+
+int ptu_dev::wait_one(std::unique_lock<std::mutex> &lk, const sock_info &info,
+                      uint64_t timeout_us, bool is_accept) {
+  // lk holds mtx_socks_
+  fpga_ptu_conn_req_t req = {};
+  conn_wait waiter;
+  waiter.reqs = &req;
+  waiter.is_accept = is_accept;
+  conn_waits_.insert({info, {&waiter, 0}});
+
+  auto pred = [&] {
+    if (exited_) {
+      return true;
+    }
+    auto it = socks_.find(info);
+    if (is_accept) {
+      return it != socks_.end() && it->second.state == tcp_st::ESTABLISHED;
+    }
+    return it == socks_.end() || it->second.state != tcp_st::SYN_SENT;
+  };
+  bool result;
+  if (timeout_us == 0) {
+    waiter.cv.wait(lk, pred);
+    result = true;
+  } else {
+    result = waiter.cv.wait_for(lk, std::chrono::microseconds(timeout_us), pred);
+  }
+  // not completed by the event handler when pred was true from the start
+  conn_wait_erase_locked(info, &waiter);
+
+  if (exited_) {
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: ptu exited\n", dev_id_, id_,
+                __func__);
+    return -FAILURE_DEVICE_OPEN;
+  }
+  if (!result) {
+    // timeout
+    log_libfpga(LIBFPGA_LOG_ERROR,
+                LIBPTU "(dev %u, ptu %u) %s: timeout %llu us\n", dev_id_, id_,
+                __func__, timeout_us);
+    return -1;
+  }
+  return 0;
+}
+
+bool ptu_dev::wait_port(std::unique_lock<std::mutex> &lk, uint16_t lport,
+                        uint64_t timeout_us) {
+  // lk holds mtx_socks_, returns false on timeout
+  std::condition_variable cv;
+  auto wait_it = port_waits_.insert({lport, &cv});
+
+  auto pred = [&] {
+    auto it = port_socks_.find(lport);
+    return exited_ || (it != port_socks_.end() && it->second > 0);
+  };
+  bool result;
+  if (timeout_us == 0) {
+    cv.wait(lk, pred);
+    result = true;
+  } else {
+    result = cv.wait_for(lk, std::chrono::microseconds(timeout_us), pred);
+  }
+  port_waits_.erase(wait_it);
+  return result;
+}
+
+int ptu_dev::wait_batch(fpga_ptu_conn_req_t *reqs,
+                        std::vector<uint32_t> &pending, uint64_t timeout_us,
+                        bool is_accept, const conn_cb &cb) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::microseconds(timeout_us);
+  conn_wait waiter;
+  waiter.reqs = reqs;
+  waiter.is_accept = is_accept;
+  std::vector<uint32_t> done;
+  size_t remain = pending.size();  // num of requests not reported yet
+  bool exited = false;
+  int ret = 0;
+
+  auto req_info = [&](const fpga_ptu_conn_req_t &req) {
+    sock_info info;
+    info.laddr = ip_addr_;
+    info.lport = req.lport;
+    info.raddr = req.raddr;
+    info.rport = req.rport;
+    return info;
+  };
+
+  std::unique_lock<std::mutex> lk(mtx_socks_);
+  // complete requests already done, the event handler completes the others
+  for (auto i : pending) {
+    fpga_ptu_conn_req_t &req = reqs[i];
+    sock_info info = req_info(req);
+    auto it = socks_.find(info);
+    if (it != socks_.end() && it->second.state == tcp_st::ESTABLISHED) {
+      req.cid = it->second.cid;
+      req.result = 0;
+      waiter.done.push_back(i);
+    } else if (!is_accept && it == socks_.end()) {
+      // SYN timeout, RST or so removed the socket
+      req.result = -2;
+      waiter.done.push_back(i);
+    } else {
+      conn_waits_.insert({info, {&waiter, i}});
+    }
+  }
+  pending.clear();
+
+  while (remain > 0) {
+    if (waiter.done.empty()) {
+      auto pred = [&] { return !waiter.done.empty() || exited_; };
+      int result = 0;
+      if (timeout_us == 0) {
+        waiter.cv.wait(lk, pred);
+      } else if (!waiter.cv.wait_until(lk, deadline, pred)) {
+        log_libfpga(LIBFPGA_LOG_ERROR,
+                    LIBPTU "(dev %u, ptu %u) %s: timeout %llu us, %zu remain\n",
+                    dev_id_, id_, __func__, timeout_us, remain);
+        result = -1;
+      }
+      if (result == 0 && waiter.done.empty()) {
+        log_libfpga(LIBFPGA_LOG_ERROR,
+                    LIBPTU "(dev %u, ptu %u) %s: ptu exited, %zu remain\n",
+                    dev_id_, id_, __func__, remain);
+        result = -FAILURE_DEVICE_OPEN;
+        exited = true;
+      }
+      if (result != 0) {
+        for (auto it = conn_waits_.begin(); it != conn_waits_.end();) {
+          if (it->second.first == &waiter) {
+            reqs[it->second.second].result = result;
+            waiter.done.push_back(it->second.second);
+            it = conn_waits_.erase(it);
+          } else {
+            ++it;
           }
-          tcp_release(evt.cid);
         }
-        if (evt.factor & TCP_EVE_INVLD_CONNECTION) {
-          log_libfpga(
-              LIBFPGA_LOG_DEBUG,
-              LIBPTU
-              "(dev %u, ptu %u) %s: tcp_event invalid connection cid=%u\n",
-              dev_id_, id_, __func__, evt.cid);
-        }
-      } else {
-        // poll with POLL_EVT_MS only when there are no TCP events
-        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_EVT_MS));
       }
     }
-  });
+
+    done.swap(waiter.done);
+    remain -= done.size();
+    for (auto i : done) {
+      if (reqs[i].result != 0) {
+        ret = -1;
+      }
+    }
+    if (cb) {
+      // do not hold mtx_socks_ in user callbacks
+      lk.unlock();
+      for (auto i : done) {
+        cb(reqs[i]);
+      }
+      lk.lock();
+    }
+    done.clear();
+  }
+
+  return exited ? -FAILURE_DEVICE_OPEN : ret;
+}
+
+void ptu_dev::set_exited() {
+  // under mtx_socks_ so that no waiter misses the notification
+  std::lock_guard<std::mutex> lk(mtx_socks_);
+  exited_ = true;
+  for (auto &wait : conn_waits_) {
+    wait.second.first->cv.notify_all();
+  }
+  for (auto &wait : port_waits_) {
+    wait.second->notify_all();
+  }
+}
+
+void ptu_dev::start_event() {
+  ptu_evt_loop::instance().add(this);
 }
 
 void ptu_dev::stop_event() {
-  stop_evt_ = true;
-  if (th_evt_.joinable()) {
-    th_evt_.join();
+  ptu_evt_loop::instance().remove(this);
+}
+
+int ptu_dev::handle_tcp_events() {
+  // drain pending events, bounded so that other devices are not starved
+  int num = 0;
+  ptu_tcp_evt evt;
+  while (num < DRAIN_EVT_MAX && get_tcp_event(evt)) {
+    handle_tcp_event(evt);
+    num++;
+  }
+  if (num > 0) {
+    // PTU consumes commands as it raises events, see tcp_connect_batch()
+    std::lock_guard<std::mutex> lk(mtx_evt_);
+    evt_gen_++;
+    cv_evt_.notify_all();
+  }
+  return num;
+}
+
+void ptu_dev::handle_tcp_event(const ptu_tcp_evt &evt) {
+  ptu_tcp_conn conn;
+  conn.cid = evt.cid;
+  conn.info.laddr = evt.laddr;
+  conn.info.lport = evt.lport;
+  conn.info.raddr = evt.raddr;
+  conn.info.rport = evt.rport;
+
+  if (evt.factor & TCP_EVE_ESTABLISHED) {
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    conn.state = tcp_st::ESTABLISHED;
+    sock_insert_locked(conn);
+  }
+  if (evt.factor & TCP_EVE_CLOSE_WAIT) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU
+                "(dev %u, ptu %u) %s: tcp_event close wait cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+  }
+  if (evt.factor & TCP_EVE_DISCONNECT) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU
+                "(dev %u, ptu %u) %s: tcp_event disconnect cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    sock_erase_locked(conn.info);
+    tcp_release(evt.cid);
+  }
+  if (evt.factor & TCP_EVE_SYN_TIMEOUT) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU
+                "(dev %u, ptu %u) %s: tcp_event syn timeout cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    sock_erase_locked(conn.info);
+    tcp_release(evt.cid);
+  }
+  if (evt.factor & TCP_EVE_SYN_ACK_TIMEOUT) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU
+                "(dev %u, ptu %u) %s: tcp_event syn ack timeout cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    sock_erase_locked(conn.info);
+    tcp_release(evt.cid);
+  }
+  if (evt.factor & TCP_EVE_TIMEOUT) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU "(dev %u, ptu %u) %s: tcp_event timeout cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    sock_erase_locked(conn.info);
+    tcp_release(evt.cid);
+  }
+  if (evt.factor & TCP_EVE_RECV_DATA) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU
+                "(dev %u, ptu %u) %s: tcp_event recv data cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+  }
+  if (evt.factor & TCP_EVE_SEND_DATA) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU
+                "(dev %u, ptu %u) %s: tcp_event send data cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+  }
+  if (evt.factor & TCP_EVE_RECV_URGENT_DATA) {
+    log_libfpga(
+        LIBFPGA_LOG_DEBUG,
+        LIBPTU "(dev %u, ptu %u) %s: tcp_event recv urgent data cid=%u\n",
+        dev_id_, id_, __func__, evt.cid);
+  }
+  if (evt.factor & TCP_EVE_RECV_RST) {
+    log_libfpga(LIBFPGA_LOG_DEBUG,
+                LIBPTU "(dev %u, ptu %u) %s: tcp_event recv rst cid=%u\n",
+                dev_id_, id_, __func__, evt.cid);
+    std::lock_guard<std::mutex> lk(mtx_socks_);
+    sock_erase_locked(conn.info);
+    tcp_release(evt.cid);
+  }
+  if (evt.factor & TCP_EVE_INVLD_CONNECTION) {
+    log_libfpga(
+        LIBFPGA_LOG_DEBUG,
+        LIBPTU
+        "(dev %u, ptu %u) %s: tcp_event invalid connection cid=%u\n",
+        dev_id_, id_, __func__, evt.cid);
+  }
+}
+
+void ptu_dev::sock_insert_locked(const ptu_tcp_conn &conn) {
+  auto result = socks_.insert({conn.info, conn});
+  if (!result.second) {
+    if (result.first->second.cid != conn.cid) {
+      cid_socks_.erase(result.first->second.cid);
+    }
+    result.first->second = conn;
+  } else {
+    // wake fpga_ptu_accept() waiting for any socket on the port
+    port_socks_[conn.info.lport]++;
+    auto range = port_waits_.equal_range(conn.info.lport);
+    for (auto it = range.first; it != range.second; ++it) {
+      it->second->notify_one();
+    }
+  }
+  if (conn.cid != 0) {
+    cid_socks_[conn.cid] = conn.info;
+  }
+  if (conn.state == tcp_st::ESTABLISHED) {
+    conn_complete_locked(conn.info, &conn);
+  }
+}
+
+void ptu_dev::sock_erase_locked(const sock_info &info) {
+  auto it = socks_.find(info);
+  if (it == socks_.end()) {
+    return;
+  }
+  auto cid_it = cid_socks_.find(it->second.cid);
+  if (cid_it != cid_socks_.end() && cid_it->second == info) {
+    cid_socks_.erase(cid_it);
+  }
+  socks_.erase(it);
+  auto port_it = port_socks_.find(info.lport);
+  if (port_it != port_socks_.end() && --port_it->second == 0) {
+    port_socks_.erase(port_it);
+  }
+  conn_complete_locked(info, nullptr);
+}
+
+void ptu_dev::conn_complete_locked(const sock_info &info,
+                                   const ptu_tcp_conn *conn) {
+  // post the requests of the 4-tuple to their waiters, conn is null on removal
+  auto range = conn_waits_.equal_range(info);
+  for (auto it = range.first; it != range.second;) {
+    conn_wait *waiter = it->second.first;
+    fpga_ptu_conn_req_t &req = waiter->reqs[it->second.second];
+    if (conn) {
+      req.cid = conn->cid;
+      req.result = 0;
+    } else if (!waiter->is_accept) {
+      // SYN timeout, RST or so removed the socket
+      req.result = -2;
+    } else {
+      // accept waits for the next connection of the 4-tuple
+      ++it;
+      continue;
+    }
+    waiter->done.push_back(it->second.second);
+    waiter->cv.notify_one();
+    it = conn_waits_.erase(it);
+  }
+}
+
+void ptu_dev::conn_wait_erase_locked(const sock_info &info,
+                                     conn_wait *waiter) {
+  auto range = conn_waits_.equal_range(info);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.first == waiter) {
+      conn_waits_.erase(it);
+      return;
+    }
   }
 }
 
@@ -423,46 +763,359 @@ void ptu_dev::reg_write(uint32_t reg_idx, uint32_t value) {
   reg_write_priv(reg_idx, value);
 }
 
+void ptu_dev::reg_write_seq(
+    std::initializer_list<std::pair<uint32_t, uint32_t>> regs) {
+  std::lock_guard<std::mutex> lk(mtx_dev_);
+  reg_write_seq_priv(regs);
+}
+
 uint32_t ptu_dev::reg_read(uint32_t reg_idx) {
   std::lock_guard<std::mutex> lk(mtx_dev_);
   return reg_read_priv(reg_idx);
 }
 
+int ptu_dev::reg_read_block(uint32_t reg_idx, uint32_t num, uint32_t* values) {
+  // Contiguous registers are read by one access, i.e. at the same instant
+  std::lock_guard<std::mutex> lk(mtx_dev_);
+  return fpga_stat_read_block(dev_id_, base_ + reg_idx * 4, num, values);
+}
+
+// ops per cid: select, dump, USR_READ, USR_WRT, SND_UNA, SND_NXT, RCV_NXT,
+// RCV_UP, SND_WND
+constexpr uint32_t TCB_OPS_PER_CID = 9;
+
+// set the select-dump-and-read sequence of a cid into op[]
+static void tcb_dump_ops(fpga_ioctl_reg_op_t *op, uint32_t cid) {
+  op[0] = {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::TCP_CID, cid, 0, 0};
+  op[1] = {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_DUMP_TCB, 0, 0};
+  op[2] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_USR_READ, 0, 0, 0};
+  op[3] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_USR_WRT, 0, 0, 0};
+  op[4] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_SND_UNA, 0, 0, 0};
+  op[5] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_SND_NXT, 0, 0, 0};
+  op[6] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_RCV_NXT, 0, 0, 0};
+  op[7] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_RCV_UP, 0, 0, 0};
+  op[8] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_SND_WND, 0, 0, 0};
+}
+
+// parse the values read by the sequence of tcb_dump_ops()
+static void tcb_dump_parse(const fpga_ioctl_reg_op_t *op, fpga_dump_tcb_t *tcb) {
+  tcb->tcb_usr_read = op[2].value;
+  tcb->tcb_usr_wrt  = op[3].value;
+  tcb->tcb_snd_una  = op[4].value;
+  tcb->tcb_snd_nxt  = op[5].value;
+  tcb->tcb_rcv_nxt  = op[6].value;
+  tcb->tcb_rcv_up   = op[7].value;
+  tcb->tcb_snd_wnd  = op[8].value;
+}
+
+int ptu_dev::dump_tcb(uint32_t cid, fpga_dump_tcb_t *tcb) {
+  // select cid, dump and read TCB by one system call,
+  // so that other threads do not change TCP_CID in between
+  fpga_ioctl_reg_op_t ops[TCB_OPS_PER_CID];
+  tcb_dump_ops(ops, cid);
+  {
+    std::lock_guard<std::mutex> lk(mtx_dev_);
+    if (ptu_reg_rw_vec(fd_, base_, ops, TCB_OPS_PER_CID) != 0) {
+      return -1;
+    }
+  }
+  tcb_dump_parse(ops, tcb);
+  return 0;
+}
+
+int ptu_dev::dump_tcbs(const uint32_t *cids, uint32_t num,
+                       fpga_dump_tcb_t *tcbs, uint8_t *valid,
+                       std::chrono::steady_clock::time_point *times) {
+  constexpr uint32_t cids_per_call = XPCIE_DEV_REG_VEC_MAX / TCB_OPS_PER_CID;
+  fpga_ioctl_reg_op_t ops[cids_per_call * TCB_OPS_PER_CID];
+
+  int ret = 0;
+  for (uint32_t head = 0; head < num; head += cids_per_call) {
+    uint32_t n = std::min(cids_per_call, num - head);
+    for (uint32_t i = 0; i < n; i++) {
+      tcb_dump_ops(&ops[i * TCB_OPS_PER_CID], cids[head + i]);
+    }
+    int err;
+    {
+      std::lock_guard<std::mutex> lk(mtx_dev_);
+      err = ptu_reg_rw_vec(fd_, base_, ops, n * TCB_OPS_PER_CID);
+    }
+    auto now = std::chrono::steady_clock::now();
+    // a failed call invalidates only its own cids, go on with the rest
+    for (uint32_t i = 0; i < n; i++) {
+      valid[head + i] = err == 0;
+      if (err == 0) {
+        tcb_dump_parse(&ops[i * TCB_OPS_PER_CID], &tcbs[head + i]);
+      }
+      if (times) {
+        times[head + i] = now;
+      }
+    }
+    if (err != 0) {
+      ret = -1;
+    }
+  }
+  return ret;
+}
+
+int ptu_dev::check_tcb_drained(const uint32_t *cids, uint32_t num,
+                               uint8_t *drained) {
+  // ops per cid: select, dump, USR_WRT, SND_UNA
+  constexpr uint32_t ops_per_cid = 4;
+  constexpr uint32_t cids_per_call = XPCIE_DEV_REG_VEC_MAX / ops_per_cid;
+  fpga_ioctl_reg_op_t ops[cids_per_call * ops_per_cid];
+  uint32_t index[cids_per_call];
+
+  uint32_t head = 0;
+  while (head < num) {
+    // dump only cids not drained yet
+    uint32_t n = 0;
+    for (; head < num && n < cids_per_call; head++) {
+      if (drained[head]) {
+        continue;
+      }
+      fpga_ioctl_reg_op_t *op = &ops[n * ops_per_cid];
+      op[0] = {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::TCP_CID, cids[head], 0, 0};
+      op[1] = {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_DUMP_TCB, 0, 0};
+      op[2] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_USR_WRT, 0, 0, 0};
+      op[3] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCB_SND_UNA, 0, 0, 0};
+      index[n++] = head;
+    }
+    if (n == 0) {
+      break;
+    }
+    {
+      std::lock_guard<std::mutex> lk(mtx_dev_);
+      if (ptu_reg_rw_vec(fd_, base_, ops, n * ops_per_cid) != 0) {
+        return -1;
+      }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      const fpga_ioctl_reg_op_t *op = &ops[i * ops_per_cid];
+      // same condition as fpga_ptu_wait_tcb_buffer_empty()
+      drained[index[i]] = op[2].value == op[3].value;
+    }
+  }
+  return 0;
+}
+
+std::vector<std::pair<uint16_t, sock_info>> ptu_dev::established_cids() {
+  std::vector<std::pair<uint16_t, sock_info>> cids;
+  std::lock_guard<std::mutex> lk(mtx_socks_);
+  cids.reserve(cid_socks_.size());
+  for (const auto &cid_sock : cid_socks_) {
+    auto it = socks_.find(cid_sock.second);
+    if (it != socks_.end() && it->second.state == tcp_st::ESTABLISHED) {
+      cids.push_back(cid_sock);
+    }
+  }
+  return cids;
+}
+
+// ops per entry: select, dump, PTU_VERSION(as the original dump sequence),
+// ENTRY, IPV4, MAC_HI, MAC_LO
+constexpr uint32_t ARP_OPS_PER_ENTRY = 7;
+
+// set the select-and-read sequence of an ARP table index into op[]
+static void arp_entry_ops(fpga_ioctl_reg_op_t *op, uint32_t index) {
+  op[0] = {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::ARP_ARG0, index, 0, 0};
+  op[1] = {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::ARP_COMMAND, ARP_DUMP_ENTRY, 0, 0};
+  op[2] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::PTU_VERSION, 0, 0, 0};
+  op[3] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::ARP_ENTRY, 0, 0, 0};
+  op[4] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::ARP_IPV4, 0, 0, 0};
+  op[5] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::ARP_MAC_HI, 0, 0, 0};
+  op[6] = {XPCIE_DEV_REG_OP_READ32, PtuRegMap::ARP_MAC_LO, 0, 0, 0};
+}
+
+// parse the values read by arp_entry_ops()
+static void arp_entry_parse(const fpga_ioctl_reg_op_t *op,
+                            fpga_arp_entry_t *entry) {
+  uint32_t data = op[3].value;
+  *entry = {};
+  entry->dump_permanent = static_cast<uint8_t>((data  & 0x80000000) >> 31);
+  entry->dump_incmp     = static_cast<uint8_t>((data  & 0x40000000) >> 30);
+  entry->dump_used      = static_cast<uint8_t>((data  & 0x20000000) >> 29);
+  entry->dump_life      = static_cast<uint16_t>((data & 0x01FF0000) >> 16);
+  entry->dump_retry     = static_cast<uint8_t>((data  & 0x00000F00) >> 8);
+  entry->dump_arp_index = static_cast<uint8_t>(data   & 0x000000FF);
+  entry->dump_ipddr     = op[4].value;
+  entry->dump_mac       = static_cast<uint64_t>(op[5].value) << 32 |
+                          static_cast<uint64_t>(op[6].value);
+}
+
+int ptu_dev::get_arp_entry(uint8_t index, fpga_arp_entry_t *entry) {
+  // select and read by one system call,
+  // so that other threads do not change ARP_ARG0 in between
+  fpga_ioctl_reg_op_t ops[ARP_OPS_PER_ENTRY];
+  arp_entry_ops(ops, index);
+  {
+    std::lock_guard<std::mutex> lk(mtx_dev_);
+    if (ptu_reg_rw_vec(fd_, base_, ops, ARP_OPS_PER_ENTRY) != 0) {
+      return -1;
+    }
+  }
+  arp_entry_parse(ops, entry);
+  return 0;
+}
+
+int ptu_dev::dump_arp_table(std::vector<fpga_arp_entry_t> &entries) {
+  constexpr uint32_t entries_per_call = XPCIE_DEV_REG_VEC_MAX / ARP_OPS_PER_ENTRY;
+  fpga_ioctl_reg_op_t ops[entries_per_call * ARP_OPS_PER_ENTRY];
+
+  entries.clear();
+  for (uint32_t head = 0; head < ARP_ENTRY_NUM; head += entries_per_call) {
+    uint32_t num = std::min(entries_per_call, ARP_ENTRY_NUM - head);
+    for (uint32_t i = 0; i < num; i++) {
+      arp_entry_ops(&ops[i * ARP_OPS_PER_ENTRY], head + i);
+    }
+    {
+      std::lock_guard<std::mutex> lk(mtx_dev_);
+      if (ptu_reg_rw_vec(fd_, base_, ops, num * ARP_OPS_PER_ENTRY) != 0) {
+        return -1;
+      }
+    }
+    for (uint32_t i = 0; i < num; i++) {
+      fpga_arp_entry_t entry;
+      arp_entry_parse(&ops[i * ARP_OPS_PER_ENTRY], &entry);
+      if (entry.dump_used || entry.dump_permanent) {
+        entries.push_back(entry);
+      }
+    }
+  }
+  return 0;
+}
+
+int ptu_dev::dump_arp_table_cached(uint64_t max_age_us,
+                                   std::vector<fpga_arp_entry_t> &entries,
+                                   bool *refreshed) {
+  std::lock_guard<std::mutex> lk(mtx_arp_cache_);
+
+  // evicted/conflicted are write-1-clear, consume them to detect next change
+  constexpr uint32_t arp_status_changed = 0x80000000 | 0x20000000;
+  uint32_t status = reg_read(PtuRegMap::ARP_STATUS);
+  bool changed = (status & arp_status_changed) != 0;
+  if (changed) {
+    reg_write(PtuRegMap::ARP_STATUS, status & arp_status_changed);
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  bool expired = max_age_us != 0 &&
+                 now - arp_cache_time_ >= std::chrono::microseconds(max_age_us);
+  *refreshed = !arp_cache_valid_ || changed || expired;
+  if (*refreshed) {
+    if (dump_arp_table(arp_cache_) != 0) {
+      arp_cache_valid_ = false;
+      return -1;
+    }
+    arp_cache_time_ = now;
+    arp_cache_valid_ = true;
+  }
+  entries = arp_cache_;
+  return 0;
+}
+
+void ptu_dev::arp_invalidate() {
+  std::lock_guard<std::mutex> lk(mtx_arp_cache_);
+  arp_cache_valid_ = false;
+}
+
 void ptu_dev::tcp_listen(uint16_t lport) {
   std::lock_guard<std::mutex> lk(mtx_dev_);
 
-  reg_write_priv(PtuRegMap::TCP_LOCAL_PORT, lport << 16);
-  reg_write_priv(PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_LSN_OPEN);
+  reg_write_seq_priv({{PtuRegMap::TCP_LOCAL_PORT, lport << 16},
+                      {PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_LSN_OPEN}});
 }
 
 void ptu_dev::tcp_listen_close(uint16_t lport) {
   std::lock_guard<std::mutex> lk(mtx_dev_);
 
-  reg_write_priv(PtuRegMap::TCP_LOCAL_PORT, lport << 16);
-  reg_write_priv(PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_LSN_CLOSE);
+  reg_write_seq_priv({{PtuRegMap::TCP_LOCAL_PORT, lport << 16},
+                      {PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_LSN_CLOSE}});
 }
 
 void ptu_dev::tcp_connect(uint16_t lport, uint32_t raddr, uint16_t rport) {
   std::lock_guard<std::mutex> lk(mtx_dev_);
 
-  reg_write_priv(PtuRegMap::TCP_REMOTE_IP, raddr);
-  reg_write_priv(PtuRegMap::TCP_REMOTE_PORT, rport);
-  reg_write_priv(PtuRegMap::TCP_LOCAL_PORT, lport);
-  reg_write_priv(PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_CNN_OPEN);
+  reg_write_seq_priv({{PtuRegMap::TCP_REMOTE_IP, raddr},
+                      {PtuRegMap::TCP_REMOTE_PORT, rport},
+                      {PtuRegMap::TCP_LOCAL_PORT, lport},
+                      {PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_CNN_OPEN}});
+}
+
+size_t ptu_dev::tcp_connect_batch(const std::vector<sock_info> &infos) {
+  fpga_ioctl_reg_op_t ops[CONNECT_BATCH_MAX * CONNECT_REG_NUM];
+  size_t index = 0;
+  auto wait_start = std::chrono::steady_clock::now();
+  while (index < infos.size() && !exited_) {
+    uint64_t gen;
+    {
+      std::lock_guard<std::mutex> lk(mtx_evt_);
+      gen = evt_gen_;
+    }
+
+    // do not issue more commands than PTU can accept,
+    // hold mtx_dev_ only per chunk not to block the event loop
+    uint32_t batch;
+    {
+      std::lock_guard<std::mutex> lk(mtx_dev_);
+      uint32_t avail = reg_read_priv(PtuRegMap::TCP_CMD_CNT) & 0xff;
+      batch = std::min<size_t>({avail, CONNECT_BATCH_MAX, infos.size() - index});
+      uint32_t num = 0;
+      for (uint32_t i = 0; i < batch; i++) {
+        const sock_info &info = infos[index + i];
+        uint32_t values[CONNECT_REG_NUM][2] = {
+            {PtuRegMap::TCP_REMOTE_IP, info.raddr},
+            {PtuRegMap::TCP_REMOTE_PORT, info.rport},
+            {PtuRegMap::TCP_LOCAL_PORT, info.lport},
+            {PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_CNN_OPEN}};
+        for (auto &value : values) {
+          ops[num].op = XPCIE_DEV_REG_OP_WRITE32;
+          ops[num].offset = value[0];
+          ops[num].value = value[1];
+          ops[num].mask = 0;
+          ops[num].poll_us = 0;
+          num++;
+        }
+      }
+      if (batch > 0 && ptu_reg_rw_vec(fd_, base_, ops, num) != 0) {
+        log_libfpga(LIBFPGA_LOG_ERROR,
+                    LIBPTU "(dev %u, ptu %u) %s: failed to issue %zu commands\n",
+                    dev_id_, id_, __func__, infos.size() - index);
+        return index;
+      }
+    }
+    if (batch > 0) {
+      index += batch;
+      wait_start = std::chrono::steady_clock::now();
+      continue;
+    }
+
+    // no command is issueable, wait for the event loop to handle events
+    if (std::chrono::steady_clock::now() - wait_start >= CMD_AVAIL_WAIT) {
+      log_libfpga(LIBFPGA_LOG_ERROR,
+                  LIBPTU "(dev %u, ptu %u) %s: no issueable command, %zu not issued\n",
+                  dev_id_, id_, __func__, infos.size() - index);
+      return index;
+    }
+    ptu_evt_loop::instance().kick();
+    std::unique_lock<std::mutex> lk(mtx_evt_);
+    cv_evt_.wait_for(lk, CMD_AVAIL_POLL, [&] { return evt_gen_ != gen; });
+  }
+  return index;
 }
 
 void ptu_dev::tcp_abort(uint16_t cid) {
   std::lock_guard<std::mutex> lk(mtx_dev_);
 
-  reg_write_priv(PtuRegMap::TCP_CID, cid);
-  reg_write_priv(PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_ABORT);
+  reg_write_seq_priv({{PtuRegMap::TCP_CID, cid},
+                      {PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_ABORT}});
 }
 
 void ptu_dev::tcp_release(uint16_t cid) {
   std::lock_guard<std::mutex> lk(mtx_dev_);
 
-  reg_write_priv(PtuRegMap::TCP_CID, cid);
-  reg_write_priv(PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_RELEASE);
+  reg_write_seq_priv({{PtuRegMap::TCP_CID, cid},
+                      {PtuRegMap::TCP_COMMAND, TCP_HOST_CMD_RELEASE}});
 }
 
 bool ptu_dev::get_tcp_event(ptu_tcp_evt &evt) {
@@ -480,14 +1133,25 @@ bool ptu_dev::get_tcp_event(ptu_tcp_evt &evt) {
   }
 
   if (factor != 0) {
-    uint32_t evt_raddr = reg_read_priv(PtuRegMap::TCP_EVENT_REMOTE_IP);
-    uint32_t evt_laddr = reg_read_priv(PtuRegMap::TCP_EVENT_LOCAL_IP);
-    uint32_t evt_port = reg_read_priv(PtuRegMap::TCP_EVENT_PORT);
+    // read event information and dequeue the event by one system call
+    fpga_ioctl_reg_op_t ops[] = {
+        {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCP_EVENT_REMOTE_IP, 0, 0, 0},
+        {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCP_EVENT_LOCAL_IP, 0, 0, 0},
+        {XPCIE_DEV_REG_OP_READ32, PtuRegMap::TCP_EVENT_PORT, 0, 0, 0},
+        {XPCIE_DEV_REG_OP_WRITE32, PtuRegMap::TCP_EVENT_QUE, 0, 0, 0}};
+    if (ptu_reg_rw_vec(fd_, base_, ops, sizeof(ops) / sizeof(ops[0])) != 0) {
+      // the values are stale, retry the event in the next pass
+      log_libfpga(LIBFPGA_LOG_ERROR,
+                  LIBPTU "(dev %u, ptu %u) %s: cannot read TCP event cid=%u\n",
+                  dev_id_, id_, __func__, cid);
+      return false;
+    }
+    uint32_t evt_raddr = ops[0].value;
+    uint32_t evt_laddr = ops[1].value;
+    uint32_t evt_port = ops[2].value;
     uint16_t evt_rport = evt_port & 0xffff;
     uint16_t evt_lport = evt_port >> 16;
 
-    reg_write_priv(PtuRegMap::TCP_EVENT_QUE, 0);
-
     evt.cid = cid;
     evt.factor = factor;
     evt.laddr = evt_laddr;
@@ -515,3 +1179,20 @@ void ptu_dev::reg_write_priv(uint32_t reg_idx, uint32_t value) {
 uint32_t ptu_dev::reg_read_priv(uint32_t reg_idx) {
   return ptu_reg_read(fd_, base_, reg_idx);
 }
+
+void ptu_dev::reg_write_seq_priv(
+    std::initializer_list<std::pair<uint32_t, uint32_t>> regs) {
+  fpga_ioctl_reg_op_t ops[8];
+  uint32_t num = 0;
+  for (auto &reg : regs) {
+    ops[num].op = XPCIE_DEV_REG_OP_WRITE32;
+    ops[num].offset = reg.first;
+    ops[num].value = reg.second;
+    ops[num].mask = 0;
+    ops[num].poll_us = 0;
+    if (++num == sizeof(ops) / sizeof(ops[0])) {
+      break;
+    }
+  }
+  ptu_reg_rw_vec(fd_, base_, ops, num);
+}
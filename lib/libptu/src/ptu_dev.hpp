@@ -14,13 +14,18 @@
 #include <sys/time.h>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
 #include <mutex>
-#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <libptu.h>
 
 // key of socket table
 struct sock_info {
@@ -32,8 +37,11 @@ struct sock_info {
 
 struct sock_info_hash {
   std::size_t operator()(sock_info info) const {
-    int val = info.laddr + info.lport + info.raddr + info.rport;
-    return std::hash<int>()(val);
+    // mix all fields not to collide connections differing only in ports
+    uint64_t val = (static_cast<uint64_t>(info.raddr) << 32) |
+                   (static_cast<uint64_t>(info.lport) << 16) | info.rport;
+    val ^= static_cast<uint64_t>(info.laddr) * 0x9e3779b97f4a7c15ULL;
+    return std::hash<uint64_t>()(val);
   }
 };
 
@@ -53,16 +61,48 @@ class ptu_dev {
            const uint8_t *mac);
   int listen(uint16_t lport);
   int listen_close(uint16_t lport);
+  void listen_close_all();
+  // exact: wait only for the 4-tuple instead of any connection on lport
   int accept(uint16_t lport, uint32_t raddr, uint16_t rport,
-             uint64_t timeout_us, uint32_t* cid);
+             uint64_t timeout_us, uint32_t* cid, bool exact);
   int connect(uint16_t lport, uint32_t raddr, uint16_t rport,
               uint64_t timeout_us, uint32_t* cid);
   int abort(uint32_t cid);
+  // callback called in the caller's thread for each completed request
+  using conn_cb = std::function<void(const fpga_ptu_conn_req_t&)>;
+  int connect_batch(fpga_ptu_conn_req_t* reqs, uint32_t num,
+                    uint64_t timeout_us, const conn_cb& cb);
+  int accept_batch(fpga_ptu_conn_req_t* reqs, uint32_t num,
+                   uint64_t timeout_us, const conn_cb& cb);
   void start_event();
   void stop_event();
+  // called by ptu_evt_loop, returns the num of handled events
+  int handle_tcp_events();
 
   void reg_write(uint32_t reg_idx, uint32_t value);
   uint32_t reg_read(uint32_t reg_idx);
+  void reg_write_seq(std::initializer_list<std::pair<uint32_t, uint32_t>> regs);
+  int reg_read_block(uint32_t reg_idx, uint32_t num, uint32_t* values);
+  int dump_tcb(uint32_t cid, fpga_dump_tcb_t* tcb);
+  // dump TCBs of many cids by as few system calls as possible,
+  // valid[i] is 0 when tcbs[i] could not be dumped, times[i](nullable) is
+  // when tcbs[i] was dumped
+  int dump_tcbs(const uint32_t* cids, uint32_t num, fpga_dump_tcb_t* tcbs,
+                uint8_t* valid,
+                std::chrono::steady_clock::time_point* times);
+  int check_tcb_drained(const uint32_t* cids, uint32_t num, uint8_t* drained);
+  // established connections as (cid, 4-tuple)
+  std::vector<std::pair<uint16_t, sock_info>> established_cids();
+  int get_arp_entry(uint8_t index, fpga_arp_entry_t* entry);
+  int dump_arp_table(std::vector<fpga_arp_entry_t>& entries);
+  int dump_arp_table_cached(uint64_t max_age_us,
+                            std::vector<fpga_arp_entry_t>& entries,
+                            bool* refreshed);
+  void arp_invalidate();
+  // set by fpga_ptu_exit(), the instance may still be held by handles,
+  // waiting threads return -FAILURE_DEVICE_OPEN
+  void set_exited();
+  bool exited() const { return exited_; }
 
  private:
   enum class tcp_st { SYN_SENT, ESTABLISHED };
@@ -82,13 +122,35 @@ class ptu_dev {
     sock_info info;
   };
 
+  // a thread waiting for sockets, completed by the TCP event handler
+  struct conn_wait {
+    std::condition_variable cv;  // notified when `done` grows
+    fpga_ptu_conn_req_t* reqs;   // requests waited for
+    bool is_accept;              // removal of a socket is not a failure
+    std::vector<uint32_t> done;  // indexes of reqs completed, not reported yet
+  };
+
   void tcp_listen(uint16_t lport);
   void tcp_listen_close(uint16_t lport);
   void tcp_connect(uint16_t lport, uint32_t raddr, uint16_t rport);
+  size_t tcp_connect_batch(const std::vector<sock_info>& infos);
   void tcp_abort(uint16_t cid);
   void tcp_release(uint16_t cid);
   bool get_tcp_event(ptu_tcp_evt& evt);
+  void handle_tcp_event(const ptu_tcp_evt& evt);
+  void sock_insert_locked(const ptu_tcp_conn& conn);
+  void sock_erase_locked(const sock_info& info);
+  void conn_complete_locked(const sock_info& info, const ptu_tcp_conn* conn);
+  void conn_wait_erase_locked(const sock_info& info, conn_wait* waiter);
+  int wait_one(std::unique_lock<std::mutex>& lk, const sock_info& info,
+               uint64_t timeout_us, bool is_accept);
+  bool wait_port(std::unique_lock<std::mutex>& lk, uint16_t lport,
+                 uint64_t timeout_us);
+  int wait_batch(fpga_ptu_conn_req_t* reqs, std::vector<uint32_t>& pending,
+                 uint64_t timeout_us, bool is_accept, const conn_cb& cb);
   void reg_write_priv(uint32_t reg_idx, uint32_t value);
+  void reg_write_seq_priv(
+      std::initializer_list<std::pair<uint32_t, uint32_t>> regs);
   uint32_t reg_read_priv(uint32_t reg_idx);
 
   int fd_;                                     // file descriptor of xpcieN
@@ -97,12 +159,25 @@ class ptu_dev {
   uint32_t base_;                              // register base address
   uint32_t ip_addr_;                           // my IP address
   std::mutex mtx_dev_;                         // for PTU register access
-  std::thread th_evt_;                         // thread for event monitoring
-  std::atomic<bool> stop_evt_;                 // flag of stopping event thread
   std::unordered_set<uint16_t> listen_socks_;  // set of listened port
-  std::mutex mtx_listen_socks_;                // for listen_socks_
+  bool listen_closed_ = false;                 // set by listen_close_all()
+  std::mutex mtx_listen_socks_;                // for listen_socks_, listen_closed_
   std::unordered_map<sock_info, ptu_tcp_conn, sock_info_hash>
-      socks_;                         // sockets
-  std::mutex mtx_socks_;              // for socks_
-  std::condition_variable cv_socks_;  // for socks_
+      socks_;                                         // sockets
+  std::unordered_map<uint16_t, sock_info> cid_socks_;  // cid -> key of socks_
+  std::unordered_multimap<sock_info, std::pair<conn_wait*, uint32_t>,
+                          sock_info_hash>
+      conn_waits_;  // 4-tuple -> (waiting thread, index of reqs)
+  std::unordered_map<uint16_t, uint32_t> port_socks_;  // lport -> num of sockets
+  std::unordered_multimap<uint16_t, std::condition_variable*>
+      port_waits_;  // lport -> threads waiting for any socket on it
+  std::mutex mtx_socks_;  // for socks_, cid_socks_, conn_waits_ and port_*
+  std::condition_variable cv_evt_;  // notified when TCP events are handled
+  uint64_t evt_gen_ = 0;            // num of passes which handled TCP events
+  std::mutex mtx_evt_;              // for evt_gen_
+  std::vector<fpga_arp_entry_t> arp_cache_;  // valid ARP entries
+  std::chrono::steady_clock::time_point arp_cache_time_;  // time of arp_cache_
+  bool arp_cache_valid_ = false;  // false when arp_cache_ needs re-reading
+  std::mutex mtx_arp_cache_;      // for arp_cache_*
+  std::atomic<bool> exited_{false};  // true after fpga_ptu_exit()
 };
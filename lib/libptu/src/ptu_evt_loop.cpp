@@ -0,0 +1,108 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+
+#include <ptu_evt_loop.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+#include <ptu_dev.hpp>
+
+// Keep polling without sleep for a while after the last event,
+// because TCP events tend to come in bursts (e.g. SYN-ACK after SYN)
+constexpr auto POLL_SPIN_TIME = std::chrono::microseconds(500);
+// Idle sleep starts from POLL_MIN_INTERVAL and doubles up to POLL_MAX_INTERVAL,
+// which is the fixed interval of the former per-device polling thread
+constexpr int POLL_EVT_MS = 100;  // 100ms
+constexpr auto POLL_MIN_INTERVAL = std::chrono::microseconds(100);
+constexpr auto POLL_MAX_INTERVAL = std::chrono::milliseconds(POLL_EVT_MS);
+
+ptu_evt_loop& ptu_evt_loop::instance() {
+  // never destructed, because ptu_dev in static storage may call remove()
+  // after static objects constructed later were destructed at exit
+  static ptu_evt_loop* loop = new ptu_evt_loop();
+  return *loop;
+}
+
+void ptu_evt_loop::add(ptu_dev* dev) {
+  std::unique_lock<std::mutex> lk(mtx_devs_);
+  if (std::find(devs_.begin(), devs_.end(), dev) != devs_.end()) {
+    return;
+  }
+  devs_.push_back(dev);
+  if (!th_.joinable()) {
+    uint64_t gen = gen_;
+    th_ = std::thread([this, gen] { run(gen); });
+  }
+  // poll the new device immediately
+  cv_.notify_all();
+}
+
+void ptu_evt_loop::remove(ptu_dev* dev) {
+  std::unique_lock<std::mutex> lk(mtx_devs_);
+  auto it = std::find(devs_.begin(), devs_.end(), dev);
+  if (it == devs_.end()) {
+    return;
+  }
+  devs_.erase(it);
+  if (devs_.empty()) {
+    stop_thread(lk);
+  }
+}
+
+void ptu_evt_loop::kick() {
+  kicked_ = true;
+  // take mtx_devs_ so that the thread cannot miss the notification
+  // between checking kicked_ and sleeping
+  std::lock_guard<std::mutex> lk(mtx_devs_);
+  cv_.notify_all();
+}
+
+void ptu_evt_loop::stop_thread(std::unique_lock<std::mutex>& lk) {
+  if (!th_.joinable()) {
+    return;
+  }
+  // a thread started by add() while joining has the new generation
+  gen_++;
+  cv_.notify_all();
+  std::thread th = std::move(th_);
+  lk.unlock();
+  th.join();
+  lk.lock();
+}
+
+void ptu_evt_loop::run(uint64_t gen) {
+  auto interval = POLL_MIN_INTERVAL;
+  auto last_active = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lk(mtx_devs_);
+  while (gen == gen_) {
+    // drain all pending events of all devices in one pass
+    int handled = 0;
+    for (auto dev : devs_) {
+      handled += dev->handle_tcp_events();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (handled > 0 || kicked_.exchange(false)) {
+      last_active = now;
+      interval = POLL_MIN_INTERVAL;
+      continue;
+    }
+    if (now - last_active < POLL_SPIN_TIME) {
+      // spin briefly after activity, letting add()/remove() in
+      lk.unlock();
+      std::this_thread::yield();
+      lk.lock();
+      continue;
+    }
+
+    // idle: back off up to POLL_MAX_INTERVAL, add()/remove()/kick() wake us up
+    cv_.wait_for(lk, interval, [&] { return kicked_ || gen != gen_; });
+    interval = std::min<std::chrono::microseconds>(interval * 2,
+                                                   POLL_MAX_INTERVAL);
+  }
+}
@@ -0,0 +1,50 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+/**
+ * @file ptu_evt_loop.hpp
+ * @brief Header file for the TCP event loop shared by all PTU instances
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ptu_dev;
+
+// One thread polls TCP events of all registered ptu_dev
+class ptu_evt_loop {
+ public:
+  static ptu_evt_loop& instance();
+
+  // The thread starts with the first device and stops with the last one.
+  // When remove() returns, no handler of the device is running.
+  void add(ptu_dev* dev);
+  void remove(ptu_dev* dev);
+  // Poll immediately and restart the backoff, called after issuing commands
+  // which raise TCP events. Do not call with mtx_socks_ or mtx_dev_ held.
+  void kick();
+
+ private:
+  ptu_evt_loop() = default;
+  ptu_evt_loop(const ptu_evt_loop&) = delete;
+  ptu_evt_loop& operator=(const ptu_evt_loop&) = delete;
+
+  void run(uint64_t gen);
+  void stop_thread(std::unique_lock<std::mutex>& lk);
+
+  std::vector<ptu_dev*> devs_;   // registered devices
+  std::mutex mtx_devs_;          // for devs_, held while dispatching
+  std::condition_variable cv_;   // wakes the thread up from idle sleep
+  std::thread th_;               // event loop thread
+  uint64_t gen_ = 0;             // th_ stops when this differs from its own
+  std::atomic<bool> kicked_{false};  // set by kick(), consumed by th_
+};
@@ -6,9 +6,14 @@
 
 #include <ptu_reg_func.hpp>
 
+#include <errno.h>
 #include <stdint.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <chrono>
+
+constexpr uint32_t PTU_REG_VEC_MAX = XPCIE_DEV_REG_VEC_MAX;
 
 void ptu_reg_write(int fd, uint32_t base, uint32_t reg_idx, uint32_t value) {
   pwrite(fd, &value, sizeof(uint32_t), base + reg_idx * 4);
@@ -19,3 +24,74 @@ uint32_t ptu_reg_read(int fd, uint32_t base, uint32_t reg_idx) {
   pread(fd, &value, sizeof(uint32_t), base + reg_idx * 4);
   return value;
 }
+
+// fallback for the driver without XPCIE_DEV_DRIVER_RW_REGS
+static int ptu_reg_rw_each(int fd, uint32_t base, fpga_ioctl_reg_op_t *ops,
+                           uint32_t num) {
+  for (uint32_t i = 0; i < num; i++) {
+    switch (ops[i].op) {
+      case XPCIE_DEV_REG_OP_READ32:
+        ops[i].value = ptu_reg_read(fd, base, ops[i].offset);
+        break;
+      case XPCIE_DEV_REG_OP_WRITE32:
+        ptu_reg_write(fd, base, ops[i].offset, ops[i].value);
+        break;
+      case XPCIE_DEV_REG_OP_POLL32: {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(ops[i].poll_us);
+        uint32_t value = ptu_reg_read(fd, base, ops[i].offset);
+        while ((value & ops[i].mask) != ops[i].value) {
+          if (std::chrono::steady_clock::now() >= deadline) {
+            ops[i].value = value;
+            return -1;
+          }
+          value = ptu_reg_read(fd, base, ops[i].offset);
+        }
+        ops[i].value = value;
+        break;
+      }
+      default:
+        return -1;
+    }
+  }
+  return 0;
+}
+
+int ptu_reg_rw_vec(int fd, uint32_t base, fpga_ioctl_reg_op_t *ops,
+                   uint32_t num) {
+  if (num == 0 || num > PTU_REG_VEC_MAX) {
+    return -1;
+  }
+
+  fpga_ioctl_reg_op_t regs[PTU_REG_VEC_MAX];
+  for (uint32_t i = 0; i < num; i++) {
+    regs[i] = ops[i];
+    regs[i].offset = base + ops[i].offset * 4;
+  }
+
+  fpga_ioctl_reg_vec_t vec;
+  vec.ops = reinterpret_cast<uintptr_t>(regs);
+  vec.num = num;
+  vec.done = 0;
+  if (ioctl(fd, XPCIE_DEV_DRIVER_RW_REGS, &vec) != 0) {
+    int err = errno;
+    if (err == ENOTTY) {
+      // ioctl is not supported, access registers one by one
+      return ptu_reg_rw_each(fd, base, ops, num);
+    }
+    if (err == ETIMEDOUT) {
+      // return the values read before polling timed out,
+      // and the last value of the timed-out poll at ops[vec.done]
+      uint32_t copy_num = vec.done < num ? vec.done + 1 : num;
+      for (uint32_t i = 0; i < copy_num; i++) {
+        ops[i].value = regs[i].value;
+      }
+    }
+    return -1;
+  }
+
+  for (uint32_t i = 0; i < vec.done; i++) {
+    ops[i].value = regs[i].value;
+  }
+  return 0;
+}
@@ -12,6 +12,13 @@
 
 #include <stdint.h>
 
+#include <xpcie_device.h>
+
 // reg func
 void ptu_reg_write(int fd, uint32_t base, uint32_t reg_idx, uint32_t value);
 uint32_t ptu_reg_read(int fd, uint32_t base, uint32_t reg_idx);
+// ops[].offset is reg_idx, all ops are executed by one system call
+// (falls back to one by one only when the driver does not know the ioctl)
+// when a poll times out, ops[] up to the timed-out op hold the read values
+int ptu_reg_rw_vec(int fd, uint32_t base, fpga_ioctl_reg_op_t *ops,
+                   uint32_t num);
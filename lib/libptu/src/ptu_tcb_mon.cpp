@@ -0,0 +1,159 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+
+#include <ptu_tcb_mon.hpp>
+
+#include <time.h>
+
+#include <utility>
+
+ptu_tcb_mon::ptu_tcb_mon(ptu_dev* dev, uint64_t interval_us, uint32_t history)
+    : dev_(dev),
+      interval_us_(interval_us),
+      history_(history),
+      stop_(false) {
+  th_ = std::thread([this] { run(); });
+}
+
+ptu_tcb_mon::~ptu_tcb_mon(void) {
+  {
+    std::lock_guard<std::mutex> lk(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (th_.joinable()) {
+    th_.join();
+  }
+}
+
+void ptu_tcb_mon::get_table(std::vector<fpga_ptu_tcb_rate_t>& table) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  table.clear();
+  for (const auto& it : cids_) {
+    if (!it.second.series.empty()) {
+      table.push_back(it.second.series.back());
+    }
+  }
+}
+
+bool ptu_tcb_mon::get_series(uint32_t cid,
+                             std::vector<fpga_ptu_tcb_rate_t>& series) {
+  std::lock_guard<std::mutex> lk(mtx_);
+  auto it = cids_.find(cid);
+  if (it == cids_.end()) {
+    return false;
+  }
+  series.assign(it->second.series.begin(), it->second.series.end());
+  return true;
+}
+
+void ptu_tcb_mon::run() {
+  auto next = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lk(mtx_);
+  while (!stop_) {
+    lk.unlock();
+    sample();
+    lk.lock();
+    next += std::chrono::microseconds(interval_us_);
+    auto now = std::chrono::steady_clock::now();
+    if (next < now) {
+      // sampling took longer than the interval, do not try to catch up
+      next = now;
+    }
+    cv_.wait_until(lk, next, [this] { return stop_; });
+  }
+}
+
+void ptu_tcb_mon::sample() {
+  // dump TCBs without mtx_ not to block readers of the table
+  std::vector<std::pair<uint16_t, sock_info>> cids = dev_->established_cids();
+  std::vector<uint32_t> cid_list(cids.size());
+  for (size_t i = 0; i < cids.size(); i++) {
+    cid_list[i] = cids[i].first;
+  }
+  std::vector<fpga_dump_tcb_t> tcbs(cids.size());
+  std::vector<std::chrono::steady_clock::time_point> times(cids.size());
+  std::vector<uint8_t> valid(cids.size());
+  if (!cids.empty()) {
+    dev_->dump_tcbs(cid_list.data(), cid_list.size(), tcbs.data(),
+                    valid.data(), times.data());
+  }
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  std::lock_guard<std::mutex> lk(mtx_);
+
+  // forget closed connections
+  std::map<uint16_t, cid_state> cur;
+  for (size_t i = 0; i < cids.size(); i++) {
+    uint16_t cid = cids[i].first;
+    const fpga_dump_tcb_t& tcb = tcbs[i];
+    auto prev_it = cids_.find(cid);
+    bool reused = prev_it != cids_.end() && !(prev_it->second.info == cids[i].second);
+    if (!valid[i]) {
+      // keep the connection and its series, the next sample covers this interval
+      if (prev_it != cids_.end() && !reused) {
+        cid_state state = std::move(prev_it->second);
+        state.dump_fail_cnt++;
+        cur.emplace(cid, std::move(state));
+      }
+      continue;
+    }
+    if (prev_it == cids_.end() || reused) {
+      // first sample of this connection, rates need the next sample
+      cid_state state = {};
+      state.info = cids[i].second;
+      state.last = tcb;
+      state.last_time = times[i];
+      cur.emplace(cid, std::move(state));
+      continue;
+    }
+
+    cid_state state = std::move(prev_it->second);
+    uint64_t dt_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        times[i] - state.last_time).count();
+    if (dt_us == 0) {
+      cur.emplace(cid, std::move(state));
+      continue;
+    }
+    // sequence numbers wrap around by uint32_t arithmetic
+    uint32_t acked = tcb.tcb_snd_una - state.last.tcb_snd_una;
+    uint32_t received = tcb.tcb_rcv_nxt - state.last.tcb_rcv_nxt;
+    uint32_t inflight = tcb.tcb_snd_nxt - tcb.tcb_snd_una;
+    uint32_t unsent = tcb.tcb_usr_wrt - tcb.tcb_snd_nxt;
+
+    state.elapsed_us += dt_us;
+    if (inflight >= tcb.tcb_snd_wnd) {
+      // the peer's window is full, the sender has to wait
+      state.wnd_limited_us += dt_us;
+    } else if (unsent > 0) {
+      // data is waiting although the window has room
+      state.snd_limited_us += dt_us;
+    }
+
+    fpga_ptu_tcb_rate_t rate = {};
+    rate.cid = cid;
+    rate.timestamp = ts;
+    rate.snd_rate = static_cast<uint64_t>(acked) * 1000000 / dt_us;
+    rate.rcv_rate = static_cast<uint64_t>(received) * 1000000 / dt_us;
+    rate.inflight = inflight;
+    rate.unsent = unsent;
+    rate.snd_wnd = tcb.tcb_snd_wnd;
+    rate.elapsed_us = state.elapsed_us;
+    rate.wnd_limited_us = state.wnd_limited_us;
+    rate.snd_limited_us = state.snd_limited_us;
+    rate.dump_fail_cnt = state.dump_fail_cnt;
+    state.series.push_back(rate);
+    while (state.series.size() > history_) {
+      state.series.pop_front();
+    }
+
+    state.last = tcb;
+    state.last_time = times[i];
+    cur.emplace(cid, std::move(state));
+  }
+  cids_.swap(cur);
+}
@@ -0,0 +1,58 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+/**
+ * @file ptu_tcb_mon.hpp
+ * @brief Header file for per-connection TCP monitor based on TCB dumps
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <libptu.h>
+#include <ptu_dev.hpp>
+
+// Samples TCBs of all established connections of a ptu_dev periodically
+class ptu_tcb_mon {
+ public:
+  ptu_tcb_mon(ptu_dev* dev, uint64_t interval_us, uint32_t history);
+  ~ptu_tcb_mon(void);
+
+  void get_table(std::vector<fpga_ptu_tcb_rate_t>& table);
+  bool get_series(uint32_t cid, std::vector<fpga_ptu_tcb_rate_t>& series);
+
+ private:
+  struct cid_state {
+    sock_info info;                                   // to detect cid reuse
+    fpga_dump_tcb_t last;                             // previous TCB dump
+    std::chrono::steady_clock::time_point last_time;  // time of `last`
+    uint64_t elapsed_us;                              // sum of intervals
+    uint64_t wnd_limited_us;                          // sum of window-limited intervals
+    uint64_t snd_limited_us;                          // sum of send-limited intervals
+    uint64_t dump_fail_cnt;                           // num of failed TCB dumps
+    std::deque<fpga_ptu_tcb_rate_t> series;           // oldest first
+  };
+
+  void run();
+  void sample();
+
+  ptu_dev* dev_;                       // monitored device
+  uint64_t interval_us_;               // sampling interval
+  uint32_t history_;                   // max length of series per cid
+  std::map<uint16_t, cid_state> cids_;  // cid -> state, sorted by cid
+  std::mutex mtx_;                     // for cids_ and stop_
+  std::condition_variable cv_;         // wakes up th_ to stop
+  bool stop_;                          // flag of stopping th_
+  std::thread th_;                     // sampling thread
+};
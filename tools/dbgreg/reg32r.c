@@ -16,6 +16,7 @@
 #define READ_MAX_SIZE   0x4000
 #define WRITE_MAX_SIZE  64
 #define REG_ACCESS_MAX  0x140000
+#define REG_LANE_ALIGN  0x400     // the smallest size of module's lane
 
 #ifndef APP_VERSION
 #define APP_VERSION "<invalid_version>"
@@ -26,7 +27,7 @@ static void print_usage(void) {
   printf("  Usage: reg32r <device_file_name|serial_id> <address(hex:0-%#x)> [size(dec)]\n",
     REG_ACCESS_MAX - 1);
 }
-static int reg_read(int fd, uint32_t addr, uint32_t *value);
+static int reg_read(uint32_t dev_id, int fd, uint32_t addr, uint32_t *value, int num);
 
 /* ******** *
  * * main * *
@@ -42,7 +43,7 @@ int main(int argc, char **argv)
 
   int fd;
   uint32_t addr;
-  uint32_t data;
+  uint32_t data[READ_MAX_SIZE / 4];
   uint32_t size = 4;  // default read size is 4byte
 
   // suppress create libfpga log-file
@@ -101,18 +102,20 @@ int main(int argc, char **argv)
 
   //read
   addr = (addr/4)*4;
+  if (size > READ_MAX_SIZE)
+    size = READ_MAX_SIZE;
+  if (reg_read(dev_id, fd, addr, data, size/4)) {
+    printf("ERROR at reg_read()! (address)=(%#010x)\n", addr);
+    goto finish;
+  }
   printf(" %04X : ", addr);
   for (i=0; i<size/4; i++) {
-    if (reg_read(fd, addr, &data)) {
-      printf("ERROR at reg_read()! (address)=(%#010x)\n", addr);
-      goto finish;
-    }
     if ( (i > 0) && ((i % 4) == 0) ) {
       printf("\n");
       printf(" %04X : ", addr);
     }
     addr += 4;
-    printf("%08x ", data);
+    printf("%08x ", data[i]);
   }
   printf("\n");
 
@@ -127,15 +130,46 @@ finish:
 //---------------------------------------
 //  FPGA register access
 //---------------------------------------
-static int reg_read(int fd, uint32_t addr, uint32_t *value)
+static int reg_read(uint32_t dev_id, int fd, uint32_t addr, uint32_t *value, int num)
 {
-  if (addr > REG_ACCESS_MAX){
-    printf(" address error(%#010X)\n",addr);
+  fpga_ioctl_reg_op_t ops[XPCIE_DEV_REG_VEC_MAX];
+  int i, j, chunk;
+
+  if (addr + (num - 1) * 4 > REG_ACCESS_MAX){
+    printf(" address error(%#010X)\n", addr + (num - 1) * 4);
     return -1;
   }
-  int n = pread(fd, value, sizeof(uint32_t), addr);
-  if (n != sizeof(uint32_t)) {
-      return -1;
+
+  // Read up to XPCIE_DEV_REG_VEC_MAX registers per a system call,
+  //  without crossing the boundary of module's lane
+  for (i = 0; i < num; i += chunk) {
+    chunk = (REG_LANE_ALIGN - ((addr + i * 4) % REG_LANE_ALIGN)) / 4;
+    if (chunk == 0)
+      chunk = 1;
+    if (chunk > num - i)
+      chunk = num - i;
+    if (chunk > XPCIE_DEV_REG_VEC_MAX)
+      chunk = XPCIE_DEV_REG_VEC_MAX;
+    for (j = 0; j < chunk; j++) {
+      ops[j].op = XPCIE_DEV_REG_OP_READ32;
+      ops[j].offset = addr + (i + j) * 4;
+      ops[j].value = 0;
+      ops[j].mask = 0;
+      ops[j].poll_us = 0;
+    }
+    if (!fpga_reg_rw_vec(dev_id, ops, chunk, NULL)) {
+      for (j = 0; j < chunk; j++)
+        value[i + j] = ops[j].value;
+      continue;
+    }
+
+    // Fallback for the driver without vectored register access
+    for (j = 0; j < chunk; j++) {
+      int n = pread(fd, &value[i + j], sizeof(uint32_t), addr + (i + j) * 4);
+      if (n != sizeof(uint32_t)) {
+          return -1;
+      }
+    }
   }
 
   return 0;
@@ -26,7 +26,7 @@ static void print_usage(void) {
   printf("  Usage: reg32w <device_file_name|serial_id> <address(hex:0-%#x)> <data(hex)> [data(hex)]...\n",
     REG_ACCESS_MAX - 1);
 }
-static int reg_write(int fd, uint32_t addr, uint32_t value);
+static int reg_write(uint32_t dev_id, int fd, uint32_t addr, const uint32_t *value, int num);
 
 /* ******** *
  * * main * *
@@ -86,15 +86,11 @@ int main(int argc, char **argv)
     data[i] = strtoul(argv[i+3], NULL, 16);
   }
 
-  // read
+  // write all data by one system call
   addr = (addr/4)*4;
-  for (i = 0; i < setting_data_num ; i++){
-    //write
-    if (reg_write(fd, addr, data[i])) { 
-      printf("ERROR at reg_write()! (address,data)=(%#010x,%#010x)\n", addr,data[i]);
-      goto finish;
-    }
-    addr += 4;
+  if (reg_write(dev_id, fd, addr, data, setting_data_num)) {
+    printf("ERROR at reg_write()! (address,num)=(%#010x,%d)\n", addr, setting_data_num);
+    goto finish;
   }
 
 
@@ -108,15 +104,31 @@ finish:
 //---------------------------------------
 //  FPGA register access
 //---------------------------------------
-static int reg_write(int fd, uint32_t addr, uint32_t value)
+static int reg_write(uint32_t dev_id, int fd, uint32_t addr, const uint32_t *value, int num)
 {
-  if (addr > REG_ACCESS_MAX){
-    printf(" address error(%#010X)\n",addr);
+  fpga_ioctl_reg_op_t ops[WRITE_MAX_SIZE];
+  int i;
+
+  if (addr + (num - 1) * 4 > REG_ACCESS_MAX){
+    printf(" address error(%#010X)\n", addr + (num - 1) * 4);
     return -1;
   }
-  int n = pwrite(fd, &value, sizeof(uint32_t), addr);
-  if (n != sizeof(uint32_t)) {
-      return -1;
+  for (i = 0; i < num; i++) {
+    ops[i].op = XPCIE_DEV_REG_OP_WRITE32;
+    ops[i].offset = addr + i * 4;
+    ops[i].value = value[i];
+    ops[i].mask = 0;
+    ops[i].poll_us = 0;
+  }
+  if (!fpga_reg_rw_vec(dev_id, ops, num, NULL))
+    return 0;
+
+  // Fallback for the driver without vectored register access
+  for (i = 0; i < num; i++) {
+    int n = pwrite(fd, &value[i], sizeof(uint32_t), addr + i * 4);
+    if (n != sizeof(uint32_t)) {
+        return -1;
+    }
   }
 
   return 0;
@@ -0,0 +1,256 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+#include <libdma.h>
+#include <liblogging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+
+#ifndef APP_VERSION
+#define APP_VERSION "x.x.x"
+#endif
+
+#define QUEUE_SIZE      256         /**< Num of descriptors of the software queue */
+#define DATA_LEN        4096        /**< Data length set into descriptors */
+#define DATA_PHYS_ADDR  0x100000    /**< Dummy physical address set into descriptors */
+
+
+static unsigned long m_loop = 10 * 1000 * 1000;
+
+
+static void print_usage(void) {
+  printf("log_bench: version %s\n", APP_VERSION);
+  printf("usage: ./log_bench [-n <loop>] [-l <loglevel>]\n");
+  printf("loop    :default=10000000\n");
+  printf("loglevel:default=0(LIBFPGA_LOG_NOTHING)\n");
+  printf("\n");
+}
+
+static const struct option long_options[] = {
+    { "loop", required_argument, NULL, 'n' },
+    { "loglevel", required_argument, NULL, 'l' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, 0, 0 },
+};
+
+static const char short_options[] = {
+    "n:l:h"
+};
+
+
+static int parse_args(
+  int argc,
+  char **argv
+) {
+  int opt;
+  int option_index;
+
+  while ((opt = getopt_long(argc, argv, short_options,
+                long_options, &option_index)) != EOF
+  ) {
+    switch (opt) {
+    case 'h':
+      print_usage();
+      exit(0);
+    case 'n':
+      m_loop = strtoul(optarg, NULL, 0);
+      break;
+    case 'l':
+      libfpga_log_set_level(atoi(optarg));
+      break;
+    default:
+      printf("Cannot parse option : %s\n", argv[optind - 1]);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+
+static double elapsed_nsec(
+  const struct timespec *start,
+  const struct timespec *end
+) {
+  return (double)(end->tv_sec - start->tv_sec) * 1000000000.0
+    + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+
+/**
+ * @brief Debug log through out-of-line call as llf_dbg() did before the inline level check
+ */
+static void bench_log_call(void) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned long i = 0; i < m_loop; i++)
+    log_libfpga(LIBFPGA_LOG_DEBUG, FPGA_LOGGER_LIBNAME "%s(loop(%lu))\n", __func__, i);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("log_libfpga()    : %8.3f ns/call\n", elapsed_nsec(&start, &end) / m_loop);
+}
+
+
+/**
+ * @brief Debug log through llf_dbg()
+ */
+static void bench_log_macro(void) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned long i = 0; i < m_loop; i++)
+    llf_dbg("%s(loop(%lu))\n", __func__, i);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("llf_dbg()        : %8.3f ns/call\n", elapsed_nsec(&start, &end) / m_loop);
+}
+
+
+/**
+ * @brief Allocate a software queue and set it into dma_info
+ */
+static fpga_queue_t *alloc_queue(
+  dma_info_t *dma_info
+) {
+  fpga_queue_t *queue = (fpga_queue_t*)aligned_alloc(64,  // NOLINT
+    sizeof(fpga_queue_t) + sizeof(fpga_desc_t) * QUEUE_SIZE);
+  if (!queue) {
+    printf("Failed to allocate queue\n");
+    return NULL;
+  }
+  memset(queue, 0, sizeof(fpga_queue_t) + sizeof(fpga_desc_t) * QUEUE_SIZE);
+  queue->size = QUEUE_SIZE;
+
+  memset(dma_info, 0, sizeof(*dma_info));
+  dma_info->dir = DMA_HOST_TO_DEV;
+  dma_info->queue_addr = queue;
+  dma_info->queue_size = QUEUE_SIZE;
+
+  return queue;
+}
+
+
+/**
+ * @brief fpga_enqueue_with_physaddr()/fpga_dequeue() on a software queue
+ *        (descriptors are completed by this function instead of FPGA)
+ */
+static int bench_enqdeq(void) {
+  dma_info_t dma_info;
+  fpga_queue_t *queue = alloc_queue(&dma_info);
+  if (!queue)
+    return -1;
+
+  dmacmd_info_t cmd_info;
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (unsigned long i = 0; i < m_loop; i++) {
+    memset(&cmd_info, 0, sizeof(cmd_info));
+    cmd_info.task_id = (i % 0xffff) + 1;
+    cmd_info.data_len = DATA_LEN;
+    cmd_info.data_addr = (void*)DATA_PHYS_ADDR;  // NOLINT
+    if (fpga_enqueue_with_physaddr(&dma_info, &cmd_info)) {
+      printf("Error happened at fpga_enqueue_with_physaddr()\n");
+      free(queue);
+      return -1;
+    }
+    ((fpga_desc_t*)cmd_info.desc_addr)->op = CMD_DONE;  // NOLINT
+    if (fpga_dequeue(&dma_info, &cmd_info)) {
+      printf("Error happened at fpga_dequeue()\n");
+      free(queue);
+      return -1;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("enqueue+dequeue  : %8.3f ns/pair\n", elapsed_nsec(&start, &end) / m_loop);
+
+  free(queue);
+  return 0;
+}
+
+
+/**
+ * @brief Producer and consumer sides separately:
+ *        fill the whole queue by fpga_enqueue_with_physaddr(),
+ *        complete all descriptors(not measured), then drain it by fpga_dequeue()
+ */
+static int bench_enq_then_deq(void) {
+  dma_info_t dma_info;
+  fpga_queue_t *queue = alloc_queue(&dma_info);
+  if (!queue)
+    return -1;
+
+  unsigned long rounds = m_loop / QUEUE_SIZE ? m_loop / QUEUE_SIZE : 1;
+  double enq_nsec = 0;
+  double deq_nsec = 0;
+  dmacmd_info_t cmd_info;
+  struct timespec start, end;
+  for (unsigned long r = 0; r < rounds; r++) {
+    // producer
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < QUEUE_SIZE; i++) {
+      memset(&cmd_info, 0, sizeof(cmd_info));
+      cmd_info.task_id = i + 1;
+      cmd_info.data_len = DATA_LEN;
+      cmd_info.data_addr = (void*)DATA_PHYS_ADDR;  // NOLINT
+      if (fpga_enqueue_with_physaddr(&dma_info, &cmd_info)) {
+        printf("Error happened at fpga_enqueue_with_physaddr()\n");
+        free(queue);
+        return -1;
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    enq_nsec += elapsed_nsec(&start, &end);
+
+    for (int i = 0; i < QUEUE_SIZE; i++)
+      queue->ring[i].op = CMD_DONE;
+
+    // consumer
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < QUEUE_SIZE; i++) {
+      if (fpga_dequeue(&dma_info, &cmd_info)) {
+        printf("Error happened at fpga_dequeue()\n");
+        free(queue);
+        return -1;
+      }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    deq_nsec += elapsed_nsec(&start, &end);
+  }
+  printf("enqueue          : %8.3f ns/call\n", enq_nsec / (rounds * QUEUE_SIZE));
+  printf("dequeue          : %8.3f ns/call\n", deq_nsec / (rounds * QUEUE_SIZE));
+
+  free(queue);
+  return 0;
+}
+
+
+/* ******** *
+ * * main * *
+ * ******** */
+int main(int argc, char **argv)
+{
+  // set log
+  libfpga_log_set_output_stdout();
+  libfpga_log_set_level(LIBFPGA_LOG_NOTHING);
+
+  // parse options
+  if (parse_args(argc, argv)) {
+    print_usage();
+    return -1;
+  }
+
+  printf("loglevel: %d, LIBFPGA_LOG_COMPILE_LEVEL: %d, loop: %lu\n",
+    libfpga_log_get_level(), LIBFPGA_LOG_COMPILE_LEVEL, m_loop);
+
+  bench_log_call();
+  bench_log_macro();
+  if (bench_enqdeq())
+    return -1;
+  if (bench_enq_then_deq())
+    return -1;
+
+  return 0;
+}
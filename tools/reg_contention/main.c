@@ -0,0 +1,268 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+#include <libfpgactl.h>
+#include <liblogging.h>
+
+#include <libchain.h>
+#include <libchain_stat.h>
+#include <liblldma.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef APP_VERSION
+#define APP_VERSION "x.x.x"
+#endif
+
+#define THREAD_MAX  64  /**< The max num of threads reading statistics */
+
+
+static unsigned int m_thread_num = 8;
+static unsigned long m_sample = 100000;
+static uint32_t m_lane = 0;
+
+static uint32_t m_dev_id = 0;
+static volatile int m_stop = 0;
+
+
+static void print_usage(void) {
+  printf("reg_contention: version %s\n", APP_VERSION);
+  printf("usage: ./reg_contention -d <device file> [-- -t <threads> -n <samples> -l <lane>]\n");
+  printf("threads:default=8(max %d)\n", THREAD_MAX);
+  printf("samples:default=100000\n");
+  printf("lane   :default=0\n");
+  printf("\n");
+}
+
+static const struct option long_options[] = {
+    { "threads", required_argument, NULL, 't' },
+    { "samples", required_argument, NULL, 'n' },
+    { "lane", required_argument, NULL, 'l' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, 0, 0 },
+};
+
+static const char short_options[] = {
+    "t:n:l:h"
+};
+
+static int parse_args(
+  int argc,
+  char **argv
+) {
+  int opt, ret;
+  char **argvopt;
+  int option_index;
+  char *prgname = argv[0];
+  const int old_optind = optind;
+  const int old_optopt = optopt;
+  char * const old_optarg = optarg;
+
+  argvopt = argv;
+  optind = 1;
+  opterr = 0;
+
+  while ((opt = getopt_long(argc, argvopt, short_options,
+                long_options, &option_index)) != EOF
+  ) {
+    switch (opt) {
+    case 'h':
+      print_usage();
+      exit(0);
+    case 't':
+      m_thread_num = strtoul(optarg, NULL, 0);
+      break;
+    case 'n':
+      m_sample = strtoul(optarg, NULL, 0);
+      break;
+    case 'l':
+      m_lane = strtoul(optarg, NULL, 0);
+      break;
+    default:
+      printf("Cannot parse option : %s\n", argvopt[optind - 1]);
+      ret = -1;
+      goto out;
+    }
+  }
+
+  if (m_thread_num > THREAD_MAX || m_sample == 0) {
+    printf("Invalid option : threads(%u), samples(%lu)\n", m_thread_num, m_sample);
+    ret = -1;
+    goto out;
+  }
+
+  if (optind >= 0)
+    argv[optind - 1] = prgname;
+  ret = optind - 1;
+
+out:
+  optind = old_optind;
+  optopt = old_optopt;
+  optarg = old_optarg;
+
+  return ret;
+}
+
+
+static uint64_t now_nsec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+static int compare_u64(
+  const void *a,
+  const void *b
+) {
+  uint64_t va = *(const uint64_t*)a;  // NOLINT
+  uint64_t vb = *(const uint64_t*)b;  // NOLINT
+  return (va > vb) - (va < vb);
+}
+
+
+/**
+ * @brief Thread which reads chain statistics by ioctl as fast as possible
+ */
+static void *stat_thread(
+  void *arg
+) {
+  unsigned long *count = (unsigned long*)arg;  // NOLINT
+  uint64_t byte_num;
+  uint32_t frame_num;
+
+  while (!m_stop) {
+    fpga_chain_get_stat_bytes(m_dev_id, m_lane, FUNCTION_CHAIN_ID_MIN,
+      CHAIN_STAT_INGR_SND0, &byte_num);
+    fpga_chain_get_stat_frames(m_dev_id, m_lane, FUNCTION_CHAIN_ID_MIN,
+      CHAIN_STAT_INGR_SND0, &frame_num);
+    (*count) += 2;
+  }
+
+  return NULL;
+}
+
+
+/**
+ * @brief Measure the latency of LLDMA control register access and print it
+ */
+static int measure_lldma_latency(
+  const char *label,
+  uint64_t *latency
+) {
+  uint32_t value;
+
+  for (unsigned long i = 0; i < m_sample; i++) {
+    uint64_t start = now_nsec();
+    if (fpga_lldma_get_rxch_ctrl0(m_dev_id, &value)) {
+      printf("Error happened at fpga_lldma_get_rxch_ctrl0()\n");
+      return -1;
+    }
+    latency[i] = now_nsec() - start;
+  }
+
+  uint64_t sum = 0;
+  for (unsigned long i = 0; i < m_sample; i++)
+    sum += latency[i];
+  qsort(latency, m_sample, sizeof(uint64_t), compare_u64);
+
+  printf("%-12s: min %8lu ns, avg %10.1f ns, p50 %8lu ns, p99 %8lu ns, max %8lu ns\n",
+    label,
+    latency[0],
+    (double)sum / m_sample,
+    latency[m_sample / 2],
+    latency[m_sample * 99 / 100],
+    latency[m_sample - 1]);
+
+  return 0;
+}
+
+
+/* ******** *
+ * * main * *
+ * ******** */
+int main(int argc, char **argv)
+{
+  // set log
+  libfpga_log_set_output_stdout();
+  libfpga_log_quit_timestamp();
+  libfpga_log_set_level(LIBFPGA_LOG_NOTHING);
+
+  // init fpga
+  int ret;
+  ret = fpga_init(argc, argv);
+  if (ret <= 0) {
+    printf("Error happened at fpga_init(): ret=%d\n", ret);
+    print_usage();
+    return -1;
+  }
+  argc -= ret;
+  argv += ret;
+
+  // parse options
+  ret = parse_args(argc, argv);
+  if (ret < 0) {
+    printf("Failed to parse options...\n");
+    fpga_finish();
+    return -1;
+  }
+
+  if ((ret = fpga_get_num()) != 1) {
+    printf("FPGA num(%d) is invalid...\n", ret);
+    print_usage();
+    fpga_finish();
+    return -1;
+  }
+
+  uint64_t *latency = (uint64_t*)malloc(sizeof(uint64_t) * m_sample);  // NOLINT
+  if (!latency) {
+    printf("Failed to allocate memory\n");
+    fpga_finish();
+    return -1;
+  }
+
+  printf("threads: %u, samples: %lu, lane: %u\n", m_thread_num, m_sample, m_lane);
+
+  // Latency without any statistics reader
+  ret = measure_lldma_latency("idle", latency);
+
+  // Latency while statistics readers are running
+  pthread_t threads[THREAD_MAX];
+  unsigned long counts[THREAD_MAX];
+  unsigned int started = 0;
+  memset(counts, 0, sizeof(counts));
+  for (; !ret && started < m_thread_num; started++) {
+    if (pthread_create(&threads[started], NULL, stat_thread, &counts[started])) {
+      printf("Failed to create thread\n");
+      ret = -1;
+      break;
+    }
+  }
+
+  uint64_t start = now_nsec();
+  if (!ret)
+    ret = measure_lldma_latency("contended", latency);
+  uint64_t elapsed = now_nsec() - start;
+
+  m_stop = 1;
+  unsigned long total = 0;
+  for (unsigned int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+    total += counts[i];
+  }
+  if (!ret && elapsed)
+    printf("stat reads  : %.0f calls/s\n", (double)total * 1000000000.0 / elapsed);
+
+  free(latency);
+  fpga_finish();
+
+  return ret;
+}
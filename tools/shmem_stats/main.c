@@ -0,0 +1,173 @@
+/*************************************************
+* Copyright 2024 NTT Corporation, FUJITSU LIMITED
+* Licensed under the 3-Clause BSD License, see LICENSE for details.
+* SPDX-License-Identifier: BSD-3-Clause
+*************************************************/
+#include <libshmem.h>
+#include <liblogging.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <getopt.h>
+
+#ifndef APP_VERSION
+#define APP_VERSION "x.x.x"
+#endif
+
+#define MIB(x) ((double)(x) / (1024 * 1024))
+
+
+static char *m_file_prefix = NULL;
+static unsigned int m_interval = 0;
+static unsigned int m_count = 1;
+
+
+static void print_usage(void) {
+  printf("shmem_stats: version %s\n", APP_VERSION);
+  printf("usage: ./shmem_stats -p <file_prefix> [-i <interval>] [-c <count>]\n");
+  printf("interval:default=0(print once)[ms]\n");
+  printf("count   :default=1(0:infinite)\n");
+  printf("\n");
+}
+
+static const struct option long_options[] = {
+    { "file-prefix", required_argument, NULL, 'p' },
+    { "interval", required_argument, NULL, 'i' },
+    { "count", required_argument, NULL, 'c' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, 0, 0 },
+};
+
+static const char short_options[] = {
+    "p:i:c:h"
+};
+
+
+static int parse_args(
+  int argc,
+  char **argv
+) {
+  int opt;
+  int option_index;
+
+  while ((opt = getopt_long(argc, argv, short_options,
+                long_options, &option_index)) != EOF
+  ) {
+    switch (opt) {
+    case 'h':
+      print_usage();
+      exit(0);
+    case 'p':
+      m_file_prefix = optarg;
+      break;
+    case 'i':
+      m_interval = atoi(optarg);
+      if (m_count == 1)
+        m_count = 0;
+      break;
+    case 'c':
+      m_count = atoi(optarg);
+      break;
+    default:
+      printf("Cannot parse option : %s\n", argv[optind - 1]);
+      return -1;
+    }
+  }
+
+  if (!m_file_prefix) {
+    printf("file_prefix is required.\n");
+    return -1;
+  }
+
+  return 0;
+}
+
+
+static void print_stats(
+  const fpga_shmem_stats_t *stats
+) {
+  printf("file_prefix: %s\n", stats->file_prefix);
+
+  // Heap statistics shared by the shmem manager and secondary processes
+  printf("  socket, total[MiB], alloc[MiB], free[MiB], greatest_free[MiB], alloc_count, free_count\n");
+  for (int i = 0; i < stats->socket_num; i++) {
+    const fpga_shmem_socket_stats_t *sock = &stats->socket[i];
+    if (!sock->heap_total_bytes)
+      continue;
+    printf("  %6d, %11.3f, %11.3f, %9.3f, %18.3f, %11u, %10u\n",
+      i,
+      MIB(sock->heap_total_bytes),
+      MIB(sock->heap_alloc_bytes),
+      MIB(sock->heap_free_bytes),
+      MIB(sock->greatest_free_bytes),
+      sock->alloc_count,
+      sock->free_count);
+  }
+
+  // Allocation statistics shared by the shmem manager and secondary processes
+  printf("  alloc[MiB]: %.3f, peak[MiB]: %.3f, not counted: %llu\n",
+    MIB(stats->alloc_bytes),
+    MIB(stats->peak_alloc_bytes),
+    (unsigned long long)stats->alloc_dropped);
+  printf("  alloc count by size:");
+  for (int i = 0; i < SHMEM_STATS_SIZE_CLASS_NUM; i++) {
+    if (!stats->alloc_count[i])
+      continue;
+    if (i == SHMEM_STATS_SIZE_CLASS_NUM - 1)
+      printf(" >%luKiB:%llu",
+        ((unsigned long)SHMEM_STATS_SIZE_CLASS_MIN << (i - 1)) / 1024,
+        (unsigned long long)stats->alloc_count[i]);
+    else
+      printf(" <=%luKiB:%llu",
+        ((unsigned long)SHMEM_STATS_SIZE_CLASS_MIN << i) / 1024,
+        (unsigned long long)stats->alloc_count[i]);
+  }
+  printf("\n");
+
+  // Statistics of this process
+  printf("  v2p regions(this process): %llu\n",
+    (unsigned long long)stats->region_num);
+}
+
+
+/* ******** *
+ * * main * *
+ * ******** */
+int main(int argc, char **argv)
+{
+  // set log
+  libfpga_log_set_output_stdout();
+  libfpga_log_quit_timestamp();
+  libfpga_log_set_level(LIBFPGA_LOG_NOTHING);
+
+  // parse options
+  if (parse_args(argc, argv)) {
+    print_usage();
+    return -1;
+  }
+
+  // attach to the shmem manager as secondary process
+  int ret = fpga_shmem_init(m_file_prefix, NULL, 0);
+  if (ret) {
+    printf("Error happened at fpga_shmem_init(%s): ret=%d\n", m_file_prefix, ret);
+    return -1;
+  }
+
+  fpga_shmem_stats_t stats;
+  for (unsigned int cnt = 0; m_count == 0 || cnt < m_count; cnt++) {
+    if (cnt)
+      usleep(m_interval * 1000);
+    if ((ret = fpga_shmem_get_stats(&stats))) {
+      printf("Error happened at fpga_shmem_get_stats(): ret=%d\n", ret);
+      fpga_shmem_finish();
+      return -1;
+    }
+    print_stats(&stats);
+  }
+
+  fpga_shmem_finish();
+
+  return 0;
+}